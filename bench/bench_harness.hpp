@@ -0,0 +1,217 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "bloch/support/json.hpp"
+
+// Shared driver for the microbenchmarks in bench/. Each benchmark is a
+// function that performs a given number of operations and returns the
+// seconds they took, so it can leave its own setup out of the timing.
+
+namespace bloch::bench {
+
+    struct BenchOptions {
+        int warmup = 3;
+        int repetitions = 15;
+        // Each sample runs enough operations to take at least this long, so
+        // clock resolution and call overhead stay well under 1%.
+        double minSampleSeconds = 0.02;
+        std::string filter;
+        std::string jsonPath;
+    };
+
+    // A figure derived from a benchmark's median, such as amplitudes/s.
+    struct Metric {
+        std::string name;
+        double value = 0.0;
+    };
+
+    struct Measurement {
+        std::string name;
+        std::size_t opsPerSample = 0;
+        double medianSeconds = 0.0;  // per operation, or per item
+        double minSeconds = 0.0;
+        // Interquartile range over the median; compare runs only on
+        // benchmarks whose spread is well below the change you look for.
+        double spread = 0.0;
+        std::vector<Metric> metrics;
+    };
+
+    // Seconds since `start`, for benchmarks that time their operations.
+    inline double secondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Times `run`, which performs the requested number of operations and
+    // returns the seconds they took. The operation count is first doubled
+    // (or scaled up from the last sample) until a sample reaches the
+    // minimum time; then `warmup` samples are discarded and `repetitions`
+    // are kept. Figures are per item when one operation covers several
+    // (a loop iteration of a program run, say).
+    inline Measurement measure(std::string name, const std::function<double(std::size_t)>& run,
+                               const BenchOptions& options, double itemsPerOp = 1.0) {
+        std::size_t ops = 1;
+        for (;;) {
+            double seconds = run(ops);
+            if (seconds >= options.minSampleSeconds)
+                break;
+            double scale = seconds > 0 ? 1.2 * options.minSampleSeconds / seconds : 2.0;
+            ops = static_cast<std::size_t>(
+                std::ceil(static_cast<double>(ops) * std::clamp(scale, 2.0, 100.0)));
+        }
+        for (int i = 0; i < options.warmup; ++i) run(ops);
+        std::vector<double> samples;
+        samples.reserve(options.repetitions);
+        for (int i = 0; i < options.repetitions; ++i)
+            samples.push_back(run(ops) / (static_cast<double>(ops) * itemsPerOp));
+        std::sort(samples.begin(), samples.end());
+        auto quantile = [&](double q) {
+            double pos = q * static_cast<double>(samples.size() - 1);
+            std::size_t lo = static_cast<std::size_t>(pos);
+            std::size_t hi = std::min(lo + 1, samples.size() - 1);
+            return samples[lo] + (samples[hi] - samples[lo]) * (pos - static_cast<double>(lo));
+        };
+        Measurement m;
+        m.name = std::move(name);
+        m.opsPerSample = ops;
+        m.medianSeconds = quantile(0.5);
+        m.minSeconds = samples.front();
+        m.spread = m.medianSeconds > 0 ? (quantile(0.75) - quantile(0.25)) / m.medianSeconds : 0;
+        return m;
+    }
+
+    // Parses the options every benchmark accepts; `extra` handles the rest
+    // and returns false for an unknown argument. Exits on bad usage.
+    inline BenchOptions parseOptions(int argc, char** argv, std::string_view usage,
+                                     const std::function<bool(std::string_view)>& extra) {
+        BenchOptions options;
+        auto fail = [&](std::string_view message) {
+            std::cerr << argv[0] << ": " << message << "\n" << usage;
+            std::exit(2);
+        };
+        auto positive = [&](std::string_view arg, std::string_view value) {
+            char* end = nullptr;
+            std::string text(value);
+            long parsed = std::strtol(text.c_str(), &end, 10);
+            if (text.empty() || *end != '\0' || parsed <= 0 || parsed > 1'000'000)
+                fail("invalid value in '" + std::string(arg) + "'");
+            return static_cast<int>(parsed);
+        };
+        for (int i = 1; i < argc; ++i) {
+            std::string_view arg = argv[i];
+            auto value = [&](std::string_view flag) -> std::optional<std::string_view> {
+                if (arg.size() > flag.size() && arg.substr(0, flag.size()) == flag &&
+                    arg[flag.size()] == '=')
+                    return arg.substr(flag.size() + 1);
+                return std::nullopt;
+            };
+            if (arg == "--help" || arg == "-h") {
+                std::cout << usage;
+                std::exit(0);
+            } else if (auto v = value("--warmup")) {
+                options.warmup = positive(arg, *v);
+            } else if (auto v = value("--repetitions")) {
+                options.repetitions = positive(arg, *v);
+            } else if (auto v = value("--min-time")) {
+                options.minSampleSeconds = positive(arg, *v) / 1000.0;
+            } else if (auto v = value("--filter")) {
+                options.filter = *v;
+            } else if (auto v = value("--json")) {
+                options.jsonPath = *v;
+            } else if (!extra(arg)) {
+                fail("unknown argument '" + std::string(arg) + "'");
+            }
+        }
+        return options;
+    }
+
+    // Prints each result as it is added and writes the JSON report at the
+    // end when --json is given.
+    class Report {
+       public:
+        Report(std::string suite, const BenchOptions& options)
+            : m_suite(std::move(suite)), m_options(options) {
+            std::cout << std::left << std::setw(kNameWidth) << "benchmark" << std::right
+                      << std::setw(14) << "ns/op" << std::setw(9) << "spread" << "\n";
+        }
+
+        // Whether the name passes --filter (a substring match).
+        bool selected(std::string_view name) const {
+            return m_options.filter.empty() || name.find(m_options.filter) != name.npos;
+        }
+
+        void add(Measurement m) {
+            std::ostringstream row;
+            row << std::left << std::setw(kNameWidth) << m.name << std::right << std::fixed
+                << std::setprecision(1) << std::setw(14) << m.medianSeconds * 1e9 << std::setw(8)
+                << m.spread * 100 << "%";
+            for (const auto& metric : m.metrics)
+                row << "  " << metric.name << "=" << std::defaultfloat << std::setprecision(4)
+                    << metric.value;
+            std::cout << row.str() << std::endl;
+            m_results.push_back(std::move(m));
+        }
+
+        // Returns the process exit code.
+        int finish() const {
+            if (m_options.jsonPath.empty())
+                return 0;
+            std::ofstream out(m_options.jsonPath);
+            if (!out) {
+                std::cerr << "cannot write '" << m_options.jsonPath << "'\n";
+                return 1;
+            }
+            out << std::setprecision(6) << "{\"suite\":" << support::jsonString(m_suite)
+                << ",\"version\":" << support::jsonString(BLOCH_VERSION)
+                << ",\"commit\":" << support::jsonString(BLOCH_COMMIT_HASH)
+                << ",\"warmup\":" << m_options.warmup
+                << ",\"repetitions\":" << m_options.repetitions << ",\"results\":[";
+            for (std::size_t i = 0; i < m_results.size(); ++i) {
+                const auto& m = m_results[i];
+                out << (i ? "," : "") << "\n{\"name\":" << support::jsonString(m.name)
+                    << ",\"opsPerSample\":" << m.opsPerSample
+                    << ",\"medianNs\":" << m.medianSeconds * 1e9
+                    << ",\"minNs\":" << m.minSeconds * 1e9 << ",\"spread\":" << m.spread;
+                for (const auto& metric : m.metrics)
+                    out << "," << support::jsonString(metric.name) << ":" << metric.value;
+                out << "}";
+            }
+            out << "\n]}\n";
+            return out ? 0 : 1;
+        }
+
+       private:
+        static constexpr int kNameWidth = 36;
+        std::string m_suite;
+        BenchOptions m_options;
+        std::vector<Measurement> m_results;
+    };
+
+}  // namespace bloch::bench
@@ -0,0 +1,319 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Microbenchmarks for the classical paths: lexing and parsing generated
+// sources, semantic analysis of class- and generics-heavy programs, and the
+// evaluator on loops that each exercise one construct. Figures are per
+// token for the lexer, per AST node for the parser and analyser, and per
+// loop iteration for the evaluator, whose programs run unoptimised so each
+// case measures the construct it names.
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bench_harness.hpp"
+#include "bloch/compiler/lexer/lexer.hpp"
+#include "bloch/compiler/optimiser/rewrite_utils.hpp"
+#include "bloch/compiler/parser/parser.hpp"
+#include "bloch/compiler/semantics/semantic_analyser.hpp"
+#include "bloch/runtime/runtime_evaluator.hpp"
+#include "bloch/support/error/bloch_error.hpp"
+
+using bloch::compiler::Lexer;
+using bloch::compiler::Parser;
+using bloch::compiler::Program;
+using bloch::compiler::SemanticAnalyser;
+using bloch::compiler::Token;
+using bloch::runtime::RuntimeEvaluator;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+    constexpr std::string_view kUsage =
+        "Usage: bloch_bench_interp [options]\n"
+        "  --warmup=N          untimed samples per benchmark (default 3)\n"
+        "  --repetitions=N     timed samples; the median is reported (default 15)\n"
+        "  --min-time=MS       minimum length of one sample (default 20)\n"
+        "  --filter=TEXT       only benchmarks whose name contains TEXT\n"
+        "  --json=FILE         also write the results as JSON\n";
+
+    // Free functions mixing the statements and expressions of typical code.
+    std::string frontEndSource(int functions) {
+        std::string src = "// Generated by bloch_bench_interp.\n";
+        for (int i = 0; i < functions; ++i) {
+            std::string n = std::to_string(i);
+            src += "function f" + n + "(int a, float b) -> int {\n";
+            src += "    int total = a * " + n + " + 3;\n";
+            src += "    float scaled = b * 2.5f + " + n + ".0f;\n";
+            src += "    int[4] values = {a, a + 1, a + 2, " + n + "};\n";
+            src += "    for (int k = 0; k < 4; k++) {\n";
+            src += "        if (values[k] % 2 == 0 && total > -1) {\n";
+            src += "            total = total + values[k];  // even\n";
+            src += "        } else {\n";
+            src += "            total = total - 1;\n";
+            src += "        }\n";
+            src += "    }\n";
+            src += "    string label = \"function " + n + "\";\n";
+            src += "    while (total > 100) { total = total % 7; }\n";
+            if (i > 0)
+                src += "    total = total + f" + std::to_string(i - 1) + "(a - 1, scaled);\n";
+            src += "    return total;\n";
+            src += "}\n\n";
+        }
+        src += "function main() -> void { echo(f" + std::to_string(functions - 1) +
+               "(3, 1.5f)); }\n";
+        return src;
+    }
+
+    // A class hierarchy per group, generic containers instantiated with
+    // each, and code in main that resolves fields, overloads and overrides.
+    std::string classSource(int groups) {
+        std::string src = R"(class Box<T> {
+    public T value;
+    public constructor(T v) -> Box<T> { this.value = v; return this; }
+    public function get() -> T { return this.value; }
+}
+class Pair<K, V> {
+    public K first;
+    public V second;
+    public constructor(K k, V v) -> Pair<K, V> { this.first = k; this.second = v; return this; }
+}
+)";
+        std::string main = "function main() -> void {\n    int sum = 0;\n";
+        for (int i = 0; i < groups; ++i) {
+            std::string n = std::to_string(i);
+            std::string base = "Base" + n;
+            std::string derived = "Derived" + n;
+            src += "class " + base + " {\n";
+            src += "    public int value;\n";
+            src += "    public constructor(int v) -> " + base +
+                   " { this.value = v; return this; }\n";
+            src += "    public virtual function get() -> int { return this.value; }\n";
+            src += "    public function scale(int k) -> int { return this.value * k; }\n";
+            src += "    public function scale(float k) -> float { return this.value * k; }\n";
+            src += "}\n";
+            src += "class " + derived + " extends " + base + " {\n";
+            src += "    private Box<" + base + "> peer;\n";
+            src += "    public constructor(int v) -> " + derived + " {\n";
+            src += "        super(v);\n";
+            src += "        this.peer = new Box<" + base + ">(new " + base + "(v + 1));\n";
+            src += "        return this;\n";
+            src += "    }\n";
+            src += "    public override function get() -> int {\n";
+            src += "        return this.value + this.peer.get().get() + " + n + ";\n";
+            src += "    }\n";
+            src += "    public function pair() -> Pair<" + base + ", Box<int>> {\n";
+            src += "        return new Pair<" + base + ", Box<int>>(this, new Box<int>(" + n +
+                   "));\n";
+            src += "    }\n";
+            src += "}\n";
+            main += "    " + derived + " d" + n + " = new " + derived + "(" + n + ");\n";
+            main += "    " + base + " b" + n + " = d" + n + ";\n";
+            main += "    Pair<" + base + ", Box<int>> p" + n + " = d" + n + ".pair();\n";
+            main += "    sum = sum + b" + n + ".get() + p" + n + ".second.get() + b" + n +
+                    ".scale(2);\n";
+        }
+        return src + main + "    echo(sum);\n}\n";
+    }
+
+    // Programs whose loop body is the construct under test; each runs
+    // kIterations times.
+    constexpr int kIterations = 20000;
+
+    struct EvalCase {
+        const char* name;
+        const char* source;
+    };
+
+    const EvalCase kEvalCases[] = {
+        {"eval/arithmetic", R"(
+function run(int n) -> int {
+    int acc = 0;
+    for (int i = 0; i < n; i++) { acc = (acc * 31 + i * 7 - 3) % 1000003; }
+    return acc;
+}
+function main() -> void { echo(run(ITERATIONS)); })"},
+        {"eval/array-index", R"(
+function run(int n) -> int {
+    int[64] data;
+    for (int i = 0; i < n; i++) { data[i % 64] = data[(i + 1) % 64] + i; }
+    return data[0];
+}
+function main() -> void { echo(run(ITERATIONS)); })"},
+        {"eval/method-dispatch", R"(
+class Step {
+    public constructor() -> Step = default;
+    public virtual function apply(int x) -> int { return x + 1; }
+}
+class DoubleStep extends Step {
+    public constructor() -> DoubleStep { super(); return this; }
+    public override function apply(int x) -> int { return (x * 2) % 1000003; }
+}
+function run(int n) -> int {
+    Step step = new DoubleStep();
+    int acc = 1;
+    for (int i = 0; i < n; i++) { acc = step.apply(acc); }
+    return acc;
+}
+function main() -> void { echo(run(ITERATIONS)); })"},
+        {"eval/allocation", R"(
+class Point {
+    public int x;
+    public int y;
+    public constructor(int x, int y) -> Point { this.x = x; this.y = y; return this; }
+}
+function run(int n) -> int {
+    int acc = 0;
+    for (int i = 0; i < n; i++) {
+        Point p = new Point(i, i + 1);
+        acc = (acc + p.x + p.y) % 1000003;
+    }
+    return acc;
+}
+function main() -> void { echo(run(ITERATIONS)); })"},
+        {"eval/gc-churn", R"(
+class Node {
+    public Node next;
+    public constructor() -> Node = default;
+}
+function run(int n) -> int {
+    for (int i = 0; i < n; i++) {
+        Node a = new Node();
+        Node b = new Node();
+        a.next = b;
+        b.next = a;
+    }
+    return n;
+}
+function main() -> void { echo(run(ITERATIONS)); })"},
+    };
+
+    std::unique_ptr<Program> parse(const std::string& src) {
+        Lexer lexer(src);
+        Parser parser(lexer.tokenize());
+        return parser.parse();
+    }
+
+    std::unique_ptr<Program> analysed(const std::string& src) {
+        auto program = parse(src);
+        SemanticAnalyser().analyse(*program);
+        return program;
+    }
+
+    void benchFrontEnd(bloch::bench::Report& report, const bloch::bench::BenchOptions& options) {
+        for (int functions : {100, 2000}) {
+            std::string size = "/functions=" + std::to_string(functions);
+            std::string src = frontEndSource(functions);
+            std::vector<Token> tokens = Lexer(src).tokenize();
+            double tokenCount = static_cast<double>(tokens.size());
+
+            if (report.selected("lex" + size)) {
+                report.add(bloch::bench::measure(
+                    "lex" + size,
+                    [&](std::size_t ops) {
+                        auto start = Clock::now();
+                        for (std::size_t i = 0; i < ops; ++i) auto t = Lexer(src).tokenize();
+                        return bloch::bench::secondsSince(start);
+                    },
+                    options, tokenCount));
+            }
+
+            double nodes = bloch::compiler::countNodes(parse(src).get());
+            if (report.selected("parse" + size)) {
+                report.add(bloch::bench::measure(
+                    "parse" + size,
+                    [&](std::size_t ops) {
+                        double seconds = 0;
+                        for (std::size_t i = 0; i < ops; ++i) {
+                            Parser parser(tokens);
+                            auto start = Clock::now();
+                            auto program = parser.parse();
+                            seconds += bloch::bench::secondsSince(start);
+                        }
+                        return seconds;
+                    },
+                    options, nodes));
+            }
+        }
+    }
+
+    void benchSemantics(bloch::bench::Report& report, const bloch::bench::BenchOptions& options) {
+        for (int groups : {20, 200}) {
+            std::string name = "analyse/classes=" + std::to_string(groups * 2);
+            if (!report.selected(name))
+                continue;
+            std::string src = classSource(groups);
+            analysed(src);  // fail before timing if the program is rejected
+            double nodes = bloch::compiler::countNodes(parse(src).get());
+            report.add(bloch::bench::measure(
+                name,
+                [&](std::size_t ops) {
+                    double seconds = 0;
+                    for (std::size_t i = 0; i < ops; ++i) {
+                        auto program = parse(src);
+                        auto start = Clock::now();
+                        SemanticAnalyser().analyse(*program);
+                        seconds += bloch::bench::secondsSince(start);
+                    }
+                    return seconds;
+                },
+                options, nodes));
+        }
+    }
+
+    void benchEvaluator(bloch::bench::Report& report, const bloch::bench::BenchOptions& options) {
+        for (const auto& c : kEvalCases) {
+            if (!report.selected(c.name))
+                continue;
+            std::string src = c.source;
+            src.replace(src.find("ITERATIONS"), 10, std::to_string(kIterations));
+            auto program = analysed(src);
+            report.add(bloch::bench::measure(
+                c.name,
+                [&](std::size_t ops) {
+                    double seconds = 0;
+                    for (std::size_t i = 0; i < ops; ++i) {
+                        RuntimeEvaluator eval(false);
+                        eval.setEcho(false);
+                        eval.setWarnOnExit(false);
+                        auto start = Clock::now();
+                        eval.execute(*program);
+                        seconds += bloch::bench::secondsSince(start);
+                    }
+                    return seconds;
+                },
+                options, kIterations));
+        }
+    }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    auto options =
+        bloch::bench::parseOptions(argc, argv, kUsage, [](std::string_view) { return false; });
+    bloch::bench::Report report("interp", options);
+    try {
+        benchFrontEnd(report, options);
+        benchSemantics(report, options);
+        benchEvaluator(report, options);
+    } catch (const bloch::support::BlochError& e) {
+        std::cerr << argv[0] << ": benchmark program rejected: " << e.what() << "\n";
+        return 1;
+    }
+    return report.finish();
+}
@@ -0,0 +1,225 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Microbenchmarks for the QasmSimulator kernels. Every gate kernel runs on
+// a statevector of each requested size with the target at the lowest,
+// middle and highest qubit, since the stride changes how the loops use the
+// cache. Figures are per operation; amplitudes/s counts the whole
+// statevector once per operation and GB/s is the traffic the kernel must
+// make to its amplitudes, so both stay comparable across sizes.
+
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bench_harness.hpp"
+#include "bloch/runtime/qasm_simulator.hpp"
+
+using bloch::bench::Measurement;
+using bloch::runtime::QasmSimulator;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+    constexpr std::string_view kUsage =
+        "Usage: bloch_bench_sim [options]\n"
+        "  --qubits=N,N,...    statevector sizes (default 10,14,18,22)\n"
+        "  --warmup=N          untimed samples per benchmark (default 3)\n"
+        "  --repetitions=N     timed samples; the median is reported (default 15)\n"
+        "  --min-time=MS       minimum length of one sample (default 20)\n"
+        "  --filter=TEXT       only benchmarks whose name contains TEXT\n"
+        "  --json=FILE         also write the results as JSON\n";
+
+    constexpr double kAmplitudeBytes = QasmSimulator::kBytesPerAmplitude;
+
+    // A simulator without a QASM log holding n qubits in uniform superposition.
+    QasmSimulator prepared(int n) {
+        QasmSimulator sim(false);
+        sim.seed(1);
+        sim.allocateQubits(n);
+        for (int q = 0; q < n; ++q) sim.h(q);
+        return sim;
+    }
+
+    std::vector<int> targetsFor(int n) {
+        std::vector<int> targets{0};
+        if (n / 2 != 0 && n / 2 != n - 1)
+            targets.push_back(n / 2);
+        if (n > 1)
+            targets.push_back(n - 1);
+        return targets;
+    }
+
+    // `bytesPerAmplitude` is the traffic per amplitude of the statevector
+    // (for example 2 * 16 when every amplitude is read and written once).
+    void record(bloch::bench::Report& report, Measurement m, int n, double bytesPerAmplitude) {
+        double amplitudes = static_cast<double>(std::size_t{1} << n);
+        m.metrics.push_back({"ampsPerSecond", amplitudes / m.medianSeconds});
+        m.metrics.push_back(
+            {"gbPerSecond", amplitudes * bytesPerAmplitude / m.medianSeconds / 1e9});
+        report.add(std::move(m));
+    }
+
+    void benchSize(bloch::bench::Report& report, const bloch::bench::BenchOptions& options,
+                   int n) {
+        std::string size = "/n=" + std::to_string(n);
+        struct SingleQubitKernel {
+            const char* name;
+            void (*apply)(QasmSimulator&, int);
+        };
+        const SingleQubitKernel kernels[] = {
+            {"h", [](QasmSimulator& sim, int q) { sim.h(q); }},
+            {"x", [](QasmSimulator& sim, int q) { sim.x(q); }},
+            {"rz", [](QasmSimulator& sim, int q) { sim.rz(q, 0.125); }},
+        };
+        for (const auto& kernel : kernels) {
+            for (int q : targetsFor(n)) {
+                std::string name = kernel.name + size + "/q=" + std::to_string(q);
+                if (!report.selected(name))
+                    continue;
+                QasmSimulator sim = prepared(n);
+                auto m = bloch::bench::measure(
+                    name,
+                    [&](std::size_t ops) {
+                        auto start = Clock::now();
+                        for (std::size_t i = 0; i < ops; ++i) kernel.apply(sim, q);
+                        return bloch::bench::secondsSince(start);
+                    },
+                    options);
+                record(report, std::move(m), n, 2 * kAmplitudeBytes);
+            }
+        }
+
+        for (int t : targetsFor(n)) {
+            if (n < 2)
+                break;
+            int c = t == 0 ? n - 1 : 0;
+            std::string name = "cx" + size + "/c=" + std::to_string(c) + ",t=" + std::to_string(t);
+            if (!report.selected(name))
+                continue;
+            QasmSimulator sim = prepared(n);
+            auto m = bloch::bench::measure(
+                name,
+                [&](std::size_t ops) {
+                    auto start = Clock::now();
+                    for (std::size_t i = 0; i < ops; ++i) sim.cx(c, t);
+                    return bloch::bench::secondsSince(start);
+                },
+                options);
+            // Only the half of the statevector with the control set moves.
+            record(report, std::move(m), n, kAmplitudeBytes);
+        }
+
+        // A measured qubit cannot be measured again until it is reset, so
+        // measure and reset are timed one operation at a time and the qubit
+        // is put back into superposition, untimed, between them.
+        for (int q : targetsFor(n)) {
+            std::string name = "measure" + size + "/q=" + std::to_string(q);
+            if (!report.selected(name))
+                continue;
+            QasmSimulator sim = prepared(n);
+            auto m = bloch::bench::measure(
+                name,
+                [&](std::size_t ops) {
+                    double seconds = 0;
+                    for (std::size_t i = 0; i < ops; ++i) {
+                        auto start = Clock::now();
+                        sim.measure(q);
+                        seconds += bloch::bench::secondsSince(start);
+                        sim.reset(q);
+                        sim.h(q);
+                    }
+                    return seconds;
+                },
+                options);
+            // One pass for the probability, then a read and write to collapse.
+            record(report, std::move(m), n, 3 * kAmplitudeBytes);
+        }
+        for (int q : targetsFor(n)) {
+            std::string name = "reset" + size + "/q=" + std::to_string(q);
+            if (!report.selected(name))
+                continue;
+            QasmSimulator sim = prepared(n);
+            auto m = bloch::bench::measure(
+                name,
+                [&](std::size_t ops) {
+                    double seconds = 0;
+                    for (std::size_t i = 0; i < ops; ++i) {
+                        auto start = Clock::now();
+                        sim.reset(q);
+                        seconds += bloch::bench::secondsSince(start);
+                        sim.h(q);
+                    }
+                    return seconds;
+                },
+                options);
+            record(report, std::move(m), n, 3 * kAmplitudeBytes);
+        }
+
+        // Growing from n - 1 to n qubits: the old half is copied and the new
+        // half zeroed, including the page faults of fresh memory.
+        std::string name = "allocate" + size;
+        if (n >= 1 && report.selected(name)) {
+            auto m = bloch::bench::measure(
+                name,
+                [&](std::size_t ops) {
+                    double seconds = 0;
+                    for (std::size_t i = 0; i < ops; ++i) {
+                        QasmSimulator sim(false);
+                        sim.allocateQubits(n - 1);
+                        auto start = Clock::now();
+                        sim.allocateQubit();
+                        seconds += bloch::bench::secondsSince(start);
+                    }
+                    return seconds;
+                },
+                options);
+            record(report, std::move(m), n, 1.5 * kAmplitudeBytes);
+        }
+    }
+
+    std::vector<int> parseQubits(std::string_view list) {
+        std::vector<int> sizes;
+        while (!list.empty()) {
+            auto comma = list.find(',');
+            std::string item(list.substr(0, comma));
+            char* end = nullptr;
+            long n = std::strtol(item.c_str(), &end, 10);
+            if (item.empty() || *end != '\0' || n < 1 || n > 30)
+                return {};
+            sizes.push_back(static_cast<int>(n));
+            list = comma == list.npos ? std::string_view{} : list.substr(comma + 1);
+        }
+        return sizes;
+    }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::vector<int> sizes{10, 14, 18, 22};
+    auto options = bloch::bench::parseOptions(argc, argv, kUsage, [&](std::string_view arg) {
+        if (arg.substr(0, 9) != "--qubits=")
+            return false;
+        sizes = parseQubits(arg.substr(9));
+        if (sizes.empty()) {
+            std::cerr << argv[0] << ": --qubits takes sizes from 1 to 30\n";
+            std::exit(2);
+        }
+        return true;
+    });
+    bloch::bench::Report report("sim", options);
+    for (int n : sizes) benchSize(report, options, n);
+    return report.finish();
+}
@@ -0,0 +1,252 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bloch/capi/bloch.h"
+
+#include <algorithm>
+#include <complex>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "bloch/compiler/import/module_loader.hpp"
+#include "bloch/compiler/optimiser/optimiser.hpp"
+#include "bloch/compiler/semantics/semantic_analyser.hpp"
+#include "bloch/runtime/shot_runner.hpp"
+#include "bloch/support/error/bloch_error.hpp"
+
+struct bloch_program {
+    std::unique_ptr<bloch::compiler::Program> program;
+    int optLevel = 1;
+    // Strategy and reservation chosen once by planShots.
+    bloch::runtime::ShotOptions plan;
+};
+
+struct bloch_result {
+    int shots = 0;
+    // Sorted so indices are stable.
+    std::vector<std::pair<std::string, std::vector<std::pair<std::string, uint64_t>>>> tracked;
+    std::string qasm;
+    std::vector<std::complex<double>> state;
+    bool hasState = false;
+};
+
+namespace {
+    using bloch::support::BlochError;
+    using bloch::support::ErrorCategory;
+
+    thread_local std::string lastError;
+
+    bloch_status fail(bloch_status status, std::string message) {
+        lastError = std::move(message);
+        return status;
+    }
+
+    // Maps the exception in flight to a status and lastError.
+    bloch_status failFromException() {
+        try {
+            throw;
+        } catch (const BlochError& error) {
+            std::string where;
+            if (error.line > 0)
+                where = std::to_string(error.line) + ":" + std::to_string(error.column) + ": ";
+            bloch_status status = BLOCH_ERROR_OTHER;
+            switch (error.category) {
+                case ErrorCategory::Lexical:
+                    status = BLOCH_ERROR_LEXICAL;
+                    break;
+                case ErrorCategory::Parse:
+                    status = BLOCH_ERROR_PARSE;
+                    break;
+                case ErrorCategory::Semantic:
+                    status = BLOCH_ERROR_SEMANTIC;
+                    break;
+                case ErrorCategory::Runtime:
+                    status = BLOCH_ERROR_RUNTIME;
+                    break;
+                case ErrorCategory::Generic:
+                    break;
+            }
+            return fail(status, where + error.message);
+        } catch (const std::bad_alloc&) {
+            return fail(BLOCH_ERROR_OTHER, "out of memory");
+        } catch (const std::exception& error) {
+            return fail(BLOCH_ERROR_OTHER, error.what());
+        } catch (...) {
+            return fail(BLOCH_ERROR_OTHER, "unknown error");
+        }
+    }
+
+    bloch_status copyOut(const std::string& text, char* buffer, size_t capacity, size_t* needed) {
+        if (needed)
+            *needed = text.size();
+        if (capacity < text.size() + 1 || !buffer)
+            return fail(BLOCH_ERROR_BUFFER_TOO_SMALL, "buffer too small");
+        std::memcpy(buffer, text.c_str(), text.size() + 1);
+        lastError.clear();
+        return BLOCH_OK;
+    }
+
+    bloch_status prepare(const char* path, const char* source, const char* const* searchPaths,
+                         size_t searchPathCount, int optLevel, bloch_program** out) {
+        if (!out || !path || optLevel < 0 || optLevel > 2 || (searchPathCount && !searchPaths))
+            return fail(BLOCH_ERROR_ARGUMENT, "invalid argument");
+        *out = nullptr;
+        try {
+            std::vector<std::string> paths(searchPaths, searchPaths + searchPathCount);
+            bloch::compiler::ModuleLoader loader(std::move(paths));
+            auto handle = std::make_unique<bloch_program>();
+            handle->program = source ? loader.loadSource(path, source) : loader.load(path);
+            bloch::compiler::SemanticAnalyser analyser;
+            analyser.analyse(*handle->program);
+            if (optLevel >= 1) {
+                bloch::compiler::Optimiser optimiser;
+                optimiser.optimise(*handle->program);
+            }
+            handle->optLevel = optLevel;
+            handle->plan.echo = false;
+            handle->plan.warnings = false;
+            handle->plan.circuitOptimisation = optLevel >= 2;
+            bloch::runtime::planShots(*handle->program, optLevel, handle->plan);
+            *out = handle.release();
+            lastError.clear();
+            return BLOCH_OK;
+        } catch (...) {
+            return failFromException();
+        }
+    }
+}  // namespace
+
+extern "C" {
+
+int bloch_api_version(void) { return BLOCH_C_API_VERSION; }
+
+const char* bloch_last_error(void) { return lastError.c_str(); }
+
+bloch_status bloch_program_load(const char* path, const char* const* search_paths,
+                                size_t search_path_count, int opt_level, bloch_program** out) {
+    return prepare(path, nullptr, search_paths, search_path_count, opt_level, out);
+}
+
+bloch_status bloch_program_compile(const char* source, const char* name,
+                                   const char* const* search_paths, size_t search_path_count,
+                                   int opt_level, bloch_program** out) {
+    if (!source)
+        return fail(BLOCH_ERROR_ARGUMENT, "invalid argument");
+    return prepare(name, source, search_paths, search_path_count, opt_level, out);
+}
+
+void bloch_program_free(bloch_program* program) { delete program; }
+
+int bloch_program_shots(const bloch_program* program) {
+    if (!program || !program->program->shots.first)
+        return 0;
+    return program->program->shots.second;
+}
+
+bloch_status bloch_run(bloch_program* program, int shots, uint64_t seed, unsigned flags,
+                       bloch_result** out) {
+    if (!program || !out || shots < 0 || (flags & ~BLOCH_RUN_KEEP_STATEVECTOR))
+        return fail(BLOCH_ERROR_ARGUMENT, "invalid argument");
+    *out = nullptr;
+    try {
+        bloch::runtime::ShotOptions options = program->plan;
+        options.shots = shots > 0 ? shots : std::max(1, bloch_program_shots(program));
+        options.seed = seed;
+        options.keepState = (flags & BLOCH_RUN_KEEP_STATEVECTOR) != 0;
+        bloch::runtime::ShotResult run = bloch::runtime::runShots(*program->program, options);
+
+        auto result = std::make_unique<bloch_result>();
+        result->shots = run.shotsRun;
+        std::map<std::string, std::map<std::string, uint64_t>> sorted;
+        for (const auto& var : run.trackedCounts)
+            for (const auto& outcome : var.second)
+                sorted[var.first][outcome.first] += static_cast<uint64_t>(outcome.second);
+        for (auto& var : sorted)
+            result->tracked.emplace_back(var.first,
+                                         std::vector<std::pair<std::string, uint64_t>>(
+                                             var.second.begin(), var.second.end()));
+        result->qasm = std::move(run.qasm);
+        result->state = std::move(run.state);
+        result->hasState = options.keepState;
+        *out = result.release();
+        lastError.clear();
+        return BLOCH_OK;
+    } catch (...) {
+        return failFromException();
+    }
+}
+
+void bloch_result_free(bloch_result* result) { delete result; }
+
+int bloch_result_shots(const bloch_result* result) { return result ? result->shots : 0; }
+
+size_t bloch_result_tracked_count(const bloch_result* result) {
+    return result ? result->tracked.size() : 0;
+}
+
+bloch_status bloch_result_tracked_name(const bloch_result* result, size_t tracked, char* buffer,
+                                       size_t capacity, size_t* needed) {
+    if (!result || tracked >= result->tracked.size())
+        return fail(BLOCH_ERROR_ARGUMENT, "invalid argument");
+    return copyOut(result->tracked[tracked].first, buffer, capacity, needed);
+}
+
+size_t bloch_result_outcome_count(const bloch_result* result, size_t tracked) {
+    if (!result || tracked >= result->tracked.size())
+        return 0;
+    return result->tracked[tracked].second.size();
+}
+
+bloch_status bloch_result_outcome(const bloch_result* result, size_t tracked, size_t outcome,
+                                  char* buffer, size_t capacity, size_t* needed,
+                                  uint64_t* count) {
+    if (!result || tracked >= result->tracked.size() ||
+        outcome >= result->tracked[tracked].second.size())
+        return fail(BLOCH_ERROR_ARGUMENT, "invalid argument");
+    const auto& entry = result->tracked[tracked].second[outcome];
+    if (count)
+        *count = entry.second;
+    if (!buffer && capacity == 0 && !needed)
+        return BLOCH_OK;  // count only
+    return copyOut(entry.first, buffer, capacity, needed);
+}
+
+bloch_status bloch_result_qasm(const bloch_result* result, char* buffer, size_t capacity,
+                               size_t* needed) {
+    if (!result)
+        return fail(BLOCH_ERROR_ARGUMENT, "invalid argument");
+    return copyOut(result->qasm, buffer, capacity, needed);
+}
+
+bloch_status bloch_result_statevector(const bloch_result* result, double* buffer,
+                                      size_t capacity, size_t* needed) {
+    if (!result || !result->hasState)
+        return fail(BLOCH_ERROR_ARGUMENT, "run without BLOCH_RUN_KEEP_STATEVECTOR");
+    if (needed)
+        *needed = result->state.size();
+    if (capacity < result->state.size() || (!buffer && !result->state.empty()))
+        return fail(BLOCH_ERROR_BUFFER_TOO_SMALL, "buffer too small");
+    for (size_t i = 0; i < result->state.size(); ++i) {
+        buffer[2 * i] = result->state[i].real();
+        buffer[2 * i + 1] = result->state[i].imag();
+    }
+    lastError.clear();
+    return BLOCH_OK;
+}
+
+}  // extern "C"
@@ -0,0 +1,126 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// C API of libbloch: compile a Bloch program once, run it for any number of
+// shots, and read histograms, QASM and the statevector into caller buffers.
+// Nothing is written to stdout or stderr; echo() output is discarded.
+//
+// Functions returning bloch_status report failures as a non-zero status and
+// leave a description in bloch_last_error(), which is per thread. Copies into
+// caller buffers follow one rule: `*needed` (when not NULL) receives the full
+// length, and if `capacity` is too small nothing useful is written and
+// BLOCH_ERROR_BUFFER_TOO_SMALL is returned, so a NULL/0 call asks for the size.
+// String lengths exclude the terminating NUL, which the buffer must also hold.
+//
+// A program may be run from several threads only one run at a time; separate
+// programs are independent.
+
+#define BLOCH_C_API_VERSION 1
+
+#if defined(_WIN32) && defined(BLOCH_C_API_EXPORTS)
+#define BLOCH_API __declspec(dllexport)
+#elif defined(__GNUC__)
+#define BLOCH_API __attribute__((visibility("default")))
+#else
+#define BLOCH_API
+#endif
+
+typedef enum bloch_status {
+    BLOCH_OK = 0,
+    BLOCH_ERROR_ARGUMENT = 1,  // NULL handle, bad option or index out of range
+    BLOCH_ERROR_LEXICAL = 2,
+    BLOCH_ERROR_PARSE = 3,
+    BLOCH_ERROR_SEMANTIC = 4,
+    BLOCH_ERROR_RUNTIME = 5,
+    BLOCH_ERROR_OTHER = 6,  // I/O, memory and anything else
+    BLOCH_ERROR_BUFFER_TOO_SMALL = 7
+} bloch_status;
+
+// Flags for bloch_run.
+#define BLOCH_RUN_KEEP_STATEVECTOR 1u  // keep the final statevector of one shot
+
+typedef struct bloch_program bloch_program;
+typedef struct bloch_result bloch_result;
+
+// BLOCH_C_API_VERSION of the library actually loaded.
+BLOCH_API int bloch_api_version(void);
+
+// The last failure on this thread as "line:column: message" (or just the
+// message when it has no position); "" after a success.
+BLOCH_API const char* bloch_last_error(void);
+
+// Loads `path` and its imports, then analyses and optimises the program and
+// plans its shots (opt_level 0, 1 or 2, as --opt-level). Imports are looked
+// up next to the importing file, then in `search_paths` (the stdlib
+// directory, for example), then in the working directory.
+BLOCH_API bloch_status bloch_program_load(const char* path, const char* const* search_paths,
+                                          size_t search_path_count, int opt_level,
+                                          bloch_program** out);
+
+// As bloch_program_load, with the entry module's text given as `source`;
+// `name` is its file name for imports and errors and need not exist.
+BLOCH_API bloch_status bloch_program_compile(const char* source, const char* name,
+                                             const char* const* search_paths,
+                                             size_t search_path_count, int opt_level,
+                                             bloch_program** out);
+
+BLOCH_API void bloch_program_free(bloch_program* program);
+
+// The N of the program's @shots(N), or 0 without one.
+BLOCH_API int bloch_program_shots(const bloch_program* program);
+
+// Runs `shots` shots (0: the program's @shots, else 1) with measurement draws
+// seeded by `seed`, so equal arguments give equal results.
+BLOCH_API bloch_status bloch_run(bloch_program* program, int shots, uint64_t seed,
+                                 unsigned flags, bloch_result** out);
+
+BLOCH_API void bloch_result_free(bloch_result* result);
+
+BLOCH_API int bloch_result_shots(const bloch_result* result);
+
+// @tracked values, sorted by name ("qubit q", "qubit[] r", ...), and the
+// outcomes seen for each, sorted by outcome text.
+BLOCH_API size_t bloch_result_tracked_count(const bloch_result* result);
+BLOCH_API bloch_status bloch_result_tracked_name(const bloch_result* result, size_t tracked,
+                                                 char* buffer, size_t capacity, size_t* needed);
+BLOCH_API size_t bloch_result_outcome_count(const bloch_result* result, size_t tracked);
+// `*count` receives the outcome's shot count; pass a NULL buffer, 0 capacity
+// and NULL `needed` to read only that.
+BLOCH_API bloch_status bloch_result_outcome(const bloch_result* result, size_t tracked,
+                                            size_t outcome, char* buffer, size_t capacity,
+                                            size_t* needed, uint64_t* count);
+
+// OpenQASM 2.0 of one shot (the first when the program's circuit is replayed).
+BLOCH_API bloch_status bloch_result_qasm(const bloch_result* result, char* buffer,
+                                         size_t capacity, size_t* needed);
+
+// Amplitudes of that shot's final state as interleaved (real, imaginary)
+// pairs; `capacity` and `*needed` count amplitudes, not doubles. Bit q of an
+// amplitude's index is qubit q, numbered in allocation order. Needs
+// BLOCH_RUN_KEEP_STATEVECTOR.
+BLOCH_API bloch_status bloch_result_statevector(const bloch_result* result, double* buffer,
+                                                size_t capacity, size_t* needed);
+
+#ifdef __cplusplus
+}
+#endif
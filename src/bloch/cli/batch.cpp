@@ -0,0 +1,186 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bloch/cli/batch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include "bloch/cli/program_job.hpp"
+#include "bloch/cli/records.hpp"
+#include "bloch/support/error/bloch_error.hpp"
+#include "bloch/support/json.hpp"
+
+namespace bloch::cli {
+    namespace {
+        namespace fs = std::filesystem;
+
+        struct BatchEntry {
+            int line = 0;
+            ProgramJob job;
+            std::string problem;  // why the manifest line cannot run
+        };
+
+        // Whitespace-separated words; double quotes group a word with spaces.
+        std::vector<std::string> splitWords(const std::string& line) {
+            std::vector<std::string> words;
+            std::string word;
+            bool quoted = false;
+            bool inWord = false;
+            for (char c : line) {
+                if (c == '"') {
+                    quoted = !quoted;
+                    inWord = true;
+                } else if (!quoted && std::isspace(static_cast<unsigned char>(c))) {
+                    if (inWord)
+                        words.push_back(word);
+                    word.clear();
+                    inWord = false;
+                } else {
+                    word.push_back(c);
+                    inWord = true;
+                }
+            }
+            if (inWord)
+                words.push_back(word);
+            return words;
+        }
+
+        BatchEntry parseEntry(const std::vector<std::string>& words, int line,
+                              const fs::path& baseDir) {
+            BatchEntry entry;
+            entry.line = line;
+            for (const auto& word : words) {
+                if (word.rfind("--", 0) == 0) {
+                    entry.problem = applyJobOption(entry.job, word);
+                } else if (!entry.job.label.empty()) {
+                    entry.problem = "more than one program on the line";
+                } else {
+                    entry.job.label = word;
+                    fs::path path(word);
+                    entry.job.file = (path.is_absolute() ? path : baseDir / path).string();
+                }
+                if (!entry.problem.empty())
+                    break;
+            }
+            if (entry.problem.empty() && entry.job.label.empty())
+                entry.problem = "no program on the line";
+            return entry;
+        }
+
+        std::string record(size_t index, const BatchEntry& entry, const JobEnvironment& env,
+                           bool& ok) {
+            JobResult result;
+            if (entry.problem.empty()) {
+                result = runJob(entry.job, env);
+            } else {
+                support::BlochError problem(support::ErrorCategory::Generic, 0, 0,
+                                            "manifest: " + entry.problem);
+                result.fields = "\"status\":\"error\",\"error\":" + errorJson(problem);
+            }
+            ok = result.ok;
+            std::ostringstream out;
+            out << "{\"index\":" << index << ",\"line\":" << entry.line
+                << ",\"file\":" << support::jsonString(entry.job.label) << "," << result.fields
+                << "}";
+            return out.str();
+        }
+
+        int usage() {
+            std::cerr << "Usage: bloch batch <manifest> [--jobs=N]\n";
+            return 1;
+        }
+    }  // namespace
+
+    int runBatch(int argc, char** argv, const std::vector<std::string>& stdlibPaths) {
+        std::string manifestPath;
+        unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg.rfind("--jobs=", 0) == 0) {
+                int count = 0;
+                try {
+                    count = std::stoi(arg.substr(7));
+                } catch (const std::exception&) {
+                }
+                if (count <= 0) {
+                    std::cerr << "--jobs must be positive\n";
+                    return 1;
+                }
+                jobs = static_cast<unsigned>(count);
+            } else if (manifestPath.empty()) {
+                manifestPath = arg;
+            } else {
+                return usage();
+            }
+        }
+        if (manifestPath.empty())
+            return usage();
+        std::ifstream manifest(manifestPath);
+        if (!manifest) {
+            std::cerr << "cannot read manifest '" << manifestPath << "'\n";
+            return 1;
+        }
+        fs::path baseDir = fs::absolute(fs::path(manifestPath)).parent_path();
+        std::vector<BatchEntry> entries;
+        std::string line;
+        for (int number = 1; std::getline(manifest, line); ++number) {
+            std::vector<std::string> words = splitWords(line);
+            if (words.empty() || words.front().rfind('#', 0) == 0)
+                continue;
+            entries.push_back(parseEntry(words, number, baseDir));
+        }
+
+        // Workers take the next program in turn; records are printed in
+        // manifest order as soon as every earlier one is done.
+        JobEnvironment env{stdlibPaths, std::make_shared<compiler::ModuleCache>(), nullptr};
+        std::vector<std::string> records(entries.size());
+        std::vector<bool> finished(entries.size(), false);
+        std::atomic<size_t> next{0};
+        std::atomic<int> failures{0};
+        std::mutex outputMutex;
+        size_t printed = 0;
+        auto work = [&]() {
+            for (size_t i = next++; i < entries.size(); i = next++) {
+                bool ok = false;
+                std::string text = record(i, entries[i], env, ok);
+                if (!ok)
+                    ++failures;
+                std::lock_guard<std::mutex> lock(outputMutex);
+                records[i] = std::move(text);
+                finished[i] = true;
+                for (; printed < entries.size() && finished[printed]; ++printed) {
+                    std::cout << records[printed] << "\n";
+                    records[printed].clear();
+                }
+                std::cout.flush();
+            }
+        };
+        std::vector<std::thread> workers;
+        unsigned count = std::min<unsigned>(jobs, static_cast<unsigned>(entries.size()));
+        for (unsigned w = 1; w < count; ++w) workers.emplace_back(work);
+        work();
+        for (auto& worker : workers) worker.join();
+        return failures == 0 ? 0 : 1;
+    }
+
+}  // namespace bloch::cli
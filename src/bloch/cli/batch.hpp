@@ -0,0 +1,34 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace bloch::cli {
+
+    // `bloch batch <manifest> [--jobs=N]`: runs every program the manifest
+    // lists in this process, on a pool of N worker threads (default: one per
+    // core), and prints one JSON record per program to stdout in manifest
+    // order. Loaded module files, the stdlib among them, are shared between
+    // programs. Returns 0 when every program succeeded.
+    //
+    // Each manifest line is a program path (relative to the manifest) and
+    // any of --shots=N, --opt-level=0|1|2, --seed=S, --ci-width=W,
+    // --emit-only and --emit-qasm. Blank lines and lines starting with '#'
+    // are skipped.
+    int runBatch(int argc, char** argv, const std::vector<std::string>& stdlibPaths);
+
+}  // namespace bloch::cli
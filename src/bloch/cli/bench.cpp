@@ -0,0 +1,270 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bloch/cli/bench.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string_view>
+
+#include "bloch/cli/program_job.hpp"
+#include "bloch/cli/run_metrics.hpp"
+#include "bloch/runtime/shot_runner.hpp"
+#include "bloch/runtime/stopwatch.hpp"
+#include "bloch/support/error/bloch_error.hpp"
+#include "bloch/support/json.hpp"
+
+namespace bloch::cli {
+    namespace {
+        constexpr const char* kUsage =
+            "Usage: bloch bench <file.bloch> [--runs=N] [--warmup=N] [--seed=S] [--shots=N]\n"
+            "                   [--opt-level=0|1|2] [--json=FILE] [--baseline=FILE]\n"
+            "                   [--threshold=PCT]\n";
+
+        struct BenchSettings {
+            ProgramJob job;
+            int runs = 10;
+            int warmup = 2;
+            std::string jsonPath;
+            std::string baselinePath;
+            double thresholdPercent = 5.0;
+        };
+
+        struct BenchReport {
+            std::string file;
+            int shots = 0;
+            int shotsRun = 0;
+            std::uint64_t seed = 0;
+            int optLevel = 1;
+            int warmup = 0;
+            std::vector<double> runMs;  // sorted
+            double shotsPerSecond = 0.0;
+            std::optional<std::size_t> peakResidentBytes;
+
+            // Linear interpolation between the closest ranks.
+            double percentile(double p) const {
+                double pos = p * static_cast<double>(runMs.size() - 1);
+                size_t lo = static_cast<size_t>(pos);
+                size_t hi = std::min(lo + 1, runMs.size() - 1);
+                return runMs[lo] + (runMs[hi] - runMs[lo]) * (pos - static_cast<double>(lo));
+            }
+        };
+
+        std::optional<int> parseCount(const std::string& text, int min) {
+            if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos ||
+                text.size() > 9)
+                return std::nullopt;
+            int value = std::stoi(text);
+            if (value < min)
+                return std::nullopt;
+            return value;
+        }
+
+        void writeReport(std::ostream& out, const BenchReport& report) {
+            // Nanosecond resolution, so fast programs still compare cleanly.
+            out << std::fixed << std::setprecision(6);
+            out << "{\"file\":" << support::jsonString(report.file)
+                << ",\"shots\":" << report.shots << ",\"shotsRun\":" << report.shotsRun
+                << ",\"seed\":" << report.seed << ",\"optLevel\":" << report.optLevel
+                << ",\"warmup\":" << report.warmup << ",\"runs\":" << report.runMs.size()
+                << ",\"minMs\":" << report.runMs.front()
+                << ",\"medianMs\":" << report.percentile(0.5)
+                << ",\"p90Ms\":" << report.percentile(0.9)
+                << ",\"p99Ms\":" << report.percentile(0.99)
+                << ",\"maxMs\":" << report.runMs.back() << ",\"runMs\":[";
+            for (size_t i = 0; i < report.runMs.size(); ++i)
+                out << (i ? "," : "") << report.runMs[i];
+            out << "],\"shotsPerSecond\":" << report.shotsPerSecond << ",\"peakRssBytes\":";
+            if (report.peakResidentBytes)
+                out << *report.peakResidentBytes;
+            else
+                out << "null";
+            out << "}\n";
+        }
+
+        // The number after "key": in a report written by writeReport.
+        std::optional<double> reportNumber(const std::string& json, const std::string& key) {
+            size_t at = json.find("\"" + key + "\":");
+            if (at == std::string::npos)
+                return std::nullopt;
+            const char* start = json.c_str() + at + key.size() + 3;
+            char* end = nullptr;
+            double value = std::strtod(start, &end);
+            if (end == start)
+                return std::nullopt;
+            return value;
+        }
+
+        // Prints how the median compares with the baseline's; returns false
+        // for a regression beyond the threshold.
+        bool compareWithBaseline(const BenchReport& report, const BenchSettings& settings) {
+            std::ifstream in(settings.baselinePath);
+            if (!in)
+                throw support::BlochError(support::ErrorCategory::Runtime, 0, 0,
+                                          "cannot read baseline '" + settings.baselinePath + "'");
+            std::string json((std::istreambuf_iterator<char>(in)),
+                             std::istreambuf_iterator<char>());
+            std::optional<double> baseline = reportNumber(json, "medianMs");
+            if (!baseline || *baseline <= 0.0)
+                throw support::BlochError(
+                    support::ErrorCategory::Runtime, 0, 0,
+                    "'" + settings.baselinePath + "' is not a bloch bench report");
+            if (auto shots = reportNumber(json, "shotsRun"); shots && *shots != report.shotsRun)
+                support::blochWarning(0, 0,
+                                      "the baseline ran " +
+                                          std::to_string(static_cast<long long>(*shots)) +
+                                          " shots per run; this run " +
+                                          std::to_string(report.shotsRun));
+            double median = report.percentile(0.5);
+            double change = (median / *baseline - 1.0) * 100.0;
+            std::cout << "Baseline: median " << *baseline << " ms; " << std::showpos
+                      << std::setprecision(1) << change << std::noshowpos << "% (threshold "
+                      << settings.thresholdPercent << "%)\n"
+                      << std::setprecision(3);
+            if (change <= settings.thresholdPercent)
+                return true;
+            std::ostringstream message;
+            message << std::fixed << std::setprecision(1) << "regression: the median is "
+                    << change << "% slower than the baseline";
+            std::cout.flush();
+            support::blochWarning(0, 0, message.str());
+            return false;
+        }
+    }  // namespace
+
+    int runBench(int argc, char** argv, const std::vector<std::string>& stdlibPaths) {
+        BenchSettings settings;
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto valueOf = [&](std::string_view flag) -> std::optional<std::string> {
+                if (arg.rfind(flag, 0) != 0)
+                    return std::nullopt;
+                return arg.substr(flag.size());
+            };
+            std::string problem;
+            if (auto value = valueOf("--runs=")) {
+                auto runs = parseCount(*value, 1);
+                if (!runs)
+                    problem = "--runs must be positive";
+                settings.runs = runs.value_or(0);
+            } else if (auto value = valueOf("--warmup=")) {
+                auto warmup = parseCount(*value, 0);
+                if (!warmup)
+                    problem = "--warmup must be a non-negative integer";
+                settings.warmup = warmup.value_or(0);
+            } else if (auto value = valueOf("--json=")) {
+                settings.jsonPath = *value;
+            } else if (auto value = valueOf("--baseline=")) {
+                settings.baselinePath = *value;
+            } else if (auto value = valueOf("--threshold=")) {
+                size_t used = 0;
+                try {
+                    settings.thresholdPercent = std::stod(*value, &used);
+                } catch (const std::exception&) {
+                    used = 0;
+                }
+                if (used == 0 || used != value->size() || !(settings.thresholdPercent >= 0.0))
+                    problem = "--threshold must be a non-negative percentage";
+            } else if (arg.rfind("--shots=", 0) == 0 || arg.rfind("--opt-level=", 0) == 0 ||
+                       arg.rfind("--seed=", 0) == 0) {
+                problem = applyJobOption(settings.job, arg);
+            } else if (arg.rfind("--", 0) == 0 || !settings.job.file.empty()) {
+                problem = "unsupported argument '" + arg + "'";
+            } else {
+                settings.job.file = arg;
+            }
+            if (!problem.empty()) {
+                std::cerr << problem << "\n" << kUsage;
+                return 1;
+            }
+        }
+        if (settings.job.file.empty()) {
+            std::cerr << kUsage;
+            return 1;
+        }
+
+        try {
+            JobEnvironment env;
+            env.stdlibPaths = stdlibPaths;
+            std::unique_ptr<compiler::Program> program = compileProgram(settings.job, env);
+            runtime::ShotOptions options;
+            // As in single runs, @shots(N) wins over --shots.
+            options.shots = program->shots.first ? program->shots.second
+                                                 : settings.job.shots.value_or(1);
+            options.echo = false;
+            options.warnings = false;
+            options.circuitOptimisation = settings.job.optLevel >= 2;
+            options.seed = settings.job.seed.value_or(1);
+            runtime::planShots(*program, settings.job.optLevel, options);
+
+            BenchReport report;
+            report.file = settings.job.file;
+            report.shots = options.shots;
+            report.seed = *options.seed;
+            report.optLevel = settings.job.optLevel;
+            report.warmup = settings.warmup;
+            for (int i = 0; i < settings.warmup; ++i) runtime::runShots(*program, options);
+            for (int i = 0; i < settings.runs; ++i) {
+                runtime::Stopwatch watch;
+                runtime::ShotResult result = runtime::runShots(*program, options);
+                report.runMs.push_back(watch.elapsed().wallSeconds * 1000.0);
+                report.shotsRun = result.shotsRun;
+            }
+            std::sort(report.runMs.begin(), report.runMs.end());
+            double median = report.percentile(0.5);
+            if (median > 0.0)
+                report.shotsPerSecond = report.shotsRun / (median / 1000.0);
+            report.peakResidentBytes = peakResidentBytes();
+
+            std::cout << std::fixed << std::setprecision(3);
+            std::cout << "Benchmark: " << report.file << "\n";
+            std::cout << "Shots: " << report.shotsRun << " per run (seed " << report.seed
+                      << ")\n";
+            std::cout << "Runs: " << settings.runs << " timed after " << settings.warmup
+                      << " warm-up\n";
+            std::cout << "Wall time: min " << report.runMs.front() << " ms, median " << median
+                      << " ms, p90 " << report.percentile(0.9) << " ms, p99 "
+                      << report.percentile(0.99) << " ms\n";
+            std::cout << "Throughput: " << std::setprecision(1) << report.shotsPerSecond
+                      << " shots/s at the median\n";
+            if (report.peakResidentBytes)
+                std::cout << "Peak RSS: "
+                          << static_cast<double>(*report.peakResidentBytes) / (1024.0 * 1024.0)
+                          << " MiB\n";
+            std::cout << std::setprecision(3);
+
+            if (!settings.jsonPath.empty()) {
+                std::ofstream out(settings.jsonPath);
+                writeReport(out, report);
+                if (!out)
+                    throw support::BlochError(support::ErrorCategory::Runtime, 0, 0,
+                                              "cannot write '" + settings.jsonPath + "'");
+            }
+            if (!settings.baselinePath.empty() && !compareWithBaseline(report, settings))
+                return 1;
+        } catch (const std::exception& ex) {
+            std::cerr << ex.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+}  // namespace bloch::cli
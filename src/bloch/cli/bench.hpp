@@ -0,0 +1,33 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace bloch::cli {
+
+    // `bloch bench <file.bloch>`: compiles the program once, runs it
+    // --warmup=N times untimed and --runs=N times timed, all with the same
+    // seed (--seed=S, default 1), and prints the min, median, p90 and p99
+    // wall time of a run, shots per second at the median and peak RSS. Echo
+    // and the QASM file are suppressed, so only execution is timed.
+    //
+    // --json=FILE saves the report; --baseline=FILE compares the median with
+    // a saved report and fails when it is more than --threshold=PCT percent
+    // (default 5) slower. Also takes --shots=N and --opt-level=0|1|2.
+    int runBench(int argc, char** argv, const std::vector<std::string>& stdlibPaths);
+
+}  // namespace bloch::cli
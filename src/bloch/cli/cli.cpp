@@ -16,29 +16,90 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <string_view>
 #include <unordered_map>
 #include <vector>
 
+#include "bloch/cli/batch.hpp"
+#include "bloch/cli/bench.hpp"
+#include "bloch/cli/file_watcher.hpp"
+#include "bloch/cli/result_writer.hpp"
+#include "bloch/cli/run_metrics.hpp"
+#include "bloch/cli/server.hpp"
+#include "bloch/compiler/analysis/feedback_analysis.hpp"
+#include "bloch/compiler/analysis/resource_estimator.hpp"
 #include "bloch/compiler/import/module_loader.hpp"
+#include "bloch/compiler/optimiser/optimiser.hpp"
+#include "bloch/compiler/optimiser/rewrite_utils.hpp"
 #include "bloch/compiler/semantics/semantic_analyser.hpp"
-#include "bloch/runtime/runtime_evaluator.hpp"
+#include "bloch/runtime/partial_result.hpp"
+#include "bloch/runtime/profiler.hpp"
+#include "bloch/runtime/qasm_simulator.hpp"
+#include "bloch/runtime/shot_runner.hpp"
+#include "bloch/runtime/stopwatch.hpp"
+#include "bloch/runtime/timeline.hpp"
 #include "bloch/support/error/bloch_error.hpp"
 #include "bloch/update/update_manager.hpp"
 
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 namespace bloch::cli {
     namespace {
         namespace fs = std::filesystem;
 
+        // Set by the first Ctrl-C of a multi-shot run; see InterruptGuard.
+        std::atomic<bool> g_stopShots{false};
+
+        void stopShots(int) {
+            g_stopShots = true;
+            // A second Ctrl-C ends the process as usual.
+            std::signal(SIGINT, SIG_DFL);
+        }
+
+        // While alive, Ctrl-C stops the shot run at the next shot boundary
+        // instead of ending the process, so the shots already run are kept.
+        class InterruptGuard {
+           public:
+            InterruptGuard() {
+                g_stopShots = false;
+                m_previous = std::signal(SIGINT, stopShots);
+                if (m_previous == SIG_ERR)
+                    m_previous = SIG_DFL;
+            }
+            ~InterruptGuard() { std::signal(SIGINT, m_previous); }
+            InterruptGuard(const InterruptGuard&) = delete;
+            InterruptGuard& operator=(const InterruptGuard&) = delete;
+
+           private:
+            void (*m_previous)(int) = SIG_DFL;
+        };
+
+        bool stderrIsTerminal() {
+#if defined(_WIN32)
+            return _isatty(_fileno(stderr)) != 0;
+#else
+            return isatty(STDERR_FILENO) != 0;
+#endif
+        }
+
         struct CliOption {
             std::string_view flag;
             std::string_view arg;
@@ -51,17 +112,69 @@ namespace bloch::cli {
         static constexpr std::string_view kFlagShotsPrefix = "--shots=";
         static constexpr std::string_view kFlagEchoPrefix = "--echo=";
         static constexpr std::string_view kFlagUpdate = "--update";
-
-        static constexpr std::array<CliOption, 6> kCliOptions = {
+        static constexpr std::string_view kFlagOptLevelPrefix = "--opt-level=";
+        static constexpr std::string_view kFlagEmitOnly = "--emit-only";
+        static constexpr std::string_view kFlagEstimate = "--estimate";
+        static constexpr std::string_view kFlagWatch = "--watch";
+        static constexpr std::string_view kFlagRecordTracePrefix = "--record-trace=";
+        static constexpr std::string_view kFlagReplayTracePrefix = "--replay-trace=";
+        static constexpr std::string_view kFlagCiWidthPrefix = "--ci-width=";
+        static constexpr std::string_view kFlagSeedPrefix = "--seed=";
+        static constexpr std::string_view kFlagShardPrefix = "--shard=";
+        static constexpr std::string_view kFlagOutputPrefix = "--output=";
+        static constexpr std::string_view kFlagShotLogPrefix = "--shot-log=";
+        static constexpr std::string_view kFlagProfile = "--profile";
+        static constexpr std::string_view kFlagProfilePrefix = "--profile=";
+        static constexpr std::string_view kFlagMetricsPrefix = "--metrics=";
+        static constexpr std::string_view kFlagTracePrefix = "--trace=";
+        static constexpr std::string_view kCommandMerge = "merge";
+        static constexpr std::string_view kCommandBatch = "batch";
+        static constexpr std::string_view kCommandServe = "serve";
+        static constexpr std::string_view kCommandBench = "bench";
+
+        static constexpr std::array<CliOption, 20> kCliOptions = {
             CliOption{kFlagHelp, "", "Show this help and exit"},
             CliOption{kFlagVersion, "", "Print version and exit (checks for newer releases)"},
             CliOption{kFlagEmitQasm, "", "Print emitted QASM to stdout"},
+            CliOption{kFlagEmitOnly, "",
+                      "Write QASM without simulating (measurements must not affect execution)"},
+            CliOption{kFlagEstimate, "",
+                      "Print qubit, gate, depth and memory estimates without running"},
+            CliOption{"--record-trace", "=FILE", "Save every measurement outcome to FILE"},
+            CliOption{"--replay-trace", "=FILE",
+                      "Rerun with the measurement outcomes in FILE, without simulating"},
             CliOption{
                 "--shots", "=N",
                 "Run the program N times and aggregate @tracked counts (deprecated in v2.0.0; "
                 "prefer @shots(N))"},
+            CliOption{"--ci-width", "=W",
+                      "Treat the shot count as a budget and stop once every @tracked outcome's "
+                      "95% interval is at most W wide"},
+            CliOption{"--seed", "=S", "Seed measurement sampling so runs repeat exactly"},
+            CliOption{"--shard", "=I/N",
+                      "Run shard I (0-based) of N of the shots and save a partial result for "
+                      "'bloch merge' (needs --seed)"},
+            CliOption{"--output", "=table|json|csv|bin",
+                      "Print @tracked counts as a table (default), one JSON object, CSV rows "
+                      "or packed binary"},
+            CliOption{"--shot-log", "=FILE",
+                      "Stream every shot's @tracked outcomes to FILE as bit-packed records"},
+            CliOption{kFlagProfile, "[=sample]",
+                      "Report time, gates and statevector passes per function and line on "
+                      "stderr, and write collapsed stacks to <file>.folded"},
+            CliOption{"--metrics", "=FILE",
+                      "Write per-phase wall and CPU time, memory peaks, gate counts and "
+                      "throughput to FILE as JSON"},
+            CliOption{"--trace", "=FILE",
+                      "Write a Chrome/Perfetto timeline of phases, calls, gates, measurements, "
+                      "collections and shots to FILE"},
             CliOption{"--echo", "=auto|all|none",
                       "Control echo statements (default: auto; suppress when taking many shots)"},
+            CliOption{"--opt-level", "=0|1|2",
+                      "Optimisation level (default: 1; 0 disables, 2 adds circuit peephole "
+                      "optimisation)"},
+            CliOption{kFlagWatch, "",
+                      "Run again whenever the program or a module it imports changes"},
             CliOption{kFlagUpdate, "", "Download and install the latest release"},
         };
 
@@ -79,7 +192,12 @@ namespace bloch::cli {
                 width = std::max(width, opt.flag.size() + opt.arg.size());
             }
             std::cout << "Bloch " << formattedVersion(ctx) << "\n"
-                      << "Usage: bloch [options] <file.bloch>\n\n"
+                      << "Usage: bloch [options] <file.bloch>\n"
+                      << "       bloch merge <file.partial>...\n"
+                      << "       bloch batch <manifest> [--jobs=N]\n"
+                      << "       bloch serve [--port=P] [--jobs=N] [--queue=N]\n"
+                      << "       bloch bench <file.bloch> [--runs=N] [--warmup=N] "
+                         "[--baseline=FILE]\n\n"
                       << "Options:\n";
             for (const auto& opt : kCliOptions) {
                 std::ostringstream line;
@@ -90,11 +208,53 @@ namespace bloch::cli {
             std::cout << "\nBehaviour:\n"
                       << "  - Writes <file>.qasm alongside the input file.\n"
                       << "  - When --shots is used, prints an aggregate table of tracked values.\n"
+                      << "  - merge adds up the partial results of --shard runs and prints the "
+                         "table.\n"
+                      << "  - bench times repeated runs with a fixed seed and reports wall "
+                         "time percentiles.\n"
                       << std::endl;
         }
 
         void printVersion(const Context& ctx) { std::cout << formattedVersion(ctx) << std::endl; }
 
+        // Statevector size for `qubits` qubits, e.g. "2^14 B (16.0 KiB)".
+        std::string describeStatevector(int qubits) {
+            int exponent = 0;
+            while ((size_t{1} << exponent) < bloch::runtime::QasmSimulator::kBytesPerAmplitude)
+                ++exponent;
+            exponent += qubits;
+            std::string power = "2^" + std::to_string(exponent) + " B";
+            static constexpr std::array<std::string_view, 7> units = {"B",   "KiB", "MiB", "GiB",
+                                                                      "TiB", "PiB", "EiB"};
+            size_t unit = std::min<size_t>(exponent / 10, units.size() - 1);
+            int remainder = exponent - static_cast<int>(unit) * 10;
+            if (remainder >= 20)
+                return power;
+            std::ostringstream out;
+            out << power << " (" << (1 << remainder) << " " << units[unit] << ")";
+            return out.str();
+        }
+
+        void printEstimate(const bloch::compiler::ResourceEstimate& estimate, int shots) {
+            std::cout << "Resource estimate (per shot)\n";
+            std::cout << "Shots: " << shots << "\n";
+            std::cout << "Qubits: " << estimate.qubits << "\n";
+            std::cout << "Depth: " << estimate.depth << "\n";
+            std::cout << "Gates: " << estimate.totalGates() << "\n";
+            for (const auto& [name, count] : estimate.gates)
+                std::cout << "  " << std::left << std::setw(4) << name << count << "\n";
+            std::cout << "Measurements: " << estimate.measurements << "\n";
+            std::cout << "Resets: " << estimate.resets << "\n\n";
+            std::cout << "Memory:\n";
+            std::cout << "  Bloch Ideal Simulator: " << describeStatevector(estimate.qubits)
+                      << " statevector\n";
+            std::cout << "  " << kFlagEmitOnly << ": no statevector\n";
+            if (!estimate.exact) {
+                std::cout << "\nApproximations:\n";
+                for (const auto& note : estimate.notes) std::cout << "  - " << note << "\n";
+            }
+        }
+
         std::string normaliseVersion(std::string_view version) {
             std::string v(version);
             if (!v.empty() && v.front() == 'v')
@@ -178,76 +338,140 @@ namespace bloch::cli {
             return paths;
         }
 
-        int runImpl(int argc, char** argv, const Context& ctx) {
-            const std::string version(ctx.version);
-            if (argc < 2) {
-                std::cerr << "Usage: bloch [options] <file.bloch> (use --help for details)\n";
-                return 1;
-            }
-
-            bool emitQasm = false;
-            int shots = 1;
-            bool shotsProvided = false;
-            bool isCliShots = false;
-            int cliShots = 1;
-            bool isAnnotationShots = false;
-            std::string echoOpt;
-            std::string file;
-
-            for (int i = 1; i < argc; ++i) {
+        // `bloch merge <file.partial>...`: combines the shards of one run.
+        int runMerge(int argc, char** argv) {
+            OutputFormat output = OutputFormat::Table;
+            std::vector<std::string> paths;
+            for (int i = 2; i < argc; ++i) {
                 std::string arg = argv[i];
-                if (arg == kFlagHelp) {
-                    printHelp(ctx);
-                    return 0;
-                } else if (arg == kFlagVersion) {
-                    printVersion(ctx);
-                    bloch::update::checkForUpdatesIfDue(version);
-                    return 0;
-                } else if (arg == kFlagUpdate) {
-                    return bloch::update::performSelfUpdate(version, argv[0]) ? 0 : 1;
-                } else if (arg == kFlagEmitQasm) {
-                    emitQasm = true;
-                } else if (arg.rfind(kFlagShotsPrefix, 0) == 0) {
-                    isCliShots = true;
-                    cliShots = std::stoi(arg.substr(kFlagShotsPrefix.size()));
-                    if (cliShots <= 0) {
-                        std::cerr << "--shots must be positive\n";
+                if (arg.rfind(kFlagOutputPrefix, 0) == 0) {
+                    auto format = parseOutputFormat(arg.substr(kFlagOutputPrefix.size()));
+                    if (!format) {
+                        std::cerr << "--output must be table, json, csv or bin\n";
                         return 1;
                     }
-                } else if (arg.rfind(kFlagEchoPrefix, 0) == 0) {
-                    echoOpt = arg.substr(kFlagEchoPrefix.size());
+                    output = *format;
                 } else {
-                    file = arg;
+                    paths.push_back(arg);
                 }
             }
-            if (file.empty()) {
-                std::cerr << "No input file provided (use --help for usage)\n";
+            if (paths.empty()) {
+                std::cerr << "Usage: bloch merge [--output=FORMAT] <file.partial>...\n";
                 return 1;
             }
+            try {
+                std::vector<bloch::runtime::PartialResult> partials;
+                for (const auto& path : paths)
+                    partials.push_back(bloch::runtime::PartialResult::load(path));
+                bloch::runtime::MergedResult merged =
+                    bloch::runtime::mergePartialResults(partials);
+                if (!merged.missingShards.empty()) {
+                    std::string missing;
+                    for (int shard : merged.missingShards)
+                        missing += (missing.empty() ? "" : ", ") + std::to_string(shard);
+                    bloch::support::blochWarning(
+                        0, 0,
+                        "missing shard(s) " + missing + " of " +
+                            std::to_string(merged.shardCount) + "; counts cover " +
+                            std::to_string(merged.shotsRun) + " of " +
+                            std::to_string(merged.totalShots) + " shots");
+                }
+                if (merged.trackedCounts.empty())
+                    bloch::support::blochWarning(
+                        0, 0, "No tracked variables. Use @tracked to collect statistics.");
+                RunSummary summary;
+                summary.shots = merged.totalShots;
+                summary.shotsRun = merged.shotsRun;
+                summary.seed = merged.seed;
+                if (output == OutputFormat::Table) {
+                    std::cout << "Shots: " << merged.shotsRun << "\n";
+                    std::cout << "Shards: " << partials.size() << " of " << merged.shardCount
+                              << "\n";
+                    std::cout << "Backend: Bloch Ideal Simulator\n\n";
+                }
+                writeResult(std::cout, output, summary, merged.trackedCounts);
+            } catch (const std::exception& ex) {
+                std::cerr << ex.what() << std::endl;
+                return 1;
+            }
+            return 0;
+        }
 
-            // Run a non-blocking update check at most once every 72 hours.
-            bloch::update::checkForUpdatesIfDue(version);
+        // Flags that shape a single run, parsed once by runImpl.
+        struct RunSettings {
+            std::string file;
+            bool emitQasm = false;
+            bool emitOnly = false;
+            bool estimate = false;
+            std::string recordTracePath;
+            std::string replayTracePath;
+            std::string shotLogPath;
+            std::optional<bloch::runtime::Profiler::Mode> profile;
+            std::string metricsPath;
+            std::string tracePath;
+            double ciWidth = 0.0;
+            std::optional<std::uint64_t> seed;
+            int shard = -1;
+            int shardCount = 0;
+            bool isCliShots = false;
+            int cliShots = 1;
+            int optLevel = 1;
+            std::string echoOpt;
+            OutputFormat output = OutputFormat::Table;
+        };
 
+        // Loads, checks and runs settings.file once, printing results or the
+        // error. Returns the exit status.
+        int runProgram(const RunSettings& settings, bloch::compiler::ModuleLoader& loader) {
+            int shots = 1;
+            bool shotsProvided = false;
+            double ciWidth = settings.ciWidth;
+            RunMetrics metrics;
+            metrics.file = settings.file;
+            bloch::runtime::Stopwatch phaseWatch;
+            std::unique_ptr<bloch::runtime::Timeline> timeline;
+            double phaseStart = 0.0;
+            // Ends the phase that began at the previous call; `time` is what
+            // --metrics reports for it.
+            auto markPhase = [&](const char* name) {
+                bloch::runtime::PhaseTime time = phaseWatch.lap();
+                if (timeline) {
+                    timeline->complete("phase", name, phaseStart);
+                    phaseStart = timeline->now();
+                }
+                return time;
+            };
+            auto endPhase = [&](const char* name) {
+                metrics.phases.emplace_back(name, markPhase(name));
+            };
             try {
-                auto stdlibPaths = resolveStdlibSearchPaths(ctx, argc > 0 ? argv[0] : nullptr);
-                bloch::compiler::ModuleLoader loader(stdlibPaths);
-                std::unique_ptr<bloch::compiler::Program> program = loader.load(file);
+                if (!settings.tracePath.empty())
+                    timeline = std::make_unique<bloch::runtime::Timeline>(settings.tracePath);
+                std::unique_ptr<bloch::compiler::Program> program = loader.load(settings.file);
+                endPhase("load");
+                metrics.astNodes = bloch::compiler::countNodes(program.get());
+                for (const auto& module : loader.modules()) {
+                    std::error_code ec;
+                    auto size = fs::file_size(module, ec);
+                    if (!ec)
+                        metrics.sourceBytes += size;
+                }
                 bool isAnnotationShots = program->shots.first;
 
-                if (isCliShots && !isAnnotationShots) {
+                if (settings.isCliShots && !isAnnotationShots) {
                     shotsProvided = true;
-                    shots = cliShots;
+                    shots = settings.cliShots;
                     bloch::support::blochWarning(
                         0, 0,
                         "The '--shots=N' flag will be deprecated in v2.0.0. Please decorate your "
                         "main() function with the @shots(N) annotation instead.");
-                } else if (!isCliShots && isAnnotationShots) {
+                } else if (!settings.isCliShots && isAnnotationShots) {
                     shotsProvided = true;
                     shots = program->shots.second;
-                } else if (isCliShots && isAnnotationShots) {
+                } else if (settings.isCliShots && isAnnotationShots) {
                     shotsProvided = true;
                     shots = program->shots.second;
-                    if (cliShots != shots) {
+                    if (settings.cliShots != shots) {
                         bloch::support::blochWarning(
                             0, 0,
                             "The '--shots=N' flag differs from your @shots(N) annotation. Ignoring "
@@ -255,113 +479,287 @@ namespace bloch::cli {
                     }
                 }
 
+                if (settings.emitOnly && shotsProvided && !settings.estimate) {
+                    bloch::support::blochInfo(
+                        0, 0, "--emit-only runs the program once; ignoring the shot count");
+                    shotsProvided = false;
+                    shots = 1;
+                }
+                if (settings.output != OutputFormat::Table && !shotsProvided) {
+                    // Report the single run's counts in the requested format.
+                    shotsProvided = true;
+                    shots = 1;
+                }
+                if (settings.shardCount > 0 && !shotsProvided) {
+                    std::cerr << "--shard needs a shot count; set one with @shots(N)\n";
+                    return 1;
+                }
+                if (ciWidth > 0.0 && !settings.estimate && (!shotsProvided || shots == 1)) {
+                    bloch::support::blochWarning(
+                        0, 0, "--ci-width needs a shot budget; set one with @shots(N)");
+                    ciWidth = 0.0;
+                }
+
                 // By default we suppress echo when taking many shots, unless the user
                 // explicitly asks for it via --echo=all.
-                bool echoAll =
-                    echoOpt.empty() ? (!shotsProvided || shots == 1) : (echoOpt == "all");
-                if (shotsProvided && shots > 1 && echoOpt.empty())
+                bool echoAll = settings.echoOpt.empty()
+                                   ? (!shotsProvided || shots == 1) &&
+                                         settings.output == OutputFormat::Table
+                                   : (settings.echoOpt == "all");
+                if (shotsProvided && shots > 1 && settings.echoOpt.empty() && !settings.estimate)
                     bloch::support::blochInfo(0, 0,
                                               "suppressing echo; to view them use --echo=all");
 
                 bloch::compiler::SemanticAnalyser analyser;
                 analyser.analyse(*program);
+                endPhase("analyse");
+                if (settings.optLevel >= 1) {
+                    bloch::compiler::Optimiser optimiser;
+                    optimiser.optimise(*program);
+                }
+                endPhase("optimise");
+                if (settings.estimate) {
+                    printEstimate(bloch::compiler::estimateResources(*program), shots);
+                    return 0;
+                }
+                if (settings.emitOnly) {
+                    // Without a statevector every measurement reads 0, so none may
+                    // influence what runs.
+                    auto feedback = bloch::compiler::analyseFeedback(*program);
+                    if (!feedback.feedbackFree) {
+                        throw bloch::support::BlochError(
+                            bloch::support::ErrorCategory::Semantic, feedback.line,
+                            feedback.column,
+                            "--emit-only cannot run this program: " + feedback.reason);
+                    }
+                }
+                bloch::runtime::ShotOptions shotOptions;
+                shotOptions.seed = settings.seed;
+                // Echoed values could be fake measurement results under --emit-only.
+                shotOptions.echo = echoAll && !settings.emitOnly;
+                shotOptions.simulate = !settings.emitOnly;
+                shotOptions.circuitOptimisation = settings.optLevel >= 2;
+                bloch::runtime::MeasurementTrace trace;
+                if (!settings.replayTracePath.empty()) {
+                    trace = bloch::runtime::MeasurementTrace::load(settings.replayTracePath);
+                    if (trace.shots() != shots)
+                        throw bloch::support::BlochError(
+                            bloch::support::ErrorCategory::Runtime, 0, 0,
+                            "'" + settings.replayTracePath + "' records " +
+                                std::to_string(trace.shots()) + " shots but this run takes " +
+                                std::to_string(shots));
+                    shotOptions.replayTrace = &trace;
+                } else if (!settings.recordTracePath.empty()) {
+                    shotOptions.recordTrace = &trace;
+                }
+                bloch::runtime::planShots(*program, settings.optLevel, shotOptions);
+                std::unique_ptr<bloch::runtime::ShotLog> shotLog;
+                if (!settings.shotLogPath.empty()) {
+                    shotLog = std::make_unique<bloch::runtime::ShotLog>(settings.shotLogPath);
+                    shotOptions.shotLog = shotLog.get();
+                }
+                std::unique_ptr<bloch::runtime::Profiler> profiler;
+                if (settings.profile) {
+                    profiler = std::make_unique<bloch::runtime::Profiler>(*settings.profile);
+                    shotOptions.profiler = profiler.get();
+                }
+                shotOptions.timeline = timeline.get();
+                auto reportProfile = [&profiler](const std::string& base) {
+                    if (!profiler)
+                        return;
+                    std::cout.flush();
+                    profiler->report(std::cerr);
+                    std::ofstream folded(base + ".folded");
+                    profiler->writeCollapsed(folded);
+                    bloch::support::blochInfo(0, 0, "wrote " + base + ".folded");
+                };
+                auto reportCircuit = [&shotOptions](const bloch::runtime::ShotResult& result) {
+                    if (!shotOptions.circuitOptimisation)
+                        return;
+                    bloch::support::blochInfo(
+                        0, 0,
+                        "circuit optimiser removed " + std::to_string(result.gatesRemoved) +
+                            " of " + std::to_string(result.gatesSubmitted) + " gates");
+                };
+                metrics.shots = shotsProvided ? shots : 1;
+                // runShots' wall time, split into its phases.
+                auto recordRun = [&](const bloch::runtime::ShotResult& result) {
+                    bloch::runtime::PhaseTime run = markPhase("run");
+                    bloch::runtime::PhaseTime execute = run;
+                    execute -= result.classTableTime;
+                    execute -= result.qasmTime;
+                    metrics.phases.emplace_back("classTable", result.classTableTime);
+                    metrics.phases.emplace_back("execute", execute);
+                    metrics.phases.emplace_back("qasm", result.qasmTime);
+                    metrics.shotsRun = result.shotsRun;
+                    metrics.gates = result.gatesApplied;
+                    metrics.peakStateBytes = result.peakStateBytes;
+                    if (run.wallSeconds > 0.0)
+                        metrics.shotsPerSecond = result.shotsRun / run.wallSeconds;
+                };
+                // 130 when Ctrl-C cut the run short, as for a shell job.
+                int status = 0;
+                // Every successful run ends here, writing --metrics last so
+                // the write phase covers the QASM file and printed results.
+                auto finish = [&]() {
+                    endPhase("write");
+                    if (timeline)
+                        timeline->finish();
+                    if (settings.metricsPath.empty())
+                        return status;
+                    metrics.peakResidentBytes = peakResidentBytes();
+                    std::ofstream out(settings.metricsPath);
+                    writeMetrics(out, metrics);
+                    if (!out)
+                        throw bloch::support::BlochError(
+                            bloch::support::ErrorCategory::Runtime, 0, 0,
+                            "cannot write metrics '" + settings.metricsPath + "'");
+                    return status;
+                };
+                endPhase("plan");
                 std::string qasm;
                 if (shotsProvided) {
                     // Multi-shot execution: aggregate tracked values and report a summary.
-                    std::unordered_map<std::string, std::unordered_map<std::string, int>> aggregate;
                     auto start = std::chrono::steady_clock::now();
-                    for (int s = 0; s < shots; ++s) {
-                        bloch::runtime::RuntimeEvaluator evaluator(s == shots - 1);
-                        evaluator.setEcho(echoAll);
-                        // Suppress per-shot warnings; only show for last shot
-                        if (s < shots - 1)
-                            evaluator.setWarnOnExit(false);
-                        evaluator.execute(*program);
-                        if (s == shots - 1)
-                            qasm = evaluator.getQasm();
-                        for (const auto& vk : evaluator.trackedCounts())
-                            for (const auto& vv : vk.second)
-                                aggregate[vk.first][vv.first] += vv.second;
+                    shotOptions.shots = shots;
+                    shotOptions.ciWidth = ciWidth;
+                    if (settings.shardCount > 0) {
+                        shotOptions.shard = settings.shard;
+                        shotOptions.shardCount = settings.shardCount;
+                    }
+                    std::unique_ptr<bloch::runtime::ShotProgress> progress;
+                    if (stderrIsTerminal()) {
+                        long long budget = shots;
+                        if (settings.shardCount > 0)
+                            budget = budget * (settings.shard + 1) / settings.shardCount -
+                                     budget * settings.shard / settings.shardCount;
+                        progress = std::make_unique<bloch::runtime::ShotProgress>(
+                            std::cerr, static_cast<int>(budget));
+                        shotOptions.progress = progress.get();
+                    }
+                    shotOptions.stop = &g_stopShots;
+                    bloch::runtime::ShotResult result;
+                    {
+                        InterruptGuard interrupts;
+                        result = bloch::runtime::runShots(*program, shotOptions);
+                    }
+                    if (progress)
+                        progress->finish();
+                    recordRun(result);
+                    qasm = result.qasm;
+                    reportCircuit(result);
+                    if (result.interrupted) {
+                        status = 130;
+                        bloch::support::blochWarning(
+                            0, 0,
+                            "interrupted after " + std::to_string(result.shotsRun) + " shots; " +
+                                "results and QASM cover the shots that finished");
                     }
+                    if (!settings.recordTracePath.empty())
+                        trace.save(settings.recordTracePath);
+                    if (shotLog)
+                        shotLog->finish();
+                    auto& aggregate = result.trackedCounts;
                     auto end = std::chrono::steady_clock::now();
                     double elapsed =
                         std::chrono::duration_cast<std::chrono::duration<double>>(end - start)
                             .count();
-                    std::string base = file.substr(0, file.find_last_of('.'));
+                    std::string base = settings.file.substr(0, settings.file.find_last_of('.'));
                     std::ofstream qfile(base + ".qasm");
                     qfile << qasm;
                     qfile.close();
+                    reportProfile(base);
+
+                    if (settings.shardCount > 0) {
+                        // A shard's counts are only a sample once merged with
+                        // the others, so save them instead of printing a table.
+                        bloch::runtime::PartialResult partial;
+                        partial.seed = result.seed;
+                        partial.totalShots = shots;
+                        partial.shardCount = settings.shardCount;
+                        partial.shard = settings.shard;
+                        partial.shotsRun = result.shotsRun;
+                        partial.trackedCounts = std::move(aggregate);
+                        std::string partialPath =
+                            base + ".shard-" + std::to_string(settings.shard) + "-of-" +
+                            std::to_string(settings.shardCount) + ".partial";
+                        partial.save(partialPath);
+                        std::cout << "Shard: " << settings.shard << " of " << settings.shardCount
+                                  << " (" << partial.shotsRun << " of " << shots << " shots)\n";
+                        std::cout << "Backend: Bloch Ideal Simulator\n";
+                        std::cout << std::fixed << std::setprecision(3);
+                        std::cout << "Elapsed: " << elapsed << "s\n";
+                        std::cout << "Wrote " << partialPath
+                                  << "; combine the shards with 'bloch merge'\n";
+                        if (settings.emitQasm)
+                            std::cout << qasm;
+                        return finish();
+                    }
 
                     // Warn if nothing was tracked, but still print run header and timing
                     if (aggregate.empty())
                         bloch::support::blochWarning(
                             0, 0, "No tracked variables. Use @tracked to collect statistics.");
 
-                    std::cout << "Shots: " << shots << "\n";
+                    int shotsRun = result.shotsRun;
+                    RunSummary summary;
+                    summary.shots = shots;
+                    summary.shotsRun = shotsRun;
+                    summary.seed = result.seed;
+                    summary.elapsedSeconds = elapsed;
+                    std::ostringstream precision;
+                    if (ciWidth > 0.0) {
+                        precision << std::fixed << std::setprecision(4) << result.widestInterval
+                                  << " (target " << ciWidth << ")";
+                        if (result.widestInterval > ciWidth && !result.interrupted)
+                            bloch::support::blochWarning(
+                                0, 0,
+                                "--ci-width not met after " + std::to_string(shotsRun) +
+                                    " shots; widest 95% interval " + precision.str());
+                        if (result.widestInterval >= 0.0)
+                            summary.widestInterval = result.widestInterval;
+                    }
+                    if (settings.output != OutputFormat::Table) {
+                        if (settings.emitQasm)
+                            summary.qasm = &qasm;
+                        writeResult(std::cout, settings.output, summary, aggregate);
+                        return finish();
+                    }
+                    if (ciWidth > 0.0 || result.interrupted) {
+                        std::cout << "Shots: " << shotsRun << " of " << shots << "\n";
+                        if (ciWidth > 0.0 && result.widestInterval >= 0.0 &&
+                            result.widestInterval <= ciWidth)
+                            std::cout << "Precision: widest 95% interval " << precision.str()
+                                      << "\n";
+                    } else {
+                        std::cout << "Shots: " << shots << "\n";
+                    }
                     std::cout << "Backend: Bloch Ideal Simulator\n";
                     std::cout << std::fixed << std::setprecision(3);
                     std::cout << "Elapsed: " << elapsed << "s\n\n";
 
-                    if (!aggregate.empty()) {
-                        for (auto& var : aggregate) {
-                            // Header: e.g., "qubit q" or "qubit[] qreg"
-                            std::cout << var.first << "\n";
-                            std::vector<std::pair<std::string, int>> vals(var.second.begin(),
-                                                                          var.second.end());
-                            auto isBinary = [](const std::string& s) {
-                                return !s.empty() && s.find_first_not_of("01") == std::string::npos;
-                            };
-                            std::stable_sort(
-                                vals.begin(), vals.end(), [&](const auto& a, const auto& b) {
-                                    bool ab = isBinary(a.first);
-                                    bool bb = isBinary(b.first);
-                                    if (ab != bb)
-                                        return ab;  // binary outcomes first; e.g., place '?' at end
-                                    if (!ab && !bb)
-                                        return a.first < b.first;
-                                    // Both binary: compare as integers, prefer shorter width first
-                                    if (a.first.size() != b.first.size())
-                                        return a.first.size() < b.first.size();
-                                    return std::stoi(a.first, nullptr, 2) <
-                                           std::stoi(b.first, nullptr, 2);
-                                });
-                            // Dynamic column sizing for outcome strings
-                            size_t outcomeWidth = 7;
-                            for (const auto& p : vals)
-                                outcomeWidth = std::max(outcomeWidth, p.first.size());
-                            std::cout << std::left << std::setw(static_cast<int>(outcomeWidth))
-                                      << "outcome"
-                                      << " | " << std::right << std::setw(5) << "count"
-                                      << " | " << std::setw(5) << "prob"
-                                      << "\n";
-                            std::cout << std::string(outcomeWidth, '-') << "-+-------+-----\n";
-                            for (auto& p : vals) {
-                                double prob = static_cast<double>(p.second) / shots;
-                                std::cout << std::left << std::setw(static_cast<int>(outcomeWidth))
-                                          << p.first << " | " << std::right << std::setw(5)
-                                          << p.second << " | " << std::setw(5) << prob << "\n";
-                            }
-                            std::cout << "\n";
-                        }
-                    }
-                    if (emitQasm) {
+                    writeResult(std::cout, OutputFormat::Table, summary, aggregate);
+                    if (settings.emitQasm)
                         std::cout << qasm;
-                        return 0;
-                    }
                 } else {
-                    bloch::runtime::RuntimeEvaluator evaluator;
-                    evaluator.setEcho(echoAll);
-                    evaluator.execute(*program);
-                    qasm = evaluator.getQasm();
-                    std::string base = file.substr(0, file.find_last_of('.'));
+                    bloch::runtime::ShotResult result =
+                        bloch::runtime::runShots(*program, shotOptions);
+                    recordRun(result);
+                    qasm = result.qasm;
+                    reportCircuit(result);
+                    if (!settings.recordTracePath.empty())
+                        trace.save(settings.recordTracePath);
+                    if (shotLog)
+                        shotLog->finish();
+                    std::string base = settings.file.substr(0, settings.file.find_last_of('.'));
                     std::ofstream qfile(base + ".qasm");
                     qfile << qasm;
                     qfile.close();
-                    if (emitQasm) {
+                    reportProfile(base);
+                    if (settings.emitQasm)
                         std::cout << qasm;
-                        return 0;
-                    }
                 }
+                return finish();
             } catch (const std::exception& ex) {
                 // Print a clear stop message, then the actual error
                 std::cerr << bloch::support::format(bloch::support::MessageLevel::Error, 0, 0,
@@ -369,7 +767,232 @@ namespace bloch::cli {
                 std::cerr << ex.what() << std::endl;
                 return 1;
             }
-            return 0;
+        }
+
+        // --watch: runs settings.file, then again whenever a module it loaded
+        // changes, until interrupted. Unchanged modules keep their parsed ASTs
+        // between runs, so only edited files are read, lexed and parsed again.
+        int watchProgram(const RunSettings& settings,
+                         const std::vector<std::string>& stdlibPaths) {
+            auto cache = std::make_shared<bloch::compiler::ModuleCache>();
+            while (true) {
+                bloch::compiler::ModuleLoader loader(stdlibPaths, cache);
+                runProgram(settings, loader);
+                std::vector<std::string> files = loader.modules();
+                if (files.empty())
+                    files.push_back(std::filesystem::absolute(settings.file).string());
+                // Watch first, then look for saves made while the program ran;
+                // a save after this point reaches the watcher instead.
+                FileWatcher watcher(files);
+                auto stale = std::find_if(files.begin(), files.end(), [&](const auto& file) {
+                    return cache->changed(file);
+                });
+                if (stale != files.end()) {
+                    bloch::support::blochInfo(0, 0, *stale + " changed; running again");
+                    continue;
+                }
+                std::cout.flush();
+                bloch::support::blochInfo(0, 0,
+                                          "watching " + std::to_string(files.size()) +
+                                              " file(s) for changes; press Ctrl-C to stop");
+                std::optional<std::string> changed = watcher.waitForChange();
+                if (!changed)
+                    return 0;
+                bloch::support::blochInfo(0, 0, *changed + " changed; running again");
+            }
+        }
+
+        int runImpl(int argc, char** argv, const Context& ctx) {
+            const std::string version(ctx.version);
+            if (argc < 2) {
+                std::cerr << "Usage: bloch [options] <file.bloch> (use --help for details)\n";
+                return 1;
+            }
+            if (argv[1] == kCommandMerge)
+                return runMerge(argc, argv);
+            if (argv[1] == kCommandBatch)
+                return runBatch(argc, argv, resolveStdlibSearchPaths(ctx, argv[0]));
+            if (argv[1] == kCommandServe)
+                return runServe(argc, argv, resolveStdlibSearchPaths(ctx, argv[0]));
+            if (argv[1] == kCommandBench)
+                return runBench(argc, argv, resolveStdlibSearchPaths(ctx, argv[0]));
+
+            RunSettings settings;
+            bool watch = false;
+
+            for (int i = 1; i < argc; ++i) {
+                std::string arg = argv[i];
+                if (arg == kFlagHelp) {
+                    printHelp(ctx);
+                    return 0;
+                } else if (arg == kFlagVersion) {
+                    printVersion(ctx);
+                    bloch::update::checkForUpdatesIfDue(version);
+                    return 0;
+                } else if (arg == kFlagUpdate) {
+                    return bloch::update::performSelfUpdate(version, argv[0]) ? 0 : 1;
+                } else if (arg == kFlagEmitQasm) {
+                    settings.emitQasm = true;
+                } else if (arg == kFlagEmitOnly) {
+                    settings.emitOnly = true;
+                } else if (arg == kFlagEstimate) {
+                    settings.estimate = true;
+                } else if (arg == kFlagWatch) {
+                    watch = true;
+                } else if (arg.rfind(kFlagRecordTracePrefix, 0) == 0) {
+                    settings.recordTracePath = arg.substr(kFlagRecordTracePrefix.size());
+                } else if (arg.rfind(kFlagReplayTracePrefix, 0) == 0) {
+                    settings.replayTracePath = arg.substr(kFlagReplayTracePrefix.size());
+                } else if (arg.rfind(kFlagShotsPrefix, 0) == 0) {
+                    settings.isCliShots = true;
+                    settings.cliShots = std::stoi(arg.substr(kFlagShotsPrefix.size()));
+                    if (settings.cliShots <= 0) {
+                        std::cerr << "--shots must be positive\n";
+                        return 1;
+                    }
+                } else if (arg.rfind(kFlagCiWidthPrefix, 0) == 0) {
+                    std::string width = arg.substr(kFlagCiWidthPrefix.size());
+                    size_t used = 0;
+                    try {
+                        settings.ciWidth = std::stod(width, &used);
+                    } catch (const std::exception&) {
+                        used = 0;
+                    }
+                    if (used != width.size() ||
+                        !(settings.ciWidth > 0.0 && settings.ciWidth < 1.0)) {
+                        std::cerr << "--ci-width must be a number between 0 and 1\n";
+                        return 1;
+                    }
+                } else if (arg.rfind(kFlagSeedPrefix, 0) == 0) {
+                    std::string value = arg.substr(kFlagSeedPrefix.size());
+                    size_t used = 0;
+                    try {
+                        if (value.find_first_not_of("0123456789") == std::string::npos)
+                            settings.seed = std::stoull(value, &used);
+                    } catch (const std::exception&) {
+                        used = 0;
+                    }
+                    if (value.empty() || used != value.size()) {
+                        std::cerr << "--seed must be a non-negative integer\n";
+                        return 1;
+                    }
+                } else if (arg.rfind(kFlagShardPrefix, 0) == 0) {
+                    std::string value = arg.substr(kFlagShardPrefix.size());
+                    size_t slash = value.find('/');
+                    bool valid = slash != std::string::npos && slash > 0 &&
+                                 slash + 1 < value.size() &&
+                                 value.find_first_not_of("0123456789/") == std::string::npos &&
+                                 value.find('/', slash + 1) == std::string::npos;
+                    if (valid) {
+                        try {
+                            settings.shard = std::stoi(value.substr(0, slash));
+                            settings.shardCount = std::stoi(value.substr(slash + 1));
+                        } catch (const std::exception&) {
+                            valid = false;
+                        }
+                    }
+                    if (!valid || settings.shardCount <= 0 ||
+                        settings.shard >= settings.shardCount) {
+                        std::cerr << "--shard must be I/N with 0 <= I < N\n";
+                        return 1;
+                    }
+                } else if (arg.rfind(kFlagOutputPrefix, 0) == 0) {
+                    auto format = parseOutputFormat(arg.substr(kFlagOutputPrefix.size()));
+                    if (!format) {
+                        std::cerr << "--output must be table, json, csv or bin\n";
+                        return 1;
+                    }
+                    settings.output = *format;
+                } else if (arg.rfind(kFlagShotLogPrefix, 0) == 0) {
+                    settings.shotLogPath = arg.substr(kFlagShotLogPrefix.size());
+                } else if (arg == kFlagProfile) {
+                    settings.profile = bloch::runtime::Profiler::Mode::Instrumented;
+                } else if (arg.rfind(kFlagProfilePrefix, 0) == 0) {
+                    if (arg.substr(kFlagProfilePrefix.size()) != "sample") {
+                        std::cerr << "--profile takes no value or =sample\n";
+                        return 1;
+                    }
+                    settings.profile = bloch::runtime::Profiler::Mode::Sampled;
+                } else if (arg.rfind(kFlagMetricsPrefix, 0) == 0) {
+                    settings.metricsPath = arg.substr(kFlagMetricsPrefix.size());
+                } else if (arg.rfind(kFlagTracePrefix, 0) == 0) {
+                    settings.tracePath = arg.substr(kFlagTracePrefix.size());
+                } else if (arg.rfind(kFlagEchoPrefix, 0) == 0) {
+                    settings.echoOpt = arg.substr(kFlagEchoPrefix.size());
+                } else if (arg.rfind(kFlagOptLevelPrefix, 0) == 0) {
+                    std::string level = arg.substr(kFlagOptLevelPrefix.size());
+                    if (level != "0" && level != "1" && level != "2") {
+                        std::cerr << "--opt-level must be 0, 1 or 2\n";
+                        return 1;
+                    }
+                    settings.optLevel = level[0] - '0';
+                } else {
+                    settings.file = arg;
+                }
+            }
+            if (settings.file.empty()) {
+                std::cerr << "No input file provided (use --help for usage)\n";
+                return 1;
+            }
+            if (!settings.recordTracePath.empty() && !settings.replayTracePath.empty()) {
+                std::cerr << "--record-trace and --replay-trace cannot be combined\n";
+                return 1;
+            }
+            if (settings.emitOnly &&
+                (!settings.recordTracePath.empty() || !settings.replayTracePath.empty())) {
+                std::cerr << "--emit-only cannot be combined with measurement traces\n";
+                return 1;
+            }
+            if (!settings.shotLogPath.empty() && (settings.emitOnly || settings.estimate)) {
+                std::cerr << "--shot-log cannot be combined with --emit-only or --estimate\n";
+                return 1;
+            }
+            bool instrumented =
+                settings.profile || !settings.metricsPath.empty() || !settings.tracePath.empty();
+            if (instrumented && settings.estimate) {
+                std::cerr << "--profile, --metrics and --trace cannot be combined with "
+                             "--estimate\n";
+                return 1;
+            }
+            if (settings.ciWidth > 0.0 && !settings.replayTracePath.empty()) {
+                std::cerr << "--ci-width cannot be combined with --replay-trace\n";
+                return 1;
+            }
+            if (settings.shardCount > 0) {
+                if (!settings.seed) {
+                    std::cerr << "--shard needs --seed=S so every shard samples the same run\n";
+                    return 1;
+                }
+                if (settings.emitOnly || settings.estimate || settings.ciWidth > 0.0 ||
+                    !settings.recordTracePath.empty() || !settings.replayTracePath.empty()) {
+                    std::cerr << "--shard cannot be combined with --emit-only, --estimate, "
+                                 "--ci-width or measurement traces\n";
+                    return 1;
+                }
+            }
+
+            if (settings.output != OutputFormat::Table) {
+                // Anything else on stdout would corrupt the result.
+                if (settings.estimate || settings.emitOnly || settings.shardCount > 0 ||
+                    settings.echoOpt == "all") {
+                    std::cerr << "--output cannot be combined with --estimate, --emit-only, "
+                                 "--shard or --echo=all\n";
+                    return 1;
+                }
+                if (settings.emitQasm && settings.output != OutputFormat::Json) {
+                    std::cerr << "--emit-qasm needs --output=table or --output=json\n";
+                    return 1;
+                }
+            }
+
+            // Run a non-blocking update check at most once every 72 hours.
+            bloch::update::checkForUpdatesIfDue(version);
+
+            auto stdlibPaths = resolveStdlibSearchPaths(ctx, argc > 0 ? argv[0] : nullptr);
+            if (watch)
+                return watchProgram(settings, stdlibPaths);
+            bloch::compiler::ModuleLoader loader(stdlibPaths);
+            return runProgram(settings, loader);
         }
 
     }  // namespace
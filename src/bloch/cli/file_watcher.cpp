@@ -0,0 +1,169 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bloch/cli/file_watcher.hpp"
+
+#include <algorithm>
+#include <thread>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace bloch::cli {
+    namespace {
+        namespace fs = std::filesystem;
+        using Clock = std::chrono::steady_clock;
+
+        constexpr int kPollIntervalMs = 200;
+        // Editors often write a file in several steps; wait this long after
+        // the last event before reporting a change.
+        constexpr int kSettleMs = 50;
+
+        bool isSource(const std::string& name) {
+            return name.size() > 6 && name.compare(name.size() - 6, 6, ".bloch") == 0;
+        }
+    }  // namespace
+
+    FileWatcher::FileWatcher(const std::vector<std::string>& files) : m_files(files) {
+        for (const auto& file : m_files) {
+            std::string dir = fs::path(file).parent_path().string();
+            if (std::find(m_directories.begin(), m_directories.end(), dir) == m_directories.end())
+                m_directories.push_back(dir);
+        }
+#if defined(__linux__)
+        m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (m_inotify >= 0) {
+            for (const auto& dir : m_directories) {
+                int wd = inotify_add_watch(m_inotify, dir.c_str(),
+                                           IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE);
+                if (wd >= 0)
+                    m_watches[wd] = dir;
+            }
+            if (!m_watches.empty())
+                return;
+            close(m_inotify);
+            m_inotify = -1;
+        }
+#endif
+        for (const auto& file : m_files) m_stamps[file] = stampOf(file);
+        for (const auto& dir : m_directories) {
+            std::error_code ec;
+            for (const auto& entry : fs::directory_iterator(dir, ec)) {
+                std::string path = entry.path().string();
+                if (isSource(path))
+                    m_stamps.emplace(path, stampOf(path));
+            }
+        }
+    }
+
+    FileWatcher::~FileWatcher() {
+#if defined(__linux__)
+        if (m_inotify >= 0)
+            close(m_inotify);
+#endif
+    }
+
+    FileWatcher::Stamp FileWatcher::stampOf(const std::string& path) {
+        Stamp stamp;
+        std::error_code timeError;
+        std::error_code sizeError;
+        stamp.modified = fs::last_write_time(path, timeError);
+        stamp.size = fs::file_size(path, sizeError);
+        stamp.exists = !timeError && !sizeError;
+        return stamp;
+    }
+
+    std::optional<std::string> FileWatcher::pollOnce() {
+        auto changed = [](const Stamp& a, const Stamp& b) {
+            return a.exists != b.exists || a.modified != b.modified || a.size != b.size;
+        };
+        for (auto& [path, stamp] : m_stamps) {
+            Stamp now = stampOf(path);
+            if (changed(now, stamp)) {
+                stamp = now;
+                return path;
+            }
+        }
+        for (const auto& dir : m_directories) {
+            std::error_code ec;
+            for (const auto& entry : fs::directory_iterator(dir, ec)) {
+                std::string path = entry.path().string();
+                if (isSource(path) && !m_stamps.count(path)) {
+                    m_stamps.emplace(path, stampOf(path));
+                    return path;
+                }
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<std::string> FileWatcher::readEvents(int waitMs) {
+#if defined(__linux__)
+        pollfd fd{m_inotify, POLLIN, 0};
+        if (poll(&fd, 1, waitMs) <= 0)
+            return std::nullopt;
+        alignas(inotify_event) char buffer[4096];
+        std::optional<std::string> changed;
+        ssize_t length;
+        while ((length = read(m_inotify, buffer, sizeof buffer)) > 0) {
+            for (char* at = buffer; at < buffer + length;) {
+                const auto* event = reinterpret_cast<const inotify_event*>(at);
+                at += sizeof(inotify_event) + event->len;
+                std::string name = event->len ? event->name : "";
+                auto dir = m_watches.find(event->wd);
+                if (!changed && dir != m_watches.end() && isSource(name))
+                    changed = (fs::path(dir->second) / name).string();
+            }
+        }
+        return changed;
+#else
+        (void)waitMs;
+        return std::nullopt;
+#endif
+    }
+
+    std::optional<std::string> FileWatcher::waitForChange(std::chrono::milliseconds timeout) {
+        auto deadline = timeout == std::chrono::milliseconds::max() ? Clock::time_point::max()
+                                                                    : Clock::now() + timeout;
+        std::optional<std::string> changed;
+        while (!changed) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::min(deadline, Clock::now()));
+            if (left.count() <= 0)
+                return std::nullopt;
+            int waitMs = static_cast<int>(std::min<long long>(left.count(), kPollIntervalMs));
+            if (m_inotify >= 0) {
+                changed = readEvents(waitMs);
+            } else {
+                changed = pollOnce();
+                if (!changed)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(waitMs));
+            }
+        }
+        // Swallow the rest of a multi-step save.
+        if (m_inotify >= 0) {
+            while (readEvents(kSettleMs)) {
+            }
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(kSettleMs));
+            while (pollOnce()) {
+            }
+        }
+        return changed;
+    }
+
+}  // namespace bloch::cli
@@ -0,0 +1,60 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace bloch::cli {
+
+    // Waits for a `.bloch` file in the directories of `files` to be written,
+    // created or removed, which also catches an import that did not exist
+    // yet. Uses inotify on Linux and polls modification times elsewhere.
+    class FileWatcher {
+       public:
+        explicit FileWatcher(const std::vector<std::string>& files);
+        ~FileWatcher();
+        FileWatcher(const FileWatcher&) = delete;
+        FileWatcher& operator=(const FileWatcher&) = delete;
+
+        // Path of the first file to change, once writes to it have settled,
+        // or nullopt after `timeout`.
+        std::optional<std::string> waitForChange(
+            std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+       private:
+        struct Stamp {
+            std::filesystem::file_time_type modified;
+            std::uintmax_t size = 0;
+            bool exists = false;
+        };
+
+        std::vector<std::string> m_files;
+        std::vector<std::string> m_directories;
+        std::unordered_map<std::string, Stamp> m_stamps;  // polling only
+        int m_inotify = -1;
+        std::unordered_map<int, std::string> m_watches;  // descriptor -> directory
+
+        static Stamp stampOf(const std::string& path);
+        std::optional<std::string> pollOnce();
+        std::optional<std::string> readEvents(int waitMs);
+    };
+
+}  // namespace bloch::cli
@@ -0,0 +1,208 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bloch/cli/program_job.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "bloch/cli/records.hpp"
+#include "bloch/compiler/analysis/feedback_analysis.hpp"
+#include "bloch/compiler/optimiser/optimiser.hpp"
+#include "bloch/compiler/semantics/semantic_analyser.hpp"
+#include "bloch/runtime/shot_runner.hpp"
+#include "bloch/support/error/bloch_error.hpp"
+#include "bloch/support/json.hpp"
+
+namespace bloch::cli {
+    namespace {
+        // Parses the whole of `text` as a number, or returns nullopt.
+        template <typename T, typename Parse>
+        std::optional<T> parseNumber(const std::string& text, Parse parse) {
+            size_t used = 0;
+            try {
+                T value = parse(text, &used);
+                if (used == text.size())
+                    return value;
+            } catch (const std::exception&) {
+            }
+            return std::nullopt;
+        }
+    }  // namespace
+
+    std::unique_ptr<compiler::Program> compileProgram(const ProgramJob& job,
+                                                      const JobEnvironment& env,
+                                                      std::vector<std::string>* modules) {
+        compiler::ModuleLoader loader(env.stdlibPaths, env.modules);
+        std::unique_ptr<compiler::Program> program =
+            job.source ? loader.loadSource(job.file, *job.source) : loader.load(job.file);
+        if (modules)
+            *modules = loader.modules();
+        compiler::SemanticAnalyser analyser;
+        analyser.analyse(*program);
+        if (job.optLevel >= 1) {
+            compiler::Optimiser optimiser;
+            optimiser.optimise(*program);
+        }
+        return program;
+    }
+
+    std::string applyJobOption(ProgramJob& job, const std::string& option) {
+        auto valueOf = [&](std::string_view flag) -> std::optional<std::string> {
+            if (option.rfind(flag, 0) != 0)
+                return std::nullopt;
+            return option.substr(flag.size());
+        };
+        if (auto value = valueOf("--shots=")) {
+            job.shots = parseNumber<int>(
+                *value, [](const std::string& s, size_t* used) { return std::stoi(s, used); });
+            if (!job.shots || *job.shots <= 0)
+                return "--shots must be positive";
+        } else if (auto value = valueOf("--opt-level=")) {
+            if (*value != "0" && *value != "1" && *value != "2")
+                return "--opt-level must be 0, 1 or 2";
+            job.optLevel = (*value)[0] - '0';
+        } else if (auto value = valueOf("--seed=")) {
+            if (!value->empty() && value->find_first_not_of("0123456789") == std::string::npos)
+                job.seed = parseNumber<std::uint64_t>(
+                    *value,
+                    [](const std::string& s, size_t* used) { return std::stoull(s, used); });
+            if (!job.seed)
+                return "--seed must be a non-negative integer";
+        } else if (auto value = valueOf("--ci-width=")) {
+            auto width = parseNumber<double>(
+                *value, [](const std::string& s, size_t* used) { return std::stod(s, used); });
+            if (!width || !(*width > 0.0 && *width < 1.0))
+                return "--ci-width must be a number between 0 and 1";
+            job.ciWidth = *width;
+        } else if (option == "--emit-only") {
+            job.emitOnly = true;
+        } else if (option == "--emit-qasm") {
+            job.emitQasm = true;
+        } else {
+            return "unsupported option '" + option + "'";
+        }
+        return "";
+    }
+
+    CachedProgram ProgramCache::take(const std::string& key) {
+        CachedProgram cached;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (auto it = m_idle.begin(); it != m_idle.end(); ++it) {
+                if (it->first == key) {
+                    cached = std::move(it->second);
+                    m_idle.erase(it);
+                    break;
+                }
+            }
+        }
+        // Stat the modules outside the lock; the program is ours now.
+        for (const auto& [path, stamp] : cached.modules) {
+            if (compiler::fileStamp(path) != stamp)
+                return {};
+        }
+        return cached;
+    }
+
+    void ProgramCache::put(const std::string& key, CachedProgram program) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_idle.emplace_front(key, std::move(program));
+        if (m_idle.size() > m_capacity)
+            m_idle.pop_back();
+    }
+
+    size_t ProgramCache::size() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_idle.size();
+    }
+
+    JobResult runJob(const ProgramJob& job, const JobEnvironment& env) {
+        try {
+            auto start = std::chrono::steady_clock::now();
+            // Only in-memory sources are cached: the entry file may change
+            // between runs. Imported modules may too, so a cached program is
+            // reused only while every module it loaded has the same stamp.
+            std::string key;
+            CachedProgram compiled;
+            bool cached = false;
+            if (job.source && env.programs) {
+                key = std::to_string(job.optLevel) + "\n" + job.file + "\n" + *job.source;
+                compiled = env.programs->take(key);
+                cached = compiled.program != nullptr;
+            }
+            if (!compiled.program) {
+                std::vector<std::string> modules;
+                compiled.program = compileProgram(job, env, key.empty() ? nullptr : &modules);
+                for (const auto& path : modules)
+                    compiled.modules.emplace_back(path, compiler::fileStamp(path));
+            }
+            compiler::Program* program = compiled.program.get();
+
+            // As in single runs, @shots(N) wins over --shots.
+            int shots = program->shots.first ? program->shots.second : job.shots.value_or(1);
+            if (job.emitOnly) {
+                auto feedback = compiler::analyseFeedback(*program);
+                if (!feedback.feedbackFree)
+                    throw support::BlochError(
+                        support::ErrorCategory::Semantic, feedback.line, feedback.column,
+                        "--emit-only cannot run this program: " + feedback.reason);
+                shots = 1;
+            }
+            runtime::ShotOptions options;
+            options.shots = shots;
+            options.echo = false;
+            options.warnings = false;
+            options.simulate = !job.emitOnly;
+            options.circuitOptimisation = job.optLevel >= 2;
+            options.seed = job.seed;
+            if (shots > 1)
+                options.ciWidth = job.ciWidth;
+            runtime::planShots(*program, job.optLevel, options);
+            runtime::ShotResult result = runtime::runShots(*program, options);
+            if (!key.empty())
+                env.programs->put(key, std::move(compiled));
+
+            if (job.writeQasm) {
+                // The same program may be listed twice with different options.
+                static std::mutex qasmMutex;
+                std::lock_guard<std::mutex> lock(qasmMutex);
+                std::ofstream qfile(job.file.substr(0, job.file.find_last_of('.')) + ".qasm");
+                qfile << result.qasm;
+            }
+            double elapsed = std::chrono::duration<double, std::milli>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count();
+
+            std::ostringstream out;
+            out << "\"status\":\"ok\",\"shots\":" << shots << ",\"shotsRun\":" << result.shotsRun
+                << ",\"seed\":" << result.seed;
+            if (env.programs)
+                out << ",\"cached\":" << (cached ? "true" : "false");
+            out << ",\"elapsedMs\":" << std::fixed << std::setprecision(3) << elapsed;
+            if (options.ciWidth > 0.0 && result.widestInterval >= 0.0)
+                out << ",\"widestInterval\":" << std::setprecision(6) << result.widestInterval;
+            if (!job.emitOnly)
+                out << ",\"tracked\":" << trackedCountsJson(result.trackedCounts);
+            if (job.emitQasm)
+                out << ",\"qasm\":" << support::jsonString(result.qasm);
+            return {true, out.str()};
+        } catch (const std::exception& ex) {
+            return {false, "\"status\":\"error\",\"error\":" + errorJson(ex)};
+        }
+    }
+
+}  // namespace bloch::cli
@@ -0,0 +1,100 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bloch/compiler/ast/ast.hpp"
+#include "bloch/compiler/import/module_loader.hpp"
+
+namespace bloch::cli {
+
+    // One program run as `bloch batch` and `bloch serve` describe it: the
+    // single-run pipeline with a subset of the CLI's options and no echo.
+    struct ProgramJob {
+        std::string label;  // how records name the program
+        std::string file;   // locates imports, and is read unless `source` is set
+        std::optional<std::string> source;
+        std::optional<int> shots;
+        int optLevel = 1;
+        std::optional<std::uint64_t> seed;
+        double ciWidth = 0.0;
+        bool emitOnly = false;
+        bool emitQasm = false;  // include the QASM in the record
+        bool writeQasm = true;  // write <file>.qasm next to the program
+    };
+
+    // Applies one of --shots=N, --opt-level=0|1|2, --seed=S, --ci-width=W,
+    // --emit-only or --emit-qasm to `job`. Returns why the option was
+    // rejected, or an empty string.
+    std::string applyJobOption(ProgramJob& job, const std::string& option);
+
+    // A compiled program and every module file it was loaded from, stamped
+    // as they were when it was compiled.
+    struct CachedProgram {
+        std::unique_ptr<compiler::Program> program;
+        std::vector<std::pair<std::string, compiler::FileStamp>> modules;
+    };
+
+    // Compiled programs kept between runs of the same source. A program is
+    // handed to one run at a time: take() removes it and put() returns it,
+    // dropping the least recently returned once `capacity` are held.
+    class ProgramCache {
+       public:
+        explicit ProgramCache(size_t capacity) : m_capacity(capacity) {}
+
+        // The program is null when none is idle under `key`, or when one of
+        // its modules has changed since; a stale program is dropped.
+        CachedProgram take(const std::string& key);
+        void put(const std::string& key, CachedProgram program);
+        size_t size() const;
+
+       private:
+        size_t m_capacity;
+        mutable std::mutex m_mutex;
+        std::list<std::pair<std::string, CachedProgram>> m_idle;
+    };
+
+    // What jobs share: stdlib search paths, parsed module files and, for jobs
+    // with a `source`, compiled programs.
+    struct JobEnvironment {
+        std::vector<std::string> stdlibPaths;
+        std::shared_ptr<compiler::ModuleCache> modules;
+        ProgramCache* programs = nullptr;
+    };
+
+    struct JobResult {
+        bool ok = false;
+        // The record's fields from "status" on, without braces, so callers
+        // can put their own fields first.
+        std::string fields;
+    };
+
+    // Loads, analyses and (at job.optLevel >= 1) optimises the job's program.
+    // With `modules`, also stores the canonical paths of the files it loaded.
+    std::unique_ptr<compiler::Program> compileProgram(const ProgramJob& job,
+                                                      const JobEnvironment& env,
+                                                      std::vector<std::string>* modules = nullptr);
+
+    JobResult runJob(const ProgramJob& job, const JobEnvironment& env);
+
+}  // namespace bloch::cli
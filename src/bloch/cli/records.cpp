@@ -0,0 +1,63 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bloch/cli/records.hpp"
+
+#include <map>
+#include <sstream>
+
+#include "bloch/support/error/bloch_error.hpp"
+#include "bloch/support/json.hpp"
+
+namespace bloch::cli {
+
+    using support::jsonString;
+
+    std::string trackedCountsJson(const bloch::runtime::TrackedCounts& counts) {
+        std::map<std::string, std::map<std::string, int>> sorted;
+        for (const auto& var : counts)
+            sorted[var.first].insert(var.second.begin(), var.second.end());
+        std::ostringstream out;
+        out << "{";
+        bool firstVar = true;
+        for (const auto& var : sorted) {
+            out << (firstVar ? "" : ",") << jsonString(var.first) << ":{";
+            firstVar = false;
+            bool firstOutcome = true;
+            for (const auto& outcome : var.second) {
+                out << (firstOutcome ? "" : ",") << jsonString(outcome.first) << ":"
+                    << outcome.second;
+                firstOutcome = false;
+            }
+            out << "}";
+        }
+        out << "}";
+        return out.str();
+    }
+
+    std::string errorJson(const std::exception& error) {
+        std::ostringstream out;
+        if (const auto* bloch = dynamic_cast<const support::BlochError*>(&error)) {
+            out << "{\"category\":" << jsonString(support::categoryLabel(bloch->category))
+                << ",\"line\":" << bloch->line << ",\"column\":" << bloch->column
+                << ",\"message\":" << jsonString(bloch->message) << "}";
+        } else {
+            out << "{\"category\":" << jsonString(support::categoryLabel(
+                                           support::ErrorCategory::Generic))
+                << ",\"message\":" << jsonString(error.what()) << "}";
+        }
+        return out.str();
+    }
+
+}  // namespace bloch::cli
@@ -0,0 +1,307 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bloch/cli/result_writer.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <map>
+
+#include "bloch/support/json.hpp"
+
+namespace bloch::cli {
+
+    namespace {
+        constexpr char kBinaryMagic[8] = {'B', 'L', 'O', 'C', 'H', 'R', 'E', 'S'};
+        constexpr std::uint32_t kBinaryVersion = 1;
+
+        bool isBits(std::string_view outcome) {
+            return !outcome.empty() && outcome.find_first_not_of("01") == std::string_view::npos;
+        }
+
+        // Collects output in a block of about 64 KiB and hands it to the
+        // stream in one write, instead of formatting field by field.
+        class BufferedWriter {
+           public:
+            explicit BufferedWriter(std::ostream& out) : m_out(out) { m_buffer.reserve(kBlock); }
+            BufferedWriter(const BufferedWriter&) = delete;
+            BufferedWriter& operator=(const BufferedWriter&) = delete;
+            ~BufferedWriter() { flush(); }
+
+            void text(std::string_view value) {
+                if (m_buffer.size() + value.size() > kBlock)
+                    flush();
+                m_buffer.append(value);
+            }
+
+            void pad(size_t count) { text(std::string(count, ' ')); }
+
+            void left(std::string_view value, size_t width) {
+                text(value);
+                if (value.size() < width)
+                    pad(width - value.size());
+            }
+
+            void right(std::string_view value, size_t width) {
+                if (value.size() < width)
+                    pad(width - value.size());
+                text(value);
+            }
+
+            template <typename T>
+            std::string_view format(T value) {
+                auto end = std::to_chars(m_digits, m_digits + sizeof(m_digits), value).ptr;
+                return {m_digits, static_cast<size_t>(end - m_digits)};
+            }
+
+            std::string_view fixed(double value, int precision) {
+                auto end = std::to_chars(m_digits, m_digits + sizeof(m_digits), value,
+                                         std::chars_format::fixed, precision)
+                               .ptr;
+                return {m_digits, static_cast<size_t>(end - m_digits)};
+            }
+
+            // Little-endian, whatever the host.
+            void word(std::uint64_t value, int bytes) {
+                char raw[8];
+                for (int i = 0; i < bytes; ++i) raw[i] = static_cast<char>(value >> (8 * i));
+                text({raw, static_cast<size_t>(bytes)});
+            }
+
+            void flush() {
+                m_out.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+                m_buffer.clear();
+            }
+
+           private:
+            static constexpr size_t kBlock = 64 * 1024;
+            std::ostream& m_out;
+            std::string m_buffer;
+            char m_digits[64];
+        };
+
+        double probability(int count, int shots) {
+            return shots > 0 ? static_cast<double>(count) / shots : 0.0;
+        }
+
+        void writeTable(BufferedWriter& out, const std::vector<OutcomeTable>& tables,
+                        int shots) {
+            for (const auto& table : tables) {
+                out.text(table.name);
+                out.text("\n");
+                size_t width = 7;
+                for (const auto& outcome : table.outcomes)
+                    width = std::max(width, outcome.first.size());
+                out.left("outcome", width);
+                out.text(" | count |  prob\n");
+                out.text(std::string(width, '-'));
+                out.text("-+-------+-----\n");
+                for (const auto& outcome : table.outcomes) {
+                    out.left(outcome.first, width);
+                    out.text(" | ");
+                    out.right(out.format(outcome.second), 5);
+                    out.text(" | ");
+                    out.right(out.fixed(probability(outcome.second, shots), 3), 5);
+                    out.text("\n");
+                }
+                out.text("\n");
+            }
+        }
+
+        void writeJson(BufferedWriter& out, const RunSummary& summary,
+                       const std::vector<OutcomeTable>& tables) {
+            out.text("{\"shots\":");
+            out.text(out.format(summary.shots));
+            out.text(",\"shotsRun\":");
+            out.text(out.format(summary.shotsRun));
+            out.text(",\"seed\":");
+            out.text(out.format(summary.seed));
+            if (summary.elapsedSeconds) {
+                out.text(",\"elapsedMs\":");
+                out.text(out.fixed(*summary.elapsedSeconds * 1000.0, 3));
+            }
+            if (summary.widestInterval) {
+                out.text(",\"widestInterval\":");
+                out.text(out.fixed(*summary.widestInterval, 6));
+            }
+            out.text(",\"tracked\":{");
+            for (size_t t = 0; t < tables.size(); ++t) {
+                out.text(t ? "," : "");
+                out.text(support::jsonString(std::string(tables[t].name)));
+                out.text(":{");
+                bool first = true;
+                for (const auto& outcome : tables[t].outcomes) {
+                    out.text(first ? "\"" : ",\"");
+                    first = false;
+                    // Outcomes are bit strings or "?", so need no escaping.
+                    out.text(outcome.first);
+                    out.text("\":");
+                    out.text(out.format(outcome.second));
+                }
+                out.text("}");
+            }
+            out.text("}");
+            if (summary.qasm) {
+                out.text(",\"qasm\":");
+                out.text(support::jsonString(*summary.qasm));
+            }
+            out.text("}\n");
+        }
+
+        void writeCsv(BufferedWriter& out, const std::vector<OutcomeTable>& tables, int shots) {
+            out.text("variable,outcome,count,probability\n");
+            for (const auto& table : tables) {
+                std::string name(table.name);
+                if (name.find_first_of(",\"\n") != std::string::npos) {
+                    std::string quoted = "\"";
+                    for (char c : name) {
+                        quoted += c;
+                        if (c == '"')
+                            quoted += c;
+                    }
+                    name = quoted + "\"";
+                }
+                for (const auto& outcome : table.outcomes) {
+                    out.text(name);
+                    out.text(",");
+                    out.text(outcome.first);
+                    out.text(",");
+                    out.text(out.format(outcome.second));
+                    out.text(",");
+                    out.text(out.format(probability(outcome.second, shots)));
+                    out.text("\n");
+                }
+            }
+        }
+
+        // Fixed-size, 8-byte aligned records so readers can map the file and
+        // index rows directly. Outcomes that are not bit strings are only
+        // counted, in the table header.
+        void writeBinary(BufferedWriter& out, const RunSummary& summary,
+                         const std::vector<OutcomeTable>& tables) {
+            out.text({kBinaryMagic, sizeof(kBinaryMagic)});
+            out.word(kBinaryVersion, 4);
+            out.word(tables.size(), 4);
+            out.word(static_cast<std::uint64_t>(summary.shots), 8);
+            out.word(static_cast<std::uint64_t>(summary.shotsRun), 8);
+            out.word(summary.seed, 8);
+            for (const auto& table : tables) {
+                size_t width = 0;
+                std::uint64_t rows = 0;
+                std::uint64_t other = 0;
+                for (const auto& outcome : table.outcomes) {
+                    if (isBits(outcome.first)) {
+                        width = std::max(width, outcome.first.size());
+                        ++rows;
+                    } else {
+                        other += static_cast<std::uint64_t>(outcome.second);
+                    }
+                }
+                out.word(table.name.size(), 4);
+                out.word(width, 4);
+                out.word(rows, 8);
+                out.word(other, 8);
+                out.text(table.name);
+                out.pad((8 - table.name.size() % 8) % 8);
+                std::vector<std::uint64_t> words((width + 63) / 64);
+                for (const auto& outcome : table.outcomes) {
+                    if (!isBits(outcome.first))
+                        continue;
+                    std::fill(words.begin(), words.end(), 0);
+                    size_t bits = outcome.first.size();
+                    for (size_t i = 0; i < bits; ++i)
+                        if (outcome.first[bits - 1 - i] == '1')
+                            words[i / 64] |= std::uint64_t{1} << (i % 64);
+                    out.word(static_cast<std::uint64_t>(outcome.second), 8);
+                    for (std::uint64_t w : words) out.word(w, 8);
+                }
+            }
+        }
+    }  // namespace
+
+    std::optional<OutputFormat> parseOutputFormat(std::string_view name) {
+        if (name == "table")
+            return OutputFormat::Table;
+        if (name == "json")
+            return OutputFormat::Json;
+        if (name == "csv")
+            return OutputFormat::Csv;
+        if (name == "bin")
+            return OutputFormat::Binary;
+        return std::nullopt;
+    }
+
+    std::vector<OutcomeTable> sortTrackedCounts(const bloch::runtime::TrackedCounts& counts) {
+        std::map<std::string_view, const std::unordered_map<std::string, int>*> byName;
+        for (const auto& var : counts) byName.emplace(var.first, &var.second);
+
+        // Bit strings of up to 64 bits order by (width, value); wider ones
+        // by (width, text), which for equal widths is the same order.
+        struct Key {
+            bool bits;
+            size_t width;
+            std::uint64_t value;
+            const std::pair<const std::string, int>* outcome;
+        };
+        std::vector<OutcomeTable> tables;
+        tables.reserve(byName.size());
+        std::vector<Key> keys;
+        for (const auto& [name, outcomes] : byName) {
+            keys.clear();
+            keys.reserve(outcomes->size());
+            for (const auto& outcome : *outcomes) {
+                Key key{isBits(outcome.first), outcome.first.size(), 0, &outcome};
+                if (key.bits && key.width <= 64)
+                    for (char c : outcome.first) key.value = (key.value << 1) | (c == '1');
+                keys.push_back(key);
+            }
+            std::sort(keys.begin(), keys.end(), [](const Key& a, const Key& b) {
+                if (a.bits != b.bits)
+                    return a.bits;
+                if (a.bits && a.width != b.width)
+                    return a.width < b.width;
+                if (a.bits && a.width <= 64)
+                    return a.value < b.value;
+                return a.outcome->first < b.outcome->first;
+            });
+            OutcomeTable table{name, {}};
+            table.outcomes.reserve(keys.size());
+            for (const auto& key : keys)
+                table.outcomes.emplace_back(key.outcome->first, key.outcome->second);
+            tables.push_back(std::move(table));
+        }
+        return tables;
+    }
+
+    void writeResult(std::ostream& out, OutputFormat format, const RunSummary& summary,
+                     const bloch::runtime::TrackedCounts& counts) {
+        std::vector<OutcomeTable> tables = sortTrackedCounts(counts);
+        BufferedWriter writer(out);
+        switch (format) {
+            case OutputFormat::Table:
+                writeTable(writer, tables, summary.shotsRun);
+                break;
+            case OutputFormat::Json:
+                writeJson(writer, summary, tables);
+                break;
+            case OutputFormat::Csv:
+                writeCsv(writer, tables, summary.shotsRun);
+                break;
+            case OutputFormat::Binary:
+                writeBinary(writer, summary, tables);
+                break;
+        }
+    }
+
+}  // namespace bloch::cli
@@ -0,0 +1,63 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "bloch/runtime/circuit.hpp"
+
+namespace bloch::cli {
+
+    // How a multi-shot run prints its @tracked counts (`--output=`).
+    enum class OutputFormat { Table, Json, Csv, Binary };
+
+    // "table", "json", "csv" or "bin"; nullopt for anything else.
+    std::optional<OutputFormat> parseOutputFormat(std::string_view name);
+
+    // One tracked value's outcomes in table order: bit strings first, shorter
+    // before longer and then by value, anything else (e.g. "?") after them.
+    struct OutcomeTable {
+        std::string_view name;
+        std::vector<std::pair<std::string_view, int>> outcomes;
+    };
+
+    // Sorts each value's outcomes once on a precomputed integer key, and the
+    // values by name. The views point into `counts`.
+    std::vector<OutcomeTable> sortTrackedCounts(const bloch::runtime::TrackedCounts& counts);
+
+    // What a run reports alongside its counts.
+    struct RunSummary {
+        int shots = 0;  // requested, or the budget with --ci-width
+        int shotsRun = 0;
+        std::uint64_t seed = 0;
+        std::optional<double> elapsedSeconds;
+        std::optional<double> widestInterval;  // with --ci-width
+        const std::string* qasm = nullptr;     // JSON only
+    };
+
+    // Writes `counts` in `format`, buffering output in large blocks so huge
+    // outcome spaces stream out quickly. Table writes only the outcome
+    // tables; the CLI prints its own header above them. Binary output is
+    // the little-endian layout described in docs/tooling/cli.md.
+    void writeResult(std::ostream& out, OutputFormat format, const RunSummary& summary,
+                     const bloch::runtime::TrackedCounts& counts);
+
+}  // namespace bloch::cli
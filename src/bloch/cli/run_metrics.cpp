@@ -0,0 +1,73 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bloch/cli/run_metrics.hpp"
+
+#include <iomanip>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+#include "bloch/support/json.hpp"
+
+namespace bloch::cli {
+
+    std::optional<std::size_t> peakResidentBytes() {
+#if defined(_WIN32)
+        return std::nullopt;
+#else
+        rusage usage{};
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+            return std::nullopt;
+#if defined(__APPLE__)
+        return static_cast<std::size_t>(usage.ru_maxrss);  // bytes
+#else
+        return static_cast<std::size_t>(usage.ru_maxrss) * 1024;  // KiB
+#endif
+#endif
+    }
+
+    void writeMetrics(std::ostream& out, const RunMetrics& metrics) {
+        auto ms = [](double seconds) { return seconds * 1000.0; };
+        bloch::runtime::PhaseTime total;
+        out << std::fixed << std::setprecision(3);
+        out << "{\"file\":" << support::jsonString(metrics.file) << ",\"shots\":" << metrics.shots
+            << ",\"shotsRun\":" << metrics.shotsRun << ",\"phases\":{";
+        for (size_t i = 0; i < metrics.phases.size(); ++i) {
+            const auto& [name, time] = metrics.phases[i];
+            out << (i ? "," : "") << support::jsonString(name) << ":{\"wallMs\":"
+                << ms(time.wallSeconds) << ",\"cpuMs\":" << ms(time.cpuSeconds) << "}";
+            total += time;
+        }
+        out << "},\"wallMs\":" << ms(total.wallSeconds) << ",\"cpuMs\":" << ms(total.cpuSeconds)
+            << ",\"sourceBytes\":" << metrics.sourceBytes << ",\"astNodes\":" << metrics.astNodes
+            << ",\"peakRssBytes\":";
+        if (metrics.peakResidentBytes)
+            out << *metrics.peakResidentBytes;
+        else
+            out << "null";
+        out << ",\"peakStateBytes\":" << metrics.peakStateBytes << ",\"gates\":{";
+        long long gates = 0;
+        for (size_t k = 0; k < bloch::runtime::kGateKinds; ++k) {
+            auto kind = static_cast<bloch::runtime::GateKind>(k);
+            out << (k ? "," : "") << "\"" << bloch::runtime::gateName(kind)
+                << "\":" << metrics.gates[k];
+            gates += metrics.gates[k];
+        }
+        out << ",\"total\":" << gates << "},\"shotsPerSecond\":" << metrics.shotsPerSecond
+            << "}\n";
+    }
+
+}  // namespace bloch::cli
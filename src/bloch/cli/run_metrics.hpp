@@ -0,0 +1,53 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bloch/runtime/gate.hpp"
+#include "bloch/runtime/stopwatch.hpp"
+
+namespace bloch::cli {
+
+    // What one CLI run cost, phase by phase (`--metrics=FILE`).
+    struct RunMetrics {
+        std::string file;
+        int shots = 0;
+        int shotsRun = 0;
+        // In the order they ran.
+        std::vector<std::pair<std::string, bloch::runtime::PhaseTime>> phases;
+        std::uintmax_t sourceBytes = 0;  // every module the run loaded
+        int astNodes = 0;                // as parsed, before optimisation
+        std::optional<std::size_t> peakResidentBytes;
+        std::size_t peakStateBytes = 0;
+        bloch::runtime::GateCounts gates{};
+        double shotsPerSecond = 0.0;  // over the execute, class table and qasm phases
+    };
+
+    // The process's peak resident set size so far, where the platform
+    // reports one.
+    std::optional<std::size_t> peakResidentBytes();
+
+    // One JSON object; phase and gate keys always appear, in a fixed order,
+    // so dashboards can rely on them.
+    void writeMetrics(std::ostream& out, const RunMetrics& metrics);
+
+}  // namespace bloch::cli
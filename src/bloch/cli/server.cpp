@@ -0,0 +1,265 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bloch/cli/server.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bloch/cli/program_job.hpp"
+#include "bloch/support/json.hpp"
+#include "third_party/cpp-httplib/httplib.h"
+
+namespace bloch::cli {
+    namespace {
+        constexpr const char* kHost = "127.0.0.1";
+        constexpr const char* kJson = "application/json";
+
+        // Runs jobs on a fixed set of threads and refuses new ones once every
+        // worker is busy and `queue` more are waiting.
+        class JobPool {
+           public:
+            JobPool(int workers, int queue) : m_limit(static_cast<size_t>(workers + queue)) {
+                for (int i = 0; i < workers; ++i) m_threads.emplace_back([this] { work(); });
+            }
+
+            ~JobPool() {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_stopping = true;
+                }
+                m_ready.notify_all();
+                for (auto& thread : m_threads) thread.join();
+            }
+
+            std::optional<std::future<JobResult>> submit(std::function<JobResult()> fn) {
+                std::packaged_task<JobResult()> task(std::move(fn));
+                std::future<JobResult> result = task.get_future();
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (m_pending.size() + m_running >= m_limit)
+                        return std::nullopt;
+                    m_pending.push_back(std::move(task));
+                }
+                m_ready.notify_one();
+                return result;
+            }
+
+            std::pair<size_t, size_t> load() const {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return {m_running, m_pending.size()};
+            }
+
+           private:
+            size_t m_limit;
+            mutable std::mutex m_mutex;
+            std::condition_variable m_ready;
+            std::deque<std::packaged_task<JobResult()>> m_pending;
+            size_t m_running = 0;
+            bool m_stopping = false;
+            std::vector<std::thread> m_threads;
+
+            void work() {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                while (true) {
+                    m_ready.wait(lock, [this] { return m_stopping || !m_pending.empty(); });
+                    if (m_pending.empty())
+                        return;
+                    std::packaged_task<JobResult()> task = std::move(m_pending.front());
+                    m_pending.pop_front();
+                    ++m_running;
+                    lock.unlock();
+                    task();
+                    lock.lock();
+                    --m_running;
+                }
+            }
+        };
+
+        // The query string's key/value pairs in order. Request::params would
+        // also hold the body when a client posts it as a form.
+        std::vector<std::pair<std::string, std::string>> queryOptions(const std::string& target) {
+            std::vector<std::pair<std::string, std::string>> options;
+            size_t start = target.find('?');
+            while (start != std::string::npos) {
+                size_t end = target.find('&', start + 1);
+                std::string pair = target.substr(start + 1, end == std::string::npos
+                                                                ? std::string::npos
+                                                                : end - start - 1);
+                if (!pair.empty()) {
+                    size_t eq = pair.find('=');
+                    std::string key = pair.substr(0, eq);
+                    std::string value = eq == std::string::npos ? "" : pair.substr(eq + 1);
+                    options.emplace_back(httplib::decode_query_component(key),
+                                         httplib::decode_query_component(value));
+                }
+                start = end;
+            }
+            return options;
+        }
+
+        int positiveOption(const std::string& arg, std::string_view flag) {
+            try {
+                size_t used = 0;
+                int value = std::stoi(arg.substr(flag.size()), &used);
+                if (used == arg.size() - flag.size())
+                    return value;
+            } catch (const std::exception&) {
+            }
+            return -1;
+        }
+    }  // namespace
+
+    struct JobServer::Impl {
+        ServeOptions options;
+        int workers;
+        int queue;
+        httplib::Server http;
+        ProgramCache programs;
+        JobEnvironment env;
+        JobPool pool;
+
+        explicit Impl(ServeOptions opts)
+            : options(std::move(opts)),
+              workers(options.workers > 0
+                          ? options.workers
+                          : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))),
+              queue(options.queue > 0 ? options.queue : 4 * workers),
+              programs(options.cachedPrograms),
+              env{options.stdlibPaths, std::make_shared<compiler::ModuleCache>(), &programs},
+              pool(workers, queue) {
+            // Enough connection threads for every admitted job plus a few to
+            // answer /health and turn the rest away.
+            size_t connections = static_cast<size_t>(workers + queue + 4);
+            http.new_task_queue = [connections] { return new httplib::ThreadPool(connections); };
+            http.Get("/health", [this](const httplib::Request&, httplib::Response& res) {
+                health(res);
+            });
+            http.Post("/run", [this](const httplib::Request& req, httplib::Response& res) {
+                run(req, res);
+            });
+        }
+
+        void health(httplib::Response& res) const {
+            auto [running, queued] = pool.load();
+            std::ostringstream out;
+            out << "{\"status\":\"ok\",\"workers\":" << workers << ",\"running\":" << running
+                << ",\"queued\":" << queued << ",\"queueLimit\":" << queue
+                << ",\"cachedPrograms\":" << programs.size() << "}";
+            res.set_content(out.str(), kJson);
+        }
+
+        void run(const httplib::Request& req, httplib::Response& res) {
+            ProgramJob job;
+            job.label = "program.bloch";
+            job.source = req.body;
+            job.writeQasm = false;
+            for (const auto& [key, value] : queryOptions(req.target)) {
+                if (key == "name") {
+                    job.label = value;
+                    continue;
+                }
+                std::string problem =
+                    applyJobOption(job, "--" + key + (value.empty() ? "" : "=" + value));
+                if (!problem.empty()) {
+                    res.status = 400;
+                    res.set_content("{\"status\":\"error\",\"error\":{\"category\":\"Error\","
+                                    "\"message\":" +
+                                        support::jsonString(problem) + "}}",
+                                    kJson);
+                    return;
+                }
+            }
+            job.file = std::filesystem::absolute(job.label).string();
+
+            auto result = pool.submit([this, job] { return runJob(job, env); });
+            if (!result) {
+                res.status = 503;
+                res.set_header("Retry-After", "1");
+                res.set_content("{\"status\":\"busy\"}", kJson);
+                return;
+            }
+            JobResult outcome = result->get();
+            res.status = outcome.ok ? 200 : 422;
+            res.set_content("{\"file\":" + support::jsonString(job.label) + "," + outcome.fields +
+                                "}",
+                            kJson);
+        }
+    };
+
+    JobServer::JobServer(ServeOptions options)
+        : m_impl(std::make_unique<Impl>(std::move(options))) {}
+
+    JobServer::~JobServer() = default;
+
+    int JobServer::bind() {
+        if (m_impl->options.port == 0)
+            return m_impl->http.bind_to_any_port(kHost);
+        return m_impl->http.bind_to_port(kHost, m_impl->options.port) ? m_impl->options.port
+                                                                       : -1;
+    }
+
+    void JobServer::serve() { m_impl->http.listen_after_bind(); }
+
+    void JobServer::stop() { m_impl->http.stop(); }
+
+    int runServe(int argc, char** argv, const std::vector<std::string>& stdlibPaths) {
+        ServeOptions options;
+        options.stdlibPaths = stdlibPaths;
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            int* target = nullptr;
+            std::string_view flag;
+            if (arg.rfind("--port=", 0) == 0) {
+                target = &options.port;
+                flag = "--port=";
+            } else if (arg.rfind("--jobs=", 0) == 0) {
+                target = &options.workers;
+                flag = "--jobs=";
+            } else if (arg.rfind("--queue=", 0) == 0) {
+                target = &options.queue;
+                flag = "--queue=";
+            } else {
+                std::cerr << "Usage: bloch serve [--port=P] [--jobs=N] [--queue=N]\n";
+                return 1;
+            }
+            *target = positiveOption(arg, flag);
+            if (*target < 0 || (*target == 0 && target != &options.port)) {
+                std::cerr << flag.substr(0, flag.size() - 1) << " must be a positive number\n";
+                return 1;
+            }
+        }
+        JobServer server(std::move(options));
+        int port = server.bind();
+        if (port < 0) {
+            std::cerr << "cannot listen on " << kHost << "\n";
+            return 1;
+        }
+        std::cout << "Listening on http://" << kHost << ":" << port << std::endl;
+        server.serve();
+        return 0;
+    }
+
+}  // namespace bloch::cli
@@ -0,0 +1,64 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bloch::cli {
+
+    struct ServeOptions {
+        int port = 8750;  // 0 picks a free port
+        int workers = 0;  // programs run at once; 0 means one per core
+        int queue = 0;    // programs waiting beyond those; 0 means 4 per worker
+        size_t cachedPrograms = 64;
+        std::vector<std::string> stdlibPaths;
+    };
+
+    // Local job server behind `bloch serve`, listening on 127.0.0.1 only.
+    //
+    //   GET  /health  {"status":"ok","workers":..,"running":..,"queued":..,...}
+    //   POST /run     body: program source; query: name=<file.bloch> and the
+    //                 options `bloch batch` accepts without dashes (shots=100,
+    //                 seed=7, emit-qasm, ...). Replies with the batch record:
+    //                 200 when it ran, 422 for a program error, 400 for a bad
+    //                 option, and 503 (with Retry-After) when the queue is full.
+    //
+    // `name` places the program for import resolution (relative names are
+    // taken from the server's working directory); nothing is written to disk.
+    // Compiled programs and parsed module files stay in memory between
+    // requests.
+    class JobServer {
+       public:
+        explicit JobServer(ServeOptions options);
+        ~JobServer();
+
+        // Binds the port; returns it, or -1 if it cannot be bound.
+        int bind();
+        // Serves requests until stop(). Call after bind().
+        void serve();
+        void stop();
+
+       private:
+        struct Impl;
+        std::unique_ptr<Impl> m_impl;
+    };
+
+    // `bloch serve [--port=P] [--jobs=N] [--queue=N]`
+    int runServe(int argc, char** argv, const std::vector<std::string>& stdlibPaths);
+
+}  // namespace bloch::cli
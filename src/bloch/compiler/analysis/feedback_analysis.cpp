@@ -0,0 +1,387 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "bloch/compiler/analysis/feedback_analysis.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "bloch/compiler/ast/recursive_ast_visitor.hpp"
+#include "bloch/compiler/optimiser/rewrite_utils.hpp"
+#include "bloch/compiler/semantics/built_ins.hpp"
+
+namespace bloch::compiler {
+
+    namespace {
+        class FeedbackVisitor : public RecursiveASTVisitor {
+           public:
+            explicit FeedbackVisitor(Program& program) : m_program(program) {
+                for (auto& fn : program.functions) addParams(fn->name, fn->params);
+                for (auto& cls : program.classes) {
+                    for (auto& member : cls->members) {
+                        if (auto method = dynamic_cast<MethodDeclaration*>(member.get()))
+                            addParams(method->name, method->params);
+                        else if (auto ctor = dynamic_cast<ConstructorDeclaration*>(member.get()))
+                            addParams("new " + cls->name, ctor->params);
+                    }
+                }
+            }
+
+            FeedbackReport run() {
+                // Taint only grows, so iterate to a fixed point; feedback seen in
+                // any round is real.
+                do {
+                    m_changed = false;
+                    // Taint added in a later round can only take nodes out of
+                    // the controlled set, so it is rebuilt every round.
+                    m_report.controlled.clear();
+                    m_firstControlled = nullptr;
+                    walk(&m_program);
+                } while (m_changed && m_report.replayable);
+                if (!m_report.replayable) {
+                    m_report.controlled.clear();
+                } else if (m_firstControlled) {
+                    m_report.feedbackFree = false;
+                    m_report.line = m_firstControlled->line;
+                    m_report.column = m_firstControlled->column;
+                    m_report.reason = m_firstReason;
+                }
+                return m_report;
+            }
+
+            void visit(FunctionDeclaration& node) override {
+                m_current = node.name;
+                RecursiveASTVisitor::visit(node);
+            }
+            void visit(MethodDeclaration& node) override {
+                m_current = node.name;
+                RecursiveASTVisitor::visit(node);
+            }
+
+            void visit(VariableDeclaration& node) override {
+                if (tainted(node.initializer.get()))
+                    taint(m_names, node.name);
+                RecursiveASTVisitor::visit(node);
+            }
+            void visit(AssignmentStatement& node) override {
+                if (tainted(node.value.get()))
+                    taint(m_names, node.name);
+                RecursiveASTVisitor::visit(node);
+            }
+            void visit(AssignmentExpression& node) override {
+                if (tainted(node.value.get()))
+                    taint(m_names, node.name);
+                RecursiveASTVisitor::visit(node);
+            }
+            void visit(MemberAssignmentExpression& node) override {
+                if (tainted(node.value.get()))
+                    taint(m_names, node.member);
+                RecursiveASTVisitor::visit(node);
+            }
+            void visit(ArrayAssignmentExpression& node) override {
+                check(node.index.get(), node, "array index depends on a measurement");
+                auto var = dynamic_cast<VariableExpression*>(node.collection.get());
+                if (var && tainted(node.value.get()))
+                    taint(m_names, var->name);
+                RecursiveASTVisitor::visit(node);
+            }
+            void visit(ReturnStatement& node) override {
+                if (tainted(node.value.get()))
+                    taint(m_calls, m_current);
+                RecursiveASTVisitor::visit(node);
+            }
+
+            void visit(IfStatement& node) override {
+                if (tainted(node.condition.get()) && controllable(node))
+                    control(node, node.condition.get(),
+                            "branch condition depends on a measurement");
+                else
+                    check(node.condition.get(), node, "branch condition depends on a measurement");
+                RecursiveASTVisitor::visit(node);
+            }
+            void visit(TernaryStatement& node) override {
+                check(node.condition.get(), node, "branch condition depends on a measurement");
+                RecursiveASTVisitor::visit(node);
+            }
+            void visit(WhileStatement& node) override {
+                check(node.condition.get(), node, "loop condition depends on a measurement");
+                RecursiveASTVisitor::visit(node);
+            }
+            void visit(ForStatement& node) override {
+                check(node.condition.get(), node, "loop condition depends on a measurement");
+                RecursiveASTVisitor::visit(node);
+            }
+            void visit(ResetStatement& node) override {
+                check(node.target.get(), node, "reset target depends on a measurement");
+                RecursiveASTVisitor::visit(node);
+            }
+            void visit(MeasureStatement& node) override {
+                check(node.qubit.get(), node, "measure target depends on a measurement");
+                RecursiveASTVisitor::visit(node);
+            }
+            void visit(MeasureExpression& node) override {
+                check(node.qubit.get(), node, "measure target depends on a measurement");
+                RecursiveASTVisitor::visit(node);
+            }
+            void visit(IndexExpression& node) override {
+                check(node.index.get(), node, "array index depends on a measurement");
+                RecursiveASTVisitor::visit(node);
+            }
+            void visit(ArrayType& node) override {
+                check(node.sizeExpression.get(), node, "array size depends on a measurement");
+                RecursiveASTVisitor::visit(node);
+            }
+            void visit(BinaryExpression& node) override {
+                // A divisor that may be zero in some shots only.
+                if (node.op == "/" || node.op == "%")
+                    check(node.right.get(), node, "divisor depends on a measurement");
+                RecursiveASTVisitor::visit(node);
+            }
+            void visit(CallExpression& node) override {
+                std::string name = calleeName(node.callee.get());
+                if (builtInGates.count(name)) {
+                    if (controllableGate(node)) {
+                        for (auto& arg : node.arguments)
+                            if (tainted(arg.get()))
+                                control(node, arg.get(), "gate argument depends on a measurement");
+                    } else {
+                        for (auto& arg : node.arguments)
+                            check(arg.get(), node, "gate argument depends on a measurement");
+                    }
+                } else {
+                    taintParams(name, node.arguments);
+                }
+                RecursiveASTVisitor::visit(node);
+            }
+            void visit(NewExpression& node) override {
+                if (auto named = dynamic_cast<NamedType*>(node.classType.get());
+                    named && !named->nameParts.empty())
+                    taintParams("new " + named->nameParts.back(), node.arguments);
+                RecursiveASTVisitor::visit(node);
+            }
+
+           private:
+            Program& m_program;
+            FeedbackReport m_report;
+            bool m_changed = false;
+            std::string m_current;
+            // Tainted variable, parameter and field names, and functions or
+            // methods that may return a tainted value.
+            std::unordered_set<std::string> m_names;
+            std::unordered_set<std::string> m_calls;
+            std::unordered_map<std::string, std::vector<std::vector<std::string>>> m_params;
+            // The first controlled node of the current round, for the report.
+            const ASTNode* m_firstControlled = nullptr;
+            const char* m_firstReason = "";
+
+            void addParams(const std::string& name,
+                           const std::vector<std::unique_ptr<Parameter>>& params) {
+                std::vector<std::string> names;
+                for (const auto& p : params) names.push_back(p->name);
+                m_params[name].push_back(std::move(names));
+            }
+
+            void taint(std::unordered_set<std::string>& set, const std::string& name) {
+                if (set.insert(name).second)
+                    m_changed = true;
+            }
+
+            void taintParams(const std::string& callee,
+                             const std::vector<std::unique_ptr<Expression>>& args) {
+                auto it = m_params.find(callee);
+                if (it == m_params.end())
+                    return;
+                for (size_t i = 0; i < args.size(); ++i) {
+                    if (!tainted(args[i].get()))
+                        continue;
+                    for (const auto& overload : it->second)
+                        if (i < overload.size())
+                            taint(m_names, overload[i]);
+                }
+            }
+
+            void check(Expression* expr, const ASTNode& at, const char* reason) {
+                if (!m_report.replayable || !tainted(expr))
+                    return;
+                // Not every statement records a position; the expression does.
+                const ASTNode& where = expr->line > 0 ? *expr : at;
+                m_report.replayable = false;
+                m_report.feedbackFree = false;
+                m_report.line = where.line;
+                m_report.column = where.column;
+                m_report.reason = reason;
+            }
+
+            // Adds the tainted names `expr` reads to `node`'s entry.
+            void control(const ASTNode& node, Expression* expr, const char* reason) {
+                auto& names = m_report.controlled[&node];
+                collectTainted(expr, names);
+                if (!m_firstControlled) {
+                    m_firstControlled = expr->line > 0 ? static_cast<const ASTNode*>(expr) : &node;
+                    m_firstReason = reason;
+                }
+            }
+
+            void collectTainted(Expression* expr, std::vector<std::string>& names) {
+                if (auto var = dynamic_cast<VariableExpression*>(expr)) {
+                    if (m_names.count(var->name) &&
+                        std::find(names.begin(), names.end(), var->name) == names.end())
+                        names.push_back(var->name);
+                    return;
+                }
+                forEachChildSlot(*expr, [&](std::unique_ptr<Expression>& child) {
+                    collectTainted(child.get(), names);
+                });
+            }
+
+            // Whether `expr` is built from literals and variables by the
+            // operators of a controlled condition; it then has no side
+            // effects and cannot fail.
+            static bool isBitFormula(Expression* expr) {
+                if (!expr)
+                    return false;
+                if (dynamic_cast<LiteralExpression*>(expr) ||
+                    dynamic_cast<VariableExpression*>(expr))
+                    return true;
+                if (auto paren = dynamic_cast<ParenthesizedExpression*>(expr))
+                    return isBitFormula(paren->expression.get());
+                if (auto unary = dynamic_cast<UnaryExpression*>(expr))
+                    return (unary->op == "!" || unary->op == "~") &&
+                           isBitFormula(unary->right.get());
+                if (auto binary = dynamic_cast<BinaryExpression*>(expr)) {
+                    static const std::unordered_set<std::string> ops = {
+                        "&&", "||", "==", "!=", "&", "|", "^"};
+                    return ops.count(binary->op) && isBitFormula(binary->left.get()) &&
+                           isBitFormula(binary->right.get());
+                }
+                return false;
+            }
+
+            // Whether `expr` reads variables, elements and fields only, so
+            // evaluating it in a branch a shot did not take changes nothing.
+            static bool isPure(Expression* expr) {
+                if (!expr)
+                    return false;
+                if (dynamic_cast<LiteralExpression*>(expr) ||
+                    dynamic_cast<VariableExpression*>(expr))
+                    return true;
+                if (auto paren = dynamic_cast<ParenthesizedExpression*>(expr))
+                    return isPure(paren->expression.get());
+                if (auto unary = dynamic_cast<UnaryExpression*>(expr))
+                    return unary->op != "++" && unary->op != "--" && isPure(unary->right.get());
+                if (auto binary = dynamic_cast<BinaryExpression*>(expr))
+                    return isPure(binary->left.get()) && isPure(binary->right.get());
+                if (auto index = dynamic_cast<IndexExpression*>(expr))
+                    return isPure(index->collection.get()) && isPure(index->index.get());
+                if (auto member = dynamic_cast<MemberAccessExpression*>(expr))
+                    return isPure(member->object.get());
+                return dynamic_cast<ThisExpression*>(expr) != nullptr;
+            }
+
+            // A gate call whose tainted arguments are computed from tainted
+            // variables alone, and whose other arguments are pure.
+            bool controllableGate(CallExpression& call) {
+                if (!builtInGates.count(calleeName(call.callee.get())) ||
+                    !dynamic_cast<VariableExpression*>(call.callee.get()))
+                    return false;
+                for (auto& arg : call.arguments) {
+                    if (!isPure(arg.get()))
+                        return false;
+                    if (tainted(arg.get()) && !isMeasuredFormula(arg.get()))
+                        return false;
+                }
+                return true;
+            }
+
+            // Arithmetic over literals and variables, as a gate angle.
+            static bool isMeasuredFormula(Expression* expr) {
+                if (dynamic_cast<LiteralExpression*>(expr) ||
+                    dynamic_cast<VariableExpression*>(expr))
+                    return true;
+                if (auto paren = dynamic_cast<ParenthesizedExpression*>(expr))
+                    return isMeasuredFormula(paren->expression.get());
+                if (auto unary = dynamic_cast<UnaryExpression*>(expr))
+                    return isMeasuredFormula(unary->right.get());
+                if (auto binary = dynamic_cast<BinaryExpression*>(expr))
+                    return isMeasuredFormula(binary->left.get()) &&
+                           isMeasuredFormula(binary->right.get());
+                return false;
+            }
+
+            bool controllable(IfStatement& node) {
+                return isBitFormula(node.condition.get()) &&
+                       gatesOnly(node.thenBranch.get()) && gatesOnly(node.elseBranch.get());
+            }
+
+            // Whether running `stmt` in a shot that did not reach it would
+            // only apply gates.
+            bool gatesOnly(Statement* stmt) {
+                if (!stmt)
+                    return true;
+                if (auto block = dynamic_cast<BlockStatement*>(stmt)) {
+                    for (auto& inner : block->statements)
+                        if (!gatesOnly(inner.get()))
+                            return false;
+                    return true;
+                }
+                if (auto exprStmt = dynamic_cast<ExpressionStatement*>(stmt)) {
+                    auto call = dynamic_cast<CallExpression*>(exprStmt->expression.get());
+                    return call && controllableGate(*call);
+                }
+                if (auto nested = dynamic_cast<IfStatement*>(stmt)) {
+                    if (tainted(nested->condition.get()))
+                        return controllable(*nested);
+                    return isPure(nested->condition.get()) &&
+                           gatesOnly(nested->thenBranch.get()) &&
+                           gatesOnly(nested->elseBranch.get());
+                }
+                return false;
+            }
+
+            static std::string calleeName(Expression* callee) {
+                if (auto var = dynamic_cast<VariableExpression*>(callee))
+                    return var->name;
+                if (auto mem = dynamic_cast<MemberAccessExpression*>(callee))
+                    return mem->member;
+                return {};
+            }
+
+            bool tainted(Expression* expr) {
+                if (!expr)
+                    return false;
+                if (dynamic_cast<MeasureExpression*>(expr))
+                    return true;
+                if (auto var = dynamic_cast<VariableExpression*>(expr))
+                    return m_names.count(var->name) > 0;
+                if (auto mem = dynamic_cast<MemberAccessExpression*>(expr))
+                    return m_names.count(mem->member) > 0 || tainted(mem->object.get());
+                if (auto call = dynamic_cast<CallExpression*>(expr))
+                    return m_calls.count(calleeName(call->callee.get())) > 0;
+                if (dynamic_cast<NewExpression*>(expr))
+                    return false;
+                bool any = false;
+                forEachChildSlot(*expr, [this, &any](std::unique_ptr<Expression>& child) {
+                    any = any || tainted(child.get());
+                });
+                return any;
+            }
+        };
+    }  // namespace
+
+    FeedbackReport analyseFeedback(Program& program) { return FeedbackVisitor(program).run(); }
+
+}  // namespace bloch::compiler
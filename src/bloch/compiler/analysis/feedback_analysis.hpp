@@ -0,0 +1,60 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bloch/compiler/ast/ast.hpp"
+
+namespace bloch::compiler {
+
+    // `if` statements and gate calls that depend on measurements only through
+    // bits read straight from `measure` (see FeedbackReport::replayable), with
+    // the tainted names each one reads.
+    using ControlledNodes = std::unordered_map<const ASTNode*, std::vector<std::string>>;
+
+    struct FeedbackReport {
+        // True when no measurement result can change what the program does to
+        // its qubits or whether it fails, so every shot applies the same
+        // gates, measurements and resets in the same order.
+        bool feedbackFree = true;
+        // True when the only feedback is in `controlled`: branches whose
+        // condition combines measured bits with !, ~, &&, ||, ==, !=, &, |
+        // and ^ and whose body only applies gates (or nests such branches),
+        // and gate arguments computed from measured bits. A recorded run can
+        // then hold every shot's gates, each under a condition on earlier
+        // outcomes.
+        bool replayable = true;
+        ControlledNodes controlled;
+        // The construct that made the program depend on measurements.
+        int line = 0;
+        int column = 0;
+        std::string reason;
+    };
+
+    // Flow-insensitive measurement-taint analysis over the analysed AST.
+    // Values derived from `measure` (directly, through variables, fields,
+    // parameters or return values, tracked by name) are tainted; a tainted
+    // value reaching a branch or loop condition, a gate argument, an index,
+    // an array size, a divisor, or a measure/reset target is feedback. The
+    // analysis is conservative: name collisions can only add taint. Whether a
+    // controlled node's names really hold measured bits is only known at run
+    // time, so the recording run checks it.
+    FeedbackReport analyseFeedback(Program& program);
+
+}  // namespace bloch::compiler
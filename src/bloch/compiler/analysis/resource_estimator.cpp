@@ -0,0 +1,553 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "bloch/compiler/analysis/resource_estimator.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "bloch/compiler/optimiser/rewrite_utils.hpp"
+#include "bloch/compiler/semantics/built_ins.hpp"
+
+namespace bloch::compiler {
+
+    long long ResourceEstimate::totalGates() const {
+        long long total = 0;
+        for (const auto& [name, count] : gates) total += count;
+        return total;
+    }
+
+    namespace {
+        constexpr int kMaxCallDepth = 256;
+        constexpr long long kMaxMagnitude = 1LL << 62;
+
+        struct AbstractValue {
+            // Known int, long, bit or boolean value.
+            std::optional<long long> number;
+            // Qubits the value refers to: all of them, or one of them when
+            // `oneOf` is set (an index that is not known statically).
+            std::vector<int> qubits;
+            bool oneOf = false;
+
+            bool operator==(const AbstractValue&) const = default;
+        };
+
+        using Scope = std::unordered_map<std::string, AbstractValue>;
+
+        // Everything a branch can change, so both sides of an unknown
+        // condition can start from the same point and then be merged.
+        struct State {
+            int qubits = 0;
+            std::vector<long long> depth;
+            std::map<std::string, long long> gates;
+            long long measurements = 0;
+            long long resets = 0;
+            std::vector<Scope> env;
+            bool returned = false;
+            AbstractValue returnValue;
+        };
+
+        AbstractValue join(const AbstractValue& a, const AbstractValue& b) {
+            if (a == b)
+                return a;
+            AbstractValue out;
+            out.qubits = a.qubits;
+            for (int q : b.qubits)
+                if (std::find(out.qubits.begin(), out.qubits.end(), q) == out.qubits.end())
+                    out.qubits.push_back(q);
+            out.oneOf = !out.qubits.empty();
+            return out;
+        }
+
+        // Keeps the larger figure of each and forgets values the sides disagree on.
+        void merge(State& into, const State& other) {
+            into.qubits = std::max(into.qubits, other.qubits);
+            if (into.depth.size() < other.depth.size())
+                into.depth.resize(other.depth.size(), 0);
+            for (size_t i = 0; i < other.depth.size(); ++i)
+                into.depth[i] = std::max(into.depth[i], other.depth[i]);
+            for (const auto& [name, count] : other.gates)
+                into.gates[name] = std::max(into.gates[name], count);
+            into.measurements = std::max(into.measurements, other.measurements);
+            into.resets = std::max(into.resets, other.resets);
+            for (size_t i = 0; i < into.env.size() && i < other.env.size(); ++i) {
+                for (auto& [name, value] : into.env[i]) {
+                    auto it = other.env[i].find(name);
+                    if (it != other.env[i].end())
+                        value = join(value, it->second);
+                }
+            }
+            if (into.returned != other.returned)
+                into.returnValue = {};
+            else
+                into.returnValue = join(into.returnValue, other.returnValue);
+            // If only one side returned, carrying on over-approximates the other.
+            into.returned = into.returned && other.returned;
+        }
+
+        std::optional<long long> bounded(long long value) {
+            if (value > kMaxMagnitude || value < -kMaxMagnitude)
+                return std::nullopt;
+            return value;
+        }
+
+        std::optional<long long> fold(const std::string& op, long long l, long long r) {
+            if (op == "+")
+                return bounded(l + r);
+            if (op == "-")
+                return bounded(l - r);
+            if (op == "*") {
+                long long magnitude = l < 0 ? -l : l;
+                if (magnitude != 0 &&
+                    (r > kMaxMagnitude / magnitude || r < -kMaxMagnitude / magnitude))
+                    return std::nullopt;
+                return l * r;
+            }
+            // int / int promotes to float at runtime; only exact quotients
+            // stay comparable with integers.
+            if (op == "/")
+                return (r != 0 && l % r == 0) ? std::optional<long long>(l / r) : std::nullopt;
+            if (op == "%")
+                return r != 0 ? std::optional<long long>(l % r) : std::nullopt;
+            if (op == "<")
+                return l < r;
+            if (op == "<=")
+                return l <= r;
+            if (op == ">")
+                return l > r;
+            if (op == ">=")
+                return l >= r;
+            if (op == "==")
+                return l == r;
+            if (op == "!=")
+                return l != r;
+            return std::nullopt;
+        }
+
+        class Estimator {
+           public:
+            Estimator(Program& program, long long maxSteps) : m_maxSteps(maxSteps) {
+                for (auto& fn : program.functions) m_functions[fn->name].push_back(fn.get());
+            }
+
+            ResourceEstimate run() {
+                auto it = m_functions.find("main");
+                if (it != m_functions.end() && it->second.front()->body) {
+                    m_state.env.emplace_back();
+                    exec(it->second.front()->body.get());
+                }
+                ResourceEstimate estimate;
+                estimate.qubits = m_state.qubits;
+                for (long long d : m_state.depth) estimate.depth = std::max(estimate.depth, d);
+                estimate.gates = m_state.gates;
+                estimate.measurements = m_state.measurements;
+                estimate.resets = m_state.resets;
+                estimate.exact = m_notes.empty();
+                estimate.notes = m_notes;
+                return estimate;
+            }
+
+           private:
+            std::unordered_map<std::string, std::vector<FunctionDeclaration*>> m_functions;
+            long long m_maxSteps;
+            State m_state;
+            std::vector<std::string> m_notes;
+            std::unordered_set<std::string> m_noted;
+            long long m_steps = 0;
+            bool m_outOfBudget = false;
+            int m_callDepth = 0;
+
+            void note(const ASTNode& at, const std::string& what) {
+                std::string text = at.line > 0 ? "Ln " + std::to_string(at.line) + ", Col " +
+                                                     std::to_string(at.column) + ": " + what
+                                               : what;
+                if (m_noted.insert(text).second)
+                    m_notes.push_back(text);
+            }
+
+            bool step(const ASTNode& at) {
+                if (!m_outOfBudget && ++m_steps > m_maxSteps) {
+                    m_outOfBudget = true;
+                    note(at, "stopped after " + std::to_string(m_maxSteps) +
+                                 " steps; figures cover the program up to here");
+                }
+                return !m_outOfBudget;
+            }
+
+            AbstractValue* lookup(const std::string& name) {
+                for (auto it = m_state.env.rbegin(); it != m_state.env.rend(); ++it) {
+                    auto found = it->find(name);
+                    if (found != it->end())
+                        return &found->second;
+                }
+                return nullptr;
+            }
+
+            void assign(const std::string& name, AbstractValue value) {
+                if (auto* slot = lookup(name))
+                    *slot = std::move(value);
+            }
+
+            // Runs `body` as if it may or may not execute.
+            void maybeExec(Statement* body) {
+                State skipped = m_state;
+                exec(body);
+                merge(m_state, skipped);
+            }
+
+            void forgetWrites(Statement* body) {
+                WriteSet writes = collectWrites(body);
+                for (const auto& name : writes.written)
+                    if (auto* slot = lookup(name))
+                        slot->number.reset();
+            }
+
+            std::optional<bool> condition(Expression* expr) {
+                if (!expr)
+                    return true;
+                AbstractValue value = eval(expr);
+                if (!value.number)
+                    return std::nullopt;
+                return *value.number != 0;
+            }
+
+            void exec(Statement* stmt) {
+                if (!stmt || m_state.returned || !step(*stmt))
+                    return;
+                if (auto block = dynamic_cast<BlockStatement*>(stmt)) {
+                    m_state.env.emplace_back();
+                    for (auto& child : block->statements) {
+                        exec(child.get());
+                        if (m_state.returned || m_outOfBudget)
+                            break;
+                    }
+                    m_state.env.pop_back();
+                } else if (auto decl = dynamic_cast<VariableDeclaration*>(stmt)) {
+                    declare(*decl);
+                } else if (auto exprStmt = dynamic_cast<ExpressionStatement*>(stmt)) {
+                    eval(exprStmt->expression.get());
+                } else if (auto assignStmt = dynamic_cast<AssignmentStatement*>(stmt)) {
+                    assign(assignStmt->name, eval(assignStmt->value.get()));
+                } else if (auto ret = dynamic_cast<ReturnStatement*>(stmt)) {
+                    m_state.returnValue = ret->value ? eval(ret->value.get()) : AbstractValue{};
+                    m_state.returned = true;
+                } else if (auto ifStmt = dynamic_cast<IfStatement*>(stmt)) {
+                    branch(ifStmt->condition.get(), ifStmt->thenBranch.get(),
+                           ifStmt->elseBranch.get(), *stmt);
+                } else if (auto ternary = dynamic_cast<TernaryStatement*>(stmt)) {
+                    branch(ternary->condition.get(), ternary->thenBranch.get(),
+                           ternary->elseBranch.get(), *stmt);
+                } else if (auto loop = dynamic_cast<WhileStatement*>(stmt)) {
+                    runLoop(loop->condition.get(), loop->body.get(), nullptr, *stmt);
+                } else if (auto loop = dynamic_cast<ForStatement*>(stmt)) {
+                    m_state.env.emplace_back();
+                    exec(loop->initializer.get());
+                    runLoop(loop->condition.get(), loop->body.get(), loop->increment.get(),
+                            *stmt);
+                    m_state.env.pop_back();
+                } else if (auto echo = dynamic_cast<EchoStatement*>(stmt)) {
+                    eval(echo->value.get());
+                } else if (auto reset = dynamic_cast<ResetStatement*>(stmt)) {
+                    AbstractValue target = eval(reset->target.get());
+                    touch(target, m_state.resets, *stmt);
+                } else if (auto measure = dynamic_cast<MeasureStatement*>(stmt)) {
+                    AbstractValue target = eval(measure->qubit.get());
+                    touch(target, m_state.measurements, *stmt);
+                } else if (auto destroy = dynamic_cast<DestroyStatement*>(stmt)) {
+                    eval(destroy->target.get());
+                }
+            }
+
+            void branch(Expression* cond, Statement* thenBranch, Statement* elseBranch,
+                        const ASTNode& at) {
+                auto taken = condition(cond);
+                if (taken) {
+                    exec(*taken ? thenBranch : elseBranch);
+                    return;
+                }
+                const ASTNode& where = cond && cond->line > 0 ? *cond : at;
+                note(where, "branch condition is not a compile-time constant; kept the larger "
+                            "branch");
+                State before = m_state;
+                exec(thenBranch);
+                State thenState = std::move(m_state);
+                m_state = std::move(before);
+                exec(elseBranch);
+                merge(m_state, thenState);
+            }
+
+            void runLoop(Expression* cond, Statement* body, Expression* increment,
+                         const ASTNode& at) {
+                while (!m_state.returned && !m_outOfBudget) {
+                    auto taken = condition(cond);
+                    if (!taken) {
+                        const ASTNode& where = cond && cond->line > 0 ? *cond : at;
+                        note(where, "loop condition is not a compile-time constant; counted at "
+                                    "most one iteration");
+                        maybeExec(body);
+                        forgetWrites(body);
+                        return;
+                    }
+                    if (!*taken)
+                        return;
+                    exec(body);
+                    if (increment && !m_state.returned)
+                        eval(increment);
+                    if (!step(at))
+                        return;
+                }
+            }
+
+            void declare(VariableDeclaration& decl) {
+                AbstractValue value;
+                if (auto prim = dynamic_cast<PrimitiveType*>(decl.varType.get())) {
+                    if (prim->name == "qubit") {
+                        value.qubits.push_back(allocate());
+                    } else if (decl.initializer) {
+                        value = eval(decl.initializer.get());
+                    } else if (prim->name == "int" || prim->name == "long" ||
+                               prim->name == "bit" || prim->name == "boolean") {
+                        value.number = 0;
+                    }
+                } else if (auto arr = dynamic_cast<ArrayType*>(decl.varType.get())) {
+                    std::optional<long long> size;
+                    if (arr->size >= 0)
+                        size = arr->size;
+                    else if (arr->sizeExpression)
+                        size = eval(arr->sizeExpression.get()).number;
+                    auto elem = dynamic_cast<PrimitiveType*>(arr->elementType.get());
+                    if (elem && elem->name == "qubit") {
+                        if (!size)
+                            note(decl, "qubit[] size is not a compile-time constant; its qubits "
+                                       "are not counted");
+                        for (long long i = 0; size && i < *size; ++i)
+                            value.qubits.push_back(allocate());
+                    } else if (decl.initializer) {
+                        eval(decl.initializer.get());
+                    }
+                } else if (decl.initializer) {
+                    eval(decl.initializer.get());
+                }
+                if (!m_state.env.empty())
+                    m_state.env.back()[decl.name] = std::move(value);
+            }
+
+            int allocate() {
+                m_state.depth.push_back(0);
+                return m_state.qubits++;
+            }
+
+            // One operation on `qubits`: each of them, or just one when the
+            // index was unknown. Advances their depth to a common layer.
+            void layer(const std::vector<int>& qubits) {
+                long long top = 0;
+                for (int q : qubits) top = std::max(top, m_state.depth[q]);
+                for (int q : qubits) m_state.depth[q] = top + 1;
+            }
+
+            // Measure or reset every qubit in `target` (or one of them).
+            void touch(const AbstractValue& target, long long& counter, const ASTNode& at) {
+                if (target.qubits.empty())
+                    return;
+                if (target.oneOf) {
+                    note(at, "qubit index is not a compile-time constant; depth is an upper "
+                             "bound");
+                    ++counter;
+                    layer(target.qubits);
+                    return;
+                }
+                counter += static_cast<long long>(target.qubits.size());
+                for (int q : target.qubits) layer({q});
+            }
+
+            void applyGate(const std::string& name, const std::vector<AbstractValue>& args,
+                           const ASTNode& at) {
+                std::vector<int> qubits;
+                for (const auto& arg : args) {
+                    if (arg.oneOf)
+                        note(at, "qubit index is not a compile-time constant; depth is an "
+                                 "upper bound");
+                    qubits.insert(qubits.end(), arg.qubits.begin(), arg.qubits.end());
+                }
+                ++m_state.gates[name];
+                layer(qubits);
+            }
+
+            AbstractValue call(CallExpression& node) {
+                std::vector<AbstractValue> args;
+                for (auto& arg : node.arguments) args.push_back(eval(arg.get()));
+                auto var = dynamic_cast<VariableExpression*>(node.callee.get());
+                if (!var) {
+                    eval(node.callee.get());
+                    note(node, "method calls are not followed; their gates and qubits are not "
+                               "counted");
+                    return {};
+                }
+                if (builtInGates.count(var->name)) {
+                    applyGate(var->name, args, node);
+                    return {};
+                }
+                auto it = m_functions.find(var->name);
+                if (it == m_functions.end())
+                    return {};
+                FunctionDeclaration* fn = it->second.front();
+                for (auto* candidate : it->second)
+                    if (candidate->params.size() == args.size())
+                        fn = candidate;
+                if (!fn->body)
+                    return {};
+                if (m_callDepth >= kMaxCallDepth) {
+                    note(node, "calls nested deeper than " + std::to_string(kMaxCallDepth) +
+                                   " are not followed");
+                    return {};
+                }
+                Scope params;
+                for (size_t i = 0; i < fn->params.size() && i < args.size(); ++i)
+                    params[fn->params[i]->name] = args[i];
+                std::vector<Scope> callerEnv = std::move(m_state.env);
+                m_state.env.clear();
+                m_state.env.push_back(std::move(params));
+                ++m_callDepth;
+                exec(fn->body.get());
+                --m_callDepth;
+                AbstractValue result = std::move(m_state.returnValue);
+                m_state.returned = false;
+                m_state.returnValue = {};
+                m_state.env = std::move(callerEnv);
+                return result;
+            }
+
+            AbstractValue eval(Expression* expr) {
+                if (!expr)
+                    return {};
+                if (auto lit = dynamic_cast<LiteralExpression*>(expr)) {
+                    AbstractValue value;
+                    try {
+                        if (lit->literalType == "int" || lit->literalType == "long")
+                            value.number = std::stoll(lit->value);
+                        else if (lit->literalType == "bit")
+                            value.number = lit->value.rfind('1', 0) == 0 ? 1 : 0;
+                        else if (lit->literalType == "boolean")
+                            value.number = lit->value == "true" ? 1 : 0;
+                    } catch (...) {
+                        value.number.reset();
+                    }
+                    return value;
+                }
+                if (auto var = dynamic_cast<VariableExpression*>(expr)) {
+                    auto* slot = lookup(var->name);
+                    return slot ? *slot : AbstractValue{};
+                }
+                if (auto par = dynamic_cast<ParenthesizedExpression*>(expr))
+                    return eval(par->expression.get());
+                if (auto unary = dynamic_cast<UnaryExpression*>(expr)) {
+                    AbstractValue value = eval(unary->right.get());
+                    AbstractValue out;
+                    if (value.number && unary->op == "-")
+                        out.number = bounded(-*value.number);
+                    else if (value.number && unary->op == "!")
+                        out.number = *value.number == 0;
+                    return out;
+                }
+                if (auto cast = dynamic_cast<CastExpression*>(expr)) {
+                    AbstractValue value = eval(cast->expression.get());
+                    auto prim = dynamic_cast<PrimitiveType*>(cast->targetType.get());
+                    AbstractValue out;
+                    if (value.number && prim && (prim->name == "int" || prim->name == "long"))
+                        out.number = value.number;
+                    else if (value.number && prim &&
+                             (prim->name == "bit" || prim->name == "boolean"))
+                        out.number = *value.number != 0;
+                    return out;
+                }
+                if (auto bin = dynamic_cast<BinaryExpression*>(expr)) {
+                    AbstractValue left = eval(bin->left.get());
+                    AbstractValue out;
+                    if ((bin->op == "&&" || bin->op == "||") && left.number) {
+                        bool shortCircuit = (*left.number != 0) == (bin->op == "||");
+                        if (shortCircuit) {
+                            out.number = bin->op == "||";
+                            return out;
+                        }
+                        AbstractValue right = eval(bin->right.get());
+                        if (right.number)
+                            out.number = *right.number != 0;
+                        return out;
+                    }
+                    AbstractValue right = eval(bin->right.get());
+                    if (left.number && right.number)
+                        out.number = fold(bin->op, *left.number, *right.number);
+                    return out;
+                }
+                if (auto post = dynamic_cast<PostfixExpression*>(expr)) {
+                    AbstractValue value = eval(post->left.get());
+                    if (auto var = dynamic_cast<VariableExpression*>(post->left.get())) {
+                        AbstractValue next;
+                        if (value.number)
+                            next.number =
+                                bounded(*value.number + (post->op == "++" ? 1 : -1));
+                        assign(var->name, next);
+                    }
+                    return value;
+                }
+                if (auto assign = dynamic_cast<AssignmentExpression*>(expr)) {
+                    AbstractValue value = eval(assign->value.get());
+                    this->assign(assign->name, value);
+                    return value;
+                }
+                if (auto call = dynamic_cast<CallExpression*>(expr))
+                    return this->call(*call);
+                if (auto measure = dynamic_cast<MeasureExpression*>(expr)) {
+                    AbstractValue target = eval(measure->qubit.get());
+                    touch(target, m_state.measurements, *expr);
+                    return {};
+                }
+                if (auto index = dynamic_cast<IndexExpression*>(expr)) {
+                    AbstractValue collection = eval(index->collection.get());
+                    AbstractValue idx = eval(index->index.get());
+                    AbstractValue out;
+                    if (collection.qubits.empty())
+                        return out;
+                    if (idx.number && !collection.oneOf && *idx.number >= 0 &&
+                        *idx.number < static_cast<long long>(collection.qubits.size())) {
+                        out.qubits.push_back(collection.qubits[*idx.number]);
+                    } else {
+                        out.qubits = collection.qubits;
+                        out.oneOf = true;
+                    }
+                    return out;
+                }
+                if (dynamic_cast<NewExpression*>(expr)) {
+                    note(*expr, "objects are not followed; their gates and qubits are not "
+                                "counted");
+                    return {};
+                }
+                // Anything else only matters for the side effects of its parts.
+                forEachChildSlot(*expr, [this](std::unique_ptr<Expression>& child) {
+                    eval(child.get());
+                });
+                return {};
+            }
+        };
+    }  // namespace
+
+    ResourceEstimate estimateResources(Program& program, long long maxSteps) {
+        return Estimator(program, maxSteps).run();
+    }
+
+}  // namespace bloch::compiler
@@ -0,0 +1,55 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "bloch/compiler/ast/ast.hpp"
+
+namespace bloch::compiler {
+
+    // Per-shot resources needed to run a program, worked out without
+    // simulating it.
+    struct ResourceEstimate {
+        // Peak number of simulator qubits. Qubits are only handed back when an
+        // object holding them is destroyed, so this is also the total allocated.
+        int qubits = 0;
+        // Longest chain of gates, measurements and resets on any qubit.
+        long long depth = 0;
+        // Gate counts keyed by QASM name.
+        std::map<std::string, long long> gates;
+        long long measurements = 0;
+        long long resets = 0;
+        // False when some control flow or qubit index could not be resolved
+        // statically; `notes` says where and how the figures were bounded.
+        bool exact = true;
+        std::vector<std::string> notes;
+
+        long long totalGates() const;
+    };
+
+    // Abstractly interprets main() over the analysed AST. Integer values are
+    // tracked while they are compile-time known, so loops with constant
+    // bounds, constant array sizes and calls with constant arguments are
+    // followed exactly. Both sides of a branch whose condition is unknown are
+    // explored and the larger figures kept; a loop whose condition is unknown
+    // is counted as running at most once. Runs past `maxSteps` statements
+    // are cut short and reported as inexact.
+    ResourceEstimate estimateResources(Program& program, long long maxSteps = 20'000'000);
+
+}  // namespace bloch::compiler
@@ -0,0 +1,369 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bloch/compiler/ast/ast_clone.hpp"
+
+#include <utility>
+#include <vector>
+
+namespace bloch::compiler {
+
+    namespace {
+        template <typename T>
+        std::unique_ptr<T> at(std::unique_ptr<T> node, const ASTNode& from) {
+            node->line = from.line;
+            node->column = from.column;
+            return node;
+        }
+    }  // namespace
+
+    std::unique_ptr<AnnotationNode> AstCloner::cloneAnnotation(const AnnotationNode* ann) {
+        if (!ann)
+            return nullptr;
+        auto out = std::make_unique<AnnotationNode>();
+        out->name = ann->name;
+        out->value = ann->value;
+        out->isFunctionAnnotation = ann->isFunctionAnnotation;
+        out->isVariableAnnotation = ann->isVariableAnnotation;
+        return at(std::move(out), *ann);
+    }
+
+    std::unique_ptr<BlockStatement> AstCloner::cloneBlock(const BlockStatement* block) {
+        if (!block)
+            return nullptr;
+        auto out = std::make_unique<BlockStatement>();
+        for (const auto& stmt : block->statements) out->statements.push_back(clone(stmt.get()));
+        return at(std::move(out), *block);
+    }
+
+    std::unique_ptr<Statement> AstCloner::clone(const Statement* stmt) {
+        if (!stmt)
+            return nullptr;
+        if (auto var = dynamic_cast<const VariableDeclaration*>(stmt)) {
+            auto out = std::make_unique<VariableDeclaration>();
+            out->name = rename(var->name);
+            out->varType = clone(var->varType.get());
+            out->initializer = clone(var->initializer.get());
+            for (const auto& ann : var->annotations)
+                out->annotations.push_back(cloneAnnotation(ann.get()));
+            out->isFinal = var->isFinal;
+            out->isTracked = var->isTracked;
+            return at(std::move(out), *var);
+        }
+        if (auto block = dynamic_cast<const BlockStatement*>(stmt))
+            return cloneBlock(block);
+        if (auto exprStmt = dynamic_cast<const ExpressionStatement*>(stmt)) {
+            auto out = std::make_unique<ExpressionStatement>();
+            out->expression = clone(exprStmt->expression.get());
+            return at(std::move(out), *exprStmt);
+        }
+        if (auto ret = dynamic_cast<const ReturnStatement*>(stmt)) {
+            auto out = std::make_unique<ReturnStatement>();
+            out->value = clone(ret->value.get());
+            return at(std::move(out), *ret);
+        }
+        if (auto ifs = dynamic_cast<const IfStatement*>(stmt)) {
+            auto out = std::make_unique<IfStatement>();
+            out->condition = clone(ifs->condition.get());
+            out->thenBranch = clone(ifs->thenBranch.get());
+            out->elseBranch = clone(ifs->elseBranch.get());
+            return at(std::move(out), *ifs);
+        }
+        if (auto fors = dynamic_cast<const ForStatement*>(stmt)) {
+            auto out = std::make_unique<ForStatement>();
+            out->initializer = clone(fors->initializer.get());
+            out->condition = clone(fors->condition.get());
+            out->increment = clone(fors->increment.get());
+            out->body = clone(fors->body.get());
+            return at(std::move(out), *fors);
+        }
+        if (auto whiles = dynamic_cast<const WhileStatement*>(stmt)) {
+            auto out = std::make_unique<WhileStatement>();
+            out->condition = clone(whiles->condition.get());
+            out->body = clone(whiles->body.get());
+            return at(std::move(out), *whiles);
+        }
+        if (auto echo = dynamic_cast<const EchoStatement*>(stmt)) {
+            auto out = std::make_unique<EchoStatement>();
+            out->value = clone(echo->value.get());
+            return at(std::move(out), *echo);
+        }
+        if (auto reset = dynamic_cast<const ResetStatement*>(stmt)) {
+            auto out = std::make_unique<ResetStatement>();
+            out->target = clone(reset->target.get());
+            return at(std::move(out), *reset);
+        }
+        if (auto meas = dynamic_cast<const MeasureStatement*>(stmt)) {
+            auto out = std::make_unique<MeasureStatement>();
+            out->qubit = clone(meas->qubit.get());
+            return at(std::move(out), *meas);
+        }
+        if (auto destroy = dynamic_cast<const DestroyStatement*>(stmt)) {
+            auto out = std::make_unique<DestroyStatement>();
+            out->target = clone(destroy->target.get());
+            return at(std::move(out), *destroy);
+        }
+        if (auto tern = dynamic_cast<const TernaryStatement*>(stmt)) {
+            auto out = std::make_unique<TernaryStatement>();
+            out->condition = clone(tern->condition.get());
+            out->thenBranch = clone(tern->thenBranch.get());
+            out->elseBranch = clone(tern->elseBranch.get());
+            return at(std::move(out), *tern);
+        }
+        if (auto assign = dynamic_cast<const AssignmentStatement*>(stmt)) {
+            auto out = std::make_unique<AssignmentStatement>();
+            out->name = rename(assign->name);
+            out->value = clone(assign->value.get());
+            return at(std::move(out), *assign);
+        }
+        return nullptr;
+    }
+
+    std::unique_ptr<Expression> AstCloner::clone(const Expression* expr) {
+        if (!expr)
+            return nullptr;
+        if (auto replacement = substitute(*expr))
+            return replacement;
+        auto cloneArgs = [this](const std::vector<std::unique_ptr<Expression>>& args) {
+            std::vector<std::unique_ptr<Expression>> out;
+            out.reserve(args.size());
+            for (const auto& arg : args) out.push_back(clone(arg.get()));
+            return out;
+        };
+        if (auto bin = dynamic_cast<const BinaryExpression*>(expr))
+            return at(std::make_unique<BinaryExpression>(bin->op, clone(bin->left.get()),
+                                                         clone(bin->right.get())),
+                      *bin);
+        if (auto unary = dynamic_cast<const UnaryExpression*>(expr))
+            return at(std::make_unique<UnaryExpression>(unary->op, clone(unary->right.get())),
+                      *unary);
+        if (auto cast = dynamic_cast<const CastExpression*>(expr))
+            return at(std::make_unique<CastExpression>(clone(cast->targetType.get()),
+                                                       clone(cast->expression.get())),
+                      *cast);
+        if (auto post = dynamic_cast<const PostfixExpression*>(expr))
+            return at(std::make_unique<PostfixExpression>(post->op, clone(post->left.get())),
+                      *post);
+        if (auto lit = dynamic_cast<const LiteralExpression*>(expr))
+            return at(std::make_unique<LiteralExpression>(lit->value, lit->literalType), *lit);
+        if (auto null = dynamic_cast<const NullLiteralExpression*>(expr))
+            return at(std::make_unique<NullLiteralExpression>(), *null);
+        if (auto var = dynamic_cast<const VariableExpression*>(expr))
+            return at(std::make_unique<VariableExpression>(rename(var->name)), *var);
+        if (auto call = dynamic_cast<const CallExpression*>(expr))
+            return at(std::make_unique<CallExpression>(clone(call->callee.get()),
+                                                       cloneArgs(call->arguments)),
+                      *call);
+        if (auto mem = dynamic_cast<const MemberAccessExpression*>(expr)) {
+            auto out = std::make_unique<MemberAccessExpression>();
+            out->object = clone(mem->object.get());
+            out->member = mem->member;
+            return at(std::move(out), *mem);
+        }
+        if (auto newExpr = dynamic_cast<const NewExpression*>(expr)) {
+            auto out = std::make_unique<NewExpression>();
+            out->classType = clone(newExpr->classType.get());
+            out->arguments = cloneArgs(newExpr->arguments);
+            return at(std::move(out), *newExpr);
+        }
+        if (auto self = dynamic_cast<const ThisExpression*>(expr))
+            return at(std::make_unique<ThisExpression>(), *self);
+        if (auto super = dynamic_cast<const SuperExpression*>(expr))
+            return at(std::make_unique<SuperExpression>(), *super);
+        if (auto idx = dynamic_cast<const IndexExpression*>(expr)) {
+            auto out = std::make_unique<IndexExpression>();
+            out->collection = clone(idx->collection.get());
+            out->index = clone(idx->index.get());
+            return at(std::move(out), *idx);
+        }
+        if (auto arr = dynamic_cast<const ArrayLiteralExpression*>(expr))
+            return at(std::make_unique<ArrayLiteralExpression>(cloneArgs(arr->elements)), *arr);
+        if (auto paren = dynamic_cast<const ParenthesizedExpression*>(expr))
+            return at(std::make_unique<ParenthesizedExpression>(clone(paren->expression.get())),
+                      *paren);
+        if (auto meas = dynamic_cast<const MeasureExpression*>(expr))
+            return at(std::make_unique<MeasureExpression>(clone(meas->qubit.get())), *meas);
+        if (auto assign = dynamic_cast<const AssignmentExpression*>(expr))
+            return at(std::make_unique<AssignmentExpression>(rename(assign->name),
+                                                             clone(assign->value.get())),
+                      *assign);
+        if (auto memAssign = dynamic_cast<const MemberAssignmentExpression*>(expr))
+            return at(std::make_unique<MemberAssignmentExpression>(clone(memAssign->object.get()),
+                                                                   memAssign->member,
+                                                                   clone(memAssign->value.get())),
+                      *memAssign);
+        if (auto arrAssign = dynamic_cast<const ArrayAssignmentExpression*>(expr))
+            return at(std::make_unique<ArrayAssignmentExpression>(
+                          clone(arrAssign->collection.get()), clone(arrAssign->index.get()),
+                          clone(arrAssign->value.get())),
+                      *arrAssign);
+        return nullptr;
+    }
+
+    std::unique_ptr<Type> AstCloner::clone(const Type* type) {
+        if (!type)
+            return nullptr;
+        if (auto prim = dynamic_cast<const PrimitiveType*>(type))
+            return at(std::make_unique<PrimitiveType>(prim->name), *prim);
+        if (auto named = dynamic_cast<const NamedType*>(type)) {
+            auto out = std::make_unique<NamedType>(named->nameParts);
+            for (const auto& arg : named->typeArguments)
+                out->typeArguments.push_back(clone(arg.get()));
+            out->hasTypeArgumentList = named->hasTypeArgumentList;
+            return at(std::move(out), *named);
+        }
+        if (auto arr = dynamic_cast<const ArrayType*>(type))
+            return at(std::make_unique<ArrayType>(clone(arr->elementType.get()), arr->size,
+                                                  clone(arr->sizeExpression.get())),
+                      *arr);
+        if (auto v = dynamic_cast<const VoidType*>(type))
+            return at(std::make_unique<VoidType>(), *v);
+        return nullptr;
+    }
+
+    std::unique_ptr<Parameter> AstCloner::cloneParameter(const Parameter* param) {
+        if (!param)
+            return nullptr;
+        auto out = std::make_unique<Parameter>();
+        out->name = rename(param->name);
+        out->type = clone(param->type.get());
+        return at(std::move(out), *param);
+    }
+
+    std::unique_ptr<ClassMember> AstCloner::clone(const ClassMember* member) {
+        if (!member)
+            return nullptr;
+        std::unique_ptr<ClassMember> out;
+        if (auto field = dynamic_cast<const FieldDeclaration*>(member)) {
+            auto copy = std::make_unique<FieldDeclaration>();
+            copy->name = field->name;
+            copy->fieldType = clone(field->fieldType.get());
+            copy->initializer = clone(field->initializer.get());
+            for (const auto& ann : field->annotations)
+                copy->annotations.push_back(cloneAnnotation(ann.get()));
+            copy->isFinal = field->isFinal;
+            copy->isStatic = field->isStatic;
+            copy->isTracked = field->isTracked;
+            out = std::move(copy);
+        } else if (auto method = dynamic_cast<const MethodDeclaration*>(member)) {
+            auto copy = std::make_unique<MethodDeclaration>();
+            copy->name = method->name;
+            for (const auto& param : method->params)
+                copy->params.push_back(cloneParameter(param.get()));
+            copy->returnType = clone(method->returnType.get());
+            copy->body = cloneBlock(method->body.get());
+            for (const auto& ann : method->annotations)
+                copy->annotations.push_back(cloneAnnotation(ann.get()));
+            copy->hasQuantumAnnotation = method->hasQuantumAnnotation;
+            copy->isStatic = method->isStatic;
+            copy->isVirtual = method->isVirtual;
+            copy->isOverride = method->isOverride;
+            out = std::move(copy);
+        } else if (auto ctor = dynamic_cast<const ConstructorDeclaration*>(member)) {
+            auto copy = std::make_unique<ConstructorDeclaration>();
+            for (const auto& param : ctor->params)
+                copy->params.push_back(cloneParameter(param.get()));
+            copy->body = cloneBlock(ctor->body.get());
+            copy->isDefault = ctor->isDefault;
+            out = std::move(copy);
+        } else if (auto dtor = dynamic_cast<const DestructorDeclaration*>(member)) {
+            auto copy = std::make_unique<DestructorDeclaration>();
+            copy->body = cloneBlock(dtor->body.get());
+            copy->isDefault = dtor->isDefault;
+            out = std::move(copy);
+        } else {
+            return nullptr;
+        }
+        out->visibility = member->visibility;
+        return at(std::move(out), *member);
+    }
+
+    std::unique_ptr<FunctionDeclaration> AstCloner::clone(const FunctionDeclaration* fn) {
+        if (!fn)
+            return nullptr;
+        auto out = std::make_unique<FunctionDeclaration>();
+        out->name = fn->name;
+        for (const auto& param : fn->params) out->params.push_back(cloneParameter(param.get()));
+        out->returnType = clone(fn->returnType.get());
+        out->body = cloneBlock(fn->body.get());
+        for (const auto& ann : fn->annotations)
+            out->annotations.push_back(cloneAnnotation(ann.get()));
+        out->hasQuantumAnnotation = fn->hasQuantumAnnotation;
+        out->hasShotsAnnotation = fn->hasShotsAnnotation;
+        return at(std::move(out), *fn);
+    }
+
+    std::unique_ptr<ClassDeclaration> AstCloner::clone(const ClassDeclaration* cls) {
+        if (!cls)
+            return nullptr;
+        auto out = std::make_unique<ClassDeclaration>();
+        out->name = cls->name;
+        for (const auto& tp : cls->typeParameters) {
+            auto copy = std::make_unique<TypeParameter>();
+            copy->name = tp->name;
+            copy->bound = clone(tp->bound.get());
+            out->typeParameters.push_back(at(std::move(copy), *tp));
+        }
+        out->baseName = cls->baseName;
+        out->baseType = clone(cls->baseType.get());
+        out->isStatic = cls->isStatic;
+        out->isAbstract = cls->isAbstract;
+        for (const auto& member : cls->members) out->members.push_back(clone(member.get()));
+        return at(std::move(out), *cls);
+    }
+
+    std::unique_ptr<Program> AstCloner::clone(const Program* program) {
+        if (!program)
+            return nullptr;
+        auto out = std::make_unique<Program>();
+        if (program->packageDecl) {
+            auto copy = std::make_unique<PackageDeclaration>();
+            copy->nameParts = program->packageDecl->nameParts;
+            out->packageDecl = at(std::move(copy), *program->packageDecl);
+        }
+        for (const auto& imp : program->imports) {
+            auto copy = std::make_unique<ImportDeclaration>();
+            copy->packageParts = imp->packageParts;
+            copy->symbol = imp->symbol;
+            copy->isWildcard = imp->isWildcard;
+            out->imports.push_back(at(std::move(copy), *imp));
+        }
+        for (const auto& cls : program->classes) out->classes.push_back(clone(cls.get()));
+        for (const auto& fn : program->functions) out->functions.push_back(clone(fn.get()));
+        for (const auto& stmt : program->statements) out->statements.push_back(clone(stmt.get()));
+        out->shots = program->shots;
+        return at(std::move(out), *program);
+    }
+
+    std::unique_ptr<Statement> cloneStatement(const Statement* stmt) {
+        AstCloner cloner;
+        return cloner.clone(stmt);
+    }
+
+    std::unique_ptr<Expression> cloneExpression(const Expression* expr) {
+        AstCloner cloner;
+        return cloner.clone(expr);
+    }
+
+    std::unique_ptr<Type> cloneType(const Type* type) {
+        AstCloner cloner;
+        return cloner.clone(type);
+    }
+
+    std::unique_ptr<Program> cloneProgram(const Program* program) {
+        AstCloner cloner;
+        return cloner.clone(program);
+    }
+
+}  // namespace bloch::compiler
@@ -0,0 +1,56 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "bloch/compiler/ast/ast.hpp"
+
+namespace bloch::compiler {
+
+    // Deep copies of AST subtrees, from single expressions up to whole
+    // programs. Source positions are preserved so diagnostics raised on a
+    // copy still point at the original code. Rewriting passes derive from
+    // AstCloner and override substitute() to splice in replacements while
+    // copying.
+    class AstCloner {
+       public:
+        virtual ~AstCloner() = default;
+
+        std::unique_ptr<Statement> clone(const Statement* stmt);
+        std::unique_ptr<Expression> clone(const Expression* expr);
+        std::unique_ptr<Type> clone(const Type* type);
+        std::unique_ptr<BlockStatement> cloneBlock(const BlockStatement* block);
+        std::unique_ptr<AnnotationNode> cloneAnnotation(const AnnotationNode* ann);
+        std::unique_ptr<Parameter> cloneParameter(const Parameter* param);
+        std::unique_ptr<ClassMember> clone(const ClassMember* member);
+        std::unique_ptr<FunctionDeclaration> clone(const FunctionDeclaration* fn);
+        std::unique_ptr<ClassDeclaration> clone(const ClassDeclaration* cls);
+        std::unique_ptr<Program> clone(const Program* program);
+
+       protected:
+        // Return a replacement for `expr`, or nullptr to copy it as-is.
+        virtual std::unique_ptr<Expression> substitute(const Expression&) { return nullptr; }
+        // Map a local variable name (declarations and assignments included).
+        virtual std::string rename(const std::string& name) { return name; }
+    };
+
+    std::unique_ptr<Statement> cloneStatement(const Statement* stmt);
+    std::unique_ptr<Expression> cloneExpression(const Expression* expr);
+    std::unique_ptr<Type> cloneType(const Type* type);
+    std::unique_ptr<Program> cloneProgram(const Program* program);
+
+}  // namespace bloch::compiler
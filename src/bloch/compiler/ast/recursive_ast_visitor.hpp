@@ -0,0 +1,165 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "bloch/compiler/ast/ast.hpp"
+
+namespace bloch::compiler {
+
+    // A visitor that walks every child of every node. Analyses and rewrites
+    // that only care about a handful of node kinds derive from this and
+    // override just those, calling the base visit() to keep descending.
+    class RecursiveASTVisitor : public ASTVisitor {
+       public:
+        void visit(VariableDeclaration& node) override {
+            for (auto& ann : node.annotations) walk(ann.get());
+            walk(node.varType.get());
+            walk(node.initializer.get());
+        }
+        void visit(BlockStatement& node) override {
+            for (auto& stmt : node.statements) walk(stmt.get());
+        }
+        void visit(ExpressionStatement& node) override { walk(node.expression.get()); }
+        void visit(ReturnStatement& node) override { walk(node.value.get()); }
+        void visit(IfStatement& node) override {
+            walk(node.condition.get());
+            walk(node.thenBranch.get());
+            walk(node.elseBranch.get());
+        }
+        void visit(ForStatement& node) override {
+            walk(node.initializer.get());
+            walk(node.condition.get());
+            walk(node.increment.get());
+            walk(node.body.get());
+        }
+        void visit(WhileStatement& node) override {
+            walk(node.condition.get());
+            walk(node.body.get());
+        }
+        void visit(EchoStatement& node) override { walk(node.value.get()); }
+        void visit(ResetStatement& node) override { walk(node.target.get()); }
+        void visit(MeasureStatement& node) override { walk(node.qubit.get()); }
+        void visit(DestroyStatement& node) override { walk(node.target.get()); }
+        void visit(TernaryStatement& node) override {
+            walk(node.condition.get());
+            walk(node.thenBranch.get());
+            walk(node.elseBranch.get());
+        }
+        void visit(AssignmentStatement& node) override { walk(node.value.get()); }
+
+        void visit(BinaryExpression& node) override {
+            walk(node.left.get());
+            walk(node.right.get());
+        }
+        void visit(UnaryExpression& node) override { walk(node.right.get()); }
+        void visit(CastExpression& node) override {
+            walk(node.targetType.get());
+            walk(node.expression.get());
+        }
+        void visit(PostfixExpression& node) override { walk(node.left.get()); }
+        void visit(LiteralExpression&) override {}
+        void visit(NullLiteralExpression&) override {}
+        void visit(VariableExpression&) override {}
+        void visit(CallExpression& node) override {
+            walk(node.callee.get());
+            for (auto& arg : node.arguments) walk(arg.get());
+        }
+        void visit(MemberAccessExpression& node) override { walk(node.object.get()); }
+        void visit(NewExpression& node) override {
+            walk(node.classType.get());
+            for (auto& arg : node.arguments) walk(arg.get());
+        }
+        void visit(ThisExpression&) override {}
+        void visit(SuperExpression&) override {}
+        void visit(IndexExpression& node) override {
+            walk(node.collection.get());
+            walk(node.index.get());
+        }
+        void visit(ArrayLiteralExpression& node) override {
+            for (auto& el : node.elements) walk(el.get());
+        }
+        void visit(ParenthesizedExpression& node) override { walk(node.expression.get()); }
+        void visit(MeasureExpression& node) override { walk(node.qubit.get()); }
+        void visit(AssignmentExpression& node) override { walk(node.value.get()); }
+        void visit(MemberAssignmentExpression& node) override {
+            walk(node.object.get());
+            walk(node.value.get());
+        }
+        void visit(ArrayAssignmentExpression& node) override {
+            walk(node.collection.get());
+            walk(node.index.get());
+            walk(node.value.get());
+        }
+
+        void visit(PrimitiveType&) override {}
+        void visit(NamedType& node) override {
+            for (auto& arg : node.typeArguments) walk(arg.get());
+        }
+        void visit(ArrayType& node) override {
+            walk(node.elementType.get());
+            walk(node.sizeExpression.get());
+        }
+        void visit(VoidType&) override {}
+        void visit(TypeParameter& node) override { walk(node.bound.get()); }
+
+        void visit(Parameter& node) override { walk(node.type.get()); }
+        void visit(AnnotationNode&) override {}
+        void visit(PackageDeclaration&) override {}
+        void visit(ImportDeclaration&) override {}
+        void visit(FieldDeclaration& node) override {
+            for (auto& ann : node.annotations) walk(ann.get());
+            walk(node.fieldType.get());
+            walk(node.initializer.get());
+        }
+        void visit(MethodDeclaration& node) override {
+            for (auto& ann : node.annotations) walk(ann.get());
+            for (auto& param : node.params) walk(param.get());
+            walk(node.returnType.get());
+            walk(node.body.get());
+        }
+        void visit(ConstructorDeclaration& node) override {
+            for (auto& param : node.params) walk(param.get());
+            walk(node.body.get());
+        }
+        void visit(DestructorDeclaration& node) override { walk(node.body.get()); }
+        void visit(ClassDeclaration& node) override {
+            for (auto& tp : node.typeParameters) walk(tp.get());
+            walk(node.baseType.get());
+            for (auto& member : node.members) walk(member.get());
+        }
+        void visit(FunctionDeclaration& node) override {
+            for (auto& ann : node.annotations) walk(ann.get());
+            for (auto& param : node.params) walk(param.get());
+            walk(node.returnType.get());
+            walk(node.body.get());
+        }
+        void visit(Program& node) override {
+            walk(node.packageDecl.get());
+            for (auto& imp : node.imports) walk(imp.get());
+            for (auto& cls : node.classes) walk(cls.get());
+            for (auto& fn : node.functions) walk(fn.get());
+            for (auto& stmt : node.statements) walk(stmt.get());
+        }
+
+       protected:
+        // Every child passes through here, so subclasses can hook pre/post
+        // processing for all nodes in one place.
+        virtual void walk(ASTNode* node) {
+            if (node)
+                node->accept(*this);
+        }
+    };
+
+}  // namespace bloch::compiler
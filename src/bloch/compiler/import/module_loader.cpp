@@ -20,6 +20,7 @@
 #include <map>
 #include <sstream>
 
+#include "bloch/compiler/ast/ast_clone.hpp"
 #include "bloch/compiler/lexer/lexer.hpp"
 #include "bloch/compiler/parser/parser.hpp"
 #include "bloch/support/error/bloch_error.hpp"
@@ -30,8 +31,84 @@ namespace bloch::compiler {
     using support::ErrorCategory;
     namespace fs = std::filesystem;
 
-    ModuleLoader::ModuleLoader(std::vector<std::string> searchPaths)
-        : m_searchPaths(std::move(searchPaths)) {}
+    namespace {
+        std::string readSource(const std::string& path) {
+            std::ifstream in(path);
+            if (!in) {
+                throw BlochError(ErrorCategory::Parse, 0, 0, "failed to open '" + path + "'");
+            }
+            return std::string((std::istreambuf_iterator<char>(in)),
+                               std::istreambuf_iterator<char>());
+        }
+    }  // namespace
+
+    FileStamp fileStamp(const std::string& path) {
+        std::error_code timeError;
+        std::error_code sizeError;
+        FileStamp stamp;
+        stamp.modified = fs::last_write_time(path, timeError);
+        stamp.size = fs::file_size(path, sizeError);
+        stamp.valid = !timeError && !sizeError;
+        return stamp;
+    }
+
+    std::shared_ptr<const std::vector<Token>> ModuleCache::tokens(const std::string& path) {
+        FileStamp stamp = fileStamp(path);
+        bool stamped = stamp.valid;
+        if (stamped) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_entries.find(path);
+            if (it != m_entries.end() && it->second.stamp == stamp)
+                return it->second.tokens;
+        }
+        // Lex outside the lock; two threads racing on a new file both lex it.
+        std::string source = readSource(path);
+        Lexer lexer(source);
+        auto tokens = std::make_shared<const std::vector<Token>>(lexer.tokenize());
+        if (stamped) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_entries[path] = Entry{stamp, tokens, nullptr};
+        }
+        return tokens;
+    }
+
+    std::unique_ptr<Program> ModuleCache::parse(const std::string& path) {
+        FileStamp stamp = fileStamp(path);
+        if (stamp.valid) {
+            std::shared_ptr<const Program> parsed;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto it = m_entries.find(path);
+                if (it != m_entries.end() && it->second.stamp == stamp)
+                    parsed = it->second.program;
+            }
+            if (parsed)
+                return cloneProgram(parsed.get());
+        }
+        Parser parser(*tokens(path));
+        std::shared_ptr<const Program> parsed = parser.parse();
+        if (stamp.valid) {
+            // Only kept if the tokens it came from are for the same version.
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_entries.find(path);
+            if (it != m_entries.end() && it->second.stamp == stamp)
+                it->second.program = parsed;
+        }
+        return cloneProgram(parsed.get());
+    }
+
+    bool ModuleCache::changed(const std::string& path) {
+        FileStamp stamp = fileStamp(path);
+        if (!stamp.valid)
+            return false;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(path);
+        return it != m_entries.end() && it->second.stamp != stamp;
+    }
+
+    ModuleLoader::ModuleLoader(std::vector<std::string> searchPaths,
+                               std::shared_ptr<ModuleCache> cache)
+        : m_searchPaths(std::move(searchPaths)), m_sharedCache(std::move(cache)) {}
 
     std::string ModuleLoader::joinQualified(const std::vector<std::string>& parts) {
         std::ostringstream oss;
@@ -95,12 +172,15 @@ namespace bloch::compiler {
     }
 
     std::unique_ptr<Program> ModuleLoader::parseFile(const std::string& path) const {
-        std::ifstream in(path);
-        if (!in) {
-            throw BlochError(ErrorCategory::Parse, 0, 0, "failed to open '" + path + "'");
+        if (m_entrySource && path == m_entryPath) {
+            Lexer lexer(*m_entrySource);
+            Parser parser(lexer.tokenize());
+            return parser.parse();
         }
-        std::string src((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
-        Lexer lexer(src);
+        if (m_sharedCache)
+            return m_sharedCache->parse(path);
+        std::string source = readSource(path);
+        Lexer lexer(source);
         std::vector<Token> tokens = lexer.tokenize();
         Parser parser(std::move(tokens));
         return parser.parse();
@@ -317,4 +397,26 @@ namespace bloch::compiler {
         return merged;
     }
 
+    std::vector<std::string> ModuleLoader::modules() const {
+        std::vector<std::string> paths = m_loadOrder;
+        for (const auto& path : m_stack)
+            if (std::find(paths.begin(), paths.end(), path) == paths.end())
+                paths.push_back(path);
+        return paths;
+    }
+
+    std::unique_ptr<Program> ModuleLoader::loadSource(const std::string& entryFile,
+                                                      const std::string& source) {
+        m_entryPath = canonicalize(entryFile);
+        m_entrySource = &source;
+        try {
+            std::unique_ptr<Program> program = load(entryFile);
+            m_entrySource = nullptr;
+            return program;
+        } catch (...) {
+            m_entrySource = nullptr;
+            throw;
+        }
+    }
+
 }  // namespace bloch::compiler
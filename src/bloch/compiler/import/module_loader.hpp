@@ -14,29 +14,87 @@
 
 #pragma once
 
+#include <cstdint>
+#include <filesystem>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "bloch/compiler/ast/ast.hpp"
+#include "bloch/compiler/lexer/token.hpp"
 
 namespace bloch::compiler {
 
+    // A file's modification time and size, which stand in for its contents
+    // when deciding whether something built from it is still current.
+    struct FileStamp {
+        bool valid = false;  // false when the file could not be stat'ed
+        std::filesystem::file_time_type modified;
+        std::uintmax_t size = 0;
+
+        bool operator==(const FileStamp&) const = default;
+    };
+
+    FileStamp fileStamp(const std::string& path);
+
+    // Token streams and parsed ASTs of module files, shared between loaders
+    // so modules used by many programs (the stdlib above all) are read,
+    // lexed and parsed once. An entry is reused while the file's size and
+    // modification time are unchanged. Safe to share between threads.
+    class ModuleCache {
+       public:
+        // Tokens of the file at canonical `path`, reading and lexing it when
+        // it is new or has changed. Throws BlochError if it cannot be read.
+        std::shared_ptr<const std::vector<Token>> tokens(const std::string& path);
+        // A copy of the file's AST as parsed, which the caller may rewrite;
+        // the file is only parsed again once it changes. Throws BlochError if
+        // it cannot be read or parsed.
+        std::unique_ptr<Program> parse(const std::string& path);
+        // Whether the file at `path` was written since its cached tokens were
+        // read. False for files the cache has not read or can no longer stamp.
+        bool changed(const std::string& path);
+
+       private:
+        struct Entry {
+            FileStamp stamp;
+            std::shared_ptr<const std::vector<Token>> tokens;
+            std::shared_ptr<const Program> program;  // null until first parsed
+        };
+
+        std::mutex m_mutex;
+        std::unordered_map<std::string, Entry> m_entries;
+    };
+
     // Resolves and loads imports starting from an entry file, producing a single
     // aggregated Program ready for semantic analysis and execution. Imports are
     // resolved relative to the importing file and optional search paths.
     class ModuleLoader {
        public:
-        explicit ModuleLoader(std::vector<std::string> searchPaths = {});
+        explicit ModuleLoader(std::vector<std::string> searchPaths = {},
+                              std::shared_ptr<ModuleCache> cache = nullptr);
 
         // Load the entry file and all of its transitive imports, merging them
         // into a single Program. Throws BlochError on missing modules, cycles,
         // or parse errors. Exactly one main() must exist across the graph.
         std::unique_ptr<Program> load(const std::string& entryFile);
 
+        // As load, but the entry module's text is `source` instead of the
+        // file's contents; `entryFile` still locates its imports and names it
+        // in errors. The file need not exist.
+        std::unique_ptr<Program> loadSource(const std::string& entryFile,
+                                            const std::string& source);
+
+        // Canonical paths of the files the last load read, in load order,
+        // including any it was part way through when it threw.
+        std::vector<std::string> modules() const;
+
        private:
         std::vector<std::string> m_searchPaths;
+        std::shared_ptr<ModuleCache> m_sharedCache;
+        std::string m_entryPath;  // canonical entry path while loadSource runs
+        const std::string* m_entrySource = nullptr;
         std::unordered_map<std::string, std::unique_ptr<Program>> m_cache;
         std::vector<std::string> m_loadOrder;
         std::vector<std::string> m_stack;
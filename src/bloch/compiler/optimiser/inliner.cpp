@@ -0,0 +1,467 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bloch/compiler/optimiser/inliner.hpp"
+
+#include <functional>
+#include <utility>
+
+#include "bloch/compiler/ast/ast_clone.hpp"
+#include "bloch/compiler/optimiser/rewrite_utils.hpp"
+#include "bloch/compiler/semantics/built_ins.hpp"
+
+namespace bloch::compiler {
+
+    namespace {
+        // Calls to free functions by name, for recursion detection.
+        class CallCollector : public RecursiveASTVisitor {
+           public:
+            std::unordered_set<std::string> callees;
+
+            void collect(ASTNode* node) { walk(node); }
+
+            void visit(CallExpression& node) override {
+                if (auto var = dynamic_cast<VariableExpression*>(node.callee.get()))
+                    callees.insert(var->name);
+                RecursiveASTVisitor::visit(node);
+            }
+        };
+
+        class ReturnCounter : public RecursiveASTVisitor {
+           public:
+            int count = 0;
+
+            void collect(ASTNode* node) { walk(node); }
+
+            void visit(ReturnStatement& node) override {
+                ++count;
+                RecursiveASTVisitor::visit(node);
+            }
+        };
+
+        // Copies a callee body into the caller: parameters become argument
+        // expressions and colliding locals get fresh names.
+        class CallSiteCloner : public AstCloner {
+           public:
+            std::unordered_map<std::string, const Expression*> arguments;
+            std::unordered_map<std::string, std::string> renames;
+
+           protected:
+            std::unique_ptr<Expression> substitute(const Expression& expr) override {
+                auto var = dynamic_cast<const VariableExpression*>(&expr);
+                if (!var)
+                    return nullptr;
+                auto it = arguments.find(var->name);
+                // Argument expressions belong to the caller, so copy them verbatim.
+                return it == arguments.end() ? nullptr : cloneExpression(it->second);
+            }
+            std::string rename(const std::string& name) override {
+                auto it = renames.find(name);
+                return it == renames.end() ? name : it->second;
+            }
+        };
+
+        // Literals and variables: cheap, unable to fail and unaffected by
+        // anything the callee can do, so skipping or repeating them is safe.
+        bool isSimpleArgument(const Expression* expr) {
+            return dynamic_cast<const LiteralExpression*>(expr) ||
+                   dynamic_cast<const VariableExpression*>(expr);
+        }
+
+        // `q[i]` with a literal or variable index. Reading it has no effect
+        // beyond a bounds check, and the callee cannot change `q` or `i`.
+        bool isElementArgument(const Expression* expr) {
+            auto idx = dynamic_cast<const IndexExpression*>(expr);
+            return idx && dynamic_cast<const VariableExpression*>(idx->collection.get()) &&
+                   isSimpleArgument(idx->index.get());
+        }
+
+        bool isQubitType(const Type* type) {
+            if (auto arr = dynamic_cast<const ArrayType*>(type))
+                type = arr->elementType.get();
+            auto prim = dynamic_cast<const PrimitiveType*>(type);
+            return prim && prim->name == "qubit";
+        }
+
+        // Types whose declaration without an initialiser has no side effects,
+        // so `T x = f();` can become `T x;` followed by `x = ...`.
+        bool isPlainValueType(const Type* type) {
+            if (auto arr = dynamic_cast<const ArrayType*>(type))
+                type = arr->elementType.get();
+            return dynamic_cast<const PrimitiveType*>(type) && !isQubitType(type);
+        }
+
+        void collectNames(const Expression* expr, std::unordered_set<std::string>& names) {
+            if (!expr)
+                return;
+            if (auto var = dynamic_cast<const VariableExpression*>(expr)) {
+                names.insert(var->name);
+                return;
+            }
+            forEachChildSlot(const_cast<Expression&>(*expr),
+                             [&names](std::unique_ptr<Expression>& child) {
+                                 collectNames(child.get(), names);
+                             });
+        }
+
+        template <typename T>
+        std::unique_ptr<T> at(std::unique_ptr<T> node, const ASTNode& from) {
+            node->line = from.line;
+            node->column = from.column;
+            return node;
+        }
+    }  // namespace
+
+    int Inliner::run(Program& program) {
+        m_inlined = 0;
+        collectCandidates(program);
+        if (m_candidates.empty())
+            return 0;
+        for (auto& fn : program.functions) rewriteBody(fn->body.get());
+        for (auto& cls : program.classes) {
+            for (auto& member : cls->members) {
+                if (auto method = dynamic_cast<MethodDeclaration*>(member.get()))
+                    rewriteBody(method->body.get());
+                else if (auto ctor = dynamic_cast<ConstructorDeclaration*>(member.get()))
+                    rewriteBody(ctor->body.get());
+                else if (auto dtor = dynamic_cast<DestructorDeclaration*>(member.get()))
+                    rewriteBody(dtor->body.get());
+            }
+        }
+        return m_inlined;
+    }
+
+    void Inliner::collectCandidates(Program& program) {
+        m_candidates.clear();
+        std::unordered_map<std::string, std::unordered_set<std::string>> calls;
+        for (auto& fn : program.functions) {
+            CallCollector collector;
+            collector.collect(fn->body.get());
+            calls[fn->name] = std::move(collector.callees);
+        }
+        // A function that can reach itself through free-function calls is never
+        // inlined; that keeps repeated inlining finite.
+        auto reachesItself = [&calls](const std::string& start) {
+            std::unordered_set<std::string> seen;
+            std::vector<std::string> work(calls[start].begin(), calls[start].end());
+            while (!work.empty()) {
+                std::string name = std::move(work.back());
+                work.pop_back();
+                if (name == start)
+                    return true;
+                auto it = calls.find(name);
+                if (it == calls.end() || !seen.insert(name).second)
+                    continue;
+                work.insert(work.end(), it->second.begin(), it->second.end());
+            }
+            return false;
+        };
+
+        for (auto& fn : program.functions) {
+            if (!fn->body || fn->hasShotsAnnotation || builtInGates.count(fn->name))
+                continue;
+            int nodes = countNodes(fn->body.get());
+            if (nodes > m_maxCalleeNodes || reachesItself(fn->name))
+                continue;
+            // The only return may be the last top-level statement: anything else
+            // needs the early-exit machinery of a real call.
+            ReturnCounter returns;
+            returns.collect(fn->body.get());
+            auto& stmts = fn->body->statements;
+            bool trailingReturn =
+                !stmts.empty() && dynamic_cast<ReturnStatement*>(stmts.back().get());
+            if (returns.count > (trailingReturn ? 1 : 0))
+                continue;
+            WriteSet writes = collectWrites(fn->body.get());
+            bool trackedLocal = false;
+            forEachStatement(*fn->body, [&trackedLocal](Statement& s) {
+                if (auto var = dynamic_cast<VariableDeclaration*>(&s))
+                    trackedLocal = trackedLocal || var->isTracked;
+            });
+            if (trackedLocal)
+                continue;
+            Candidate candidate;
+            candidate.fn = fn.get();
+            candidate.nodes = nodes;
+            auto* ret = stmts.size() == 1 ? dynamic_cast<ReturnStatement*>(stmts[0].get())
+                                          : nullptr;
+            candidate.singleReturn = ret && ret->value && writes.written.empty();
+            m_candidates[fn->name] = candidate;
+        }
+    }
+
+    const Inliner::Candidate* Inliner::candidateFor(Expression* expr) const {
+        auto call = dynamic_cast<CallExpression*>(expr);
+        if (!call)
+            return nullptr;
+        auto callee = dynamic_cast<VariableExpression*>(call->callee.get());
+        if (!callee)
+            return nullptr;
+        auto it = m_candidates.find(callee->name);
+        if (it == m_candidates.end() ||
+            it->second.fn->params.size() != call->arguments.size())
+            return nullptr;
+        if (m_grown + it->second.nodes > m_maxGrowthNodes)
+            return nullptr;
+        return &it->second;
+    }
+
+    void Inliner::rewriteBody(BlockStatement* body) {
+        if (!body)
+            return;
+        m_grown = 0;
+        rewriteStatements(body->statements);
+    }
+
+    void Inliner::rewriteSlot(std::unique_ptr<Statement>& slot) {
+        if (!slot)
+            return;
+        if (auto block = dynamic_cast<BlockStatement*>(slot.get())) {
+            rewriteStatements(block->statements);
+            return;
+        }
+        std::vector<std::unique_ptr<Statement>> stmts;
+        stmts.push_back(std::move(slot));
+        rewriteStatements(stmts);
+        if (stmts.size() == 1) {
+            slot = std::move(stmts.front());
+            return;
+        }
+        auto block = std::make_unique<BlockStatement>();
+        if (!stmts.empty()) {
+            block->line = stmts.front()->line;
+            block->column = stmts.front()->column;
+        }
+        block->statements = std::move(stmts);
+        slot = std::move(block);
+    }
+
+    void Inliner::rewriteStatements(std::vector<std::unique_ptr<Statement>>& stmts) {
+        for (size_t i = 0; i < stmts.size(); ++i) {
+            if (!stmts[i])
+                continue;
+            std::vector<std::unique_ptr<Statement>> replacement;
+            if (inlineStatement(stmts[i], replacement)) {
+                ++m_inlined;
+                stmts.erase(stmts.begin() + static_cast<std::ptrdiff_t>(i));
+                stmts.insert(stmts.begin() + static_cast<std::ptrdiff_t>(i),
+                             std::make_move_iterator(replacement.begin()),
+                             std::make_move_iterator(replacement.end()));
+                // The inlined body may itself call candidates.
+                --i;
+                continue;
+            }
+            forEachExpressionSlot(*stmts[i], [this](std::unique_ptr<Expression>& slot) {
+                rewriteExpression(slot);
+            });
+            rewriteChildren(*stmts[i]);
+        }
+    }
+
+    void Inliner::rewriteChildren(Statement& stmt) {
+        if (auto block = dynamic_cast<BlockStatement*>(&stmt)) {
+            rewriteStatements(block->statements);
+        } else if (auto ifs = dynamic_cast<IfStatement*>(&stmt)) {
+            rewriteSlot(ifs->thenBranch);
+            rewriteSlot(ifs->elseBranch);
+        } else if (auto tern = dynamic_cast<TernaryStatement*>(&stmt)) {
+            rewriteSlot(tern->thenBranch);
+            rewriteSlot(tern->elseBranch);
+        } else if (auto fors = dynamic_cast<ForStatement*>(&stmt)) {
+            if (fors->initializer) {
+                forEachExpressionSlot(*fors->initializer,
+                                      [this](std::unique_ptr<Expression>& slot) {
+                                          rewriteExpression(slot);
+                                      });
+            }
+            rewriteSlot(fors->body);
+        } else if (auto whiles = dynamic_cast<WhileStatement*>(&stmt)) {
+            rewriteSlot(whiles->body);
+        }
+    }
+
+    void Inliner::rewriteExpression(std::unique_ptr<Expression>& slot) {
+        if (!slot)
+            return;
+        const Candidate* candidate = candidateFor(slot.get());
+        if (candidate && candidate->singleReturn) {
+            auto call = static_cast<CallExpression*>(slot.get());
+            bool simple = true;
+            for (const auto& arg : call->arguments) simple = simple && isSimpleArgument(arg.get());
+            if (simple) {
+                CallSiteCloner cloner;
+                const auto& params = candidate->fn->params;
+                for (size_t i = 0; i < params.size(); ++i)
+                    cloner.arguments[params[i]->name] = call->arguments[i].get();
+                auto ret = static_cast<ReturnStatement*>(candidate->fn->body->statements[0].get());
+                slot = cloner.clone(ret->value.get());
+                m_grown += candidate->nodes;
+                ++m_inlined;
+                rewriteExpression(slot);
+                return;
+            }
+        }
+        forEachChildSlot(*slot, [this](std::unique_ptr<Expression>& child) {
+            rewriteExpression(child);
+        });
+    }
+
+    bool Inliner::inlineStatement(std::unique_ptr<Statement>& stmt,
+                                  std::vector<std::unique_ptr<Statement>>& out) {
+        // Where the callee's result goes: discarded, a new variable, or an
+        // existing one.
+        Expression* callExpr = nullptr;
+        VariableDeclaration* sinkDecl = nullptr;
+        std::string sinkName;
+        if (auto exprStmt = dynamic_cast<ExpressionStatement*>(stmt.get())) {
+            if (auto assign = dynamic_cast<AssignmentExpression*>(exprStmt->expression.get())) {
+                callExpr = assign->value.get();
+                sinkName = assign->name;
+            } else {
+                callExpr = exprStmt->expression.get();
+            }
+        } else if (auto assignStmt = dynamic_cast<AssignmentStatement*>(stmt.get())) {
+            callExpr = assignStmt->value.get();
+            sinkName = assignStmt->name;
+        } else if (auto decl = dynamic_cast<VariableDeclaration*>(stmt.get())) {
+            if (decl->isTracked || !decl->annotations.empty() ||
+                !isPlainValueType(decl->varType.get()))
+                return false;
+            callExpr = decl->initializer.get();
+            sinkDecl = decl;
+            sinkName = decl->name;
+        }
+        const Candidate* candidate = candidateFor(callExpr);
+        if (!candidate)
+            return false;
+        auto call = static_cast<CallExpression*>(callExpr);
+        FunctionDeclaration* fn = candidate->fn;
+        auto& body = fn->body->statements;
+        auto* trailing = body.empty() ? nullptr : dynamic_cast<ReturnStatement*>(body.back().get());
+        Expression* result = trailing ? trailing->value.get() : nullptr;
+        if (!sinkName.empty() && !result)
+            return false;
+        bool simpleArgs = true;
+        for (const auto& arg : call->arguments)
+            simpleArgs = simpleArgs && isSimpleArgument(arg.get());
+        // Single-expression functions are cheaper to substitute in place.
+        if (candidate->singleReturn && simpleArgs)
+            return false;
+
+        WriteSet writes = collectWrites(fn->body.get());
+        std::unordered_set<std::string> captured;
+        for (const auto& arg : call->arguments) {
+            collectNames(arg.get(), captured);
+            // Substituted arguments are read after every temporary is bound, so
+            // an argument that writes a variable would reorder that write.
+            if (!isSimpleArgument(arg.get()) && !collectWrites(arg.get()).written.empty())
+                return false;
+        }
+        if (!sinkName.empty())
+            captured.insert(sinkName);
+
+        CallSiteCloner cloner;
+        std::string suffix = "$inl" + std::to_string(m_nextId);
+        // Arguments that can fail are evaluated at the call, in order.
+        std::vector<std::unique_ptr<Statement>> bound;
+        bool declared = false;
+        for (size_t i = 0; i < fn->params.size(); ++i) {
+            const Parameter& param = *fn->params[i];
+            const Expression* arg = call->arguments[i].get();
+            if (isSimpleArgument(arg) && !writes.written.count(param.name)) {
+                cloner.arguments[param.name] = arg;
+                continue;
+            }
+            // Qubit parameters cannot be bound to a fresh variable: declaring
+            // one allocates a new qubit. An element is read once here instead,
+            // so a bad index still fails at the call, then substituted.
+            if (isQubitType(param.type.get())) {
+                if (!isElementArgument(arg) || writes.written.count(param.name))
+                    return false;
+                auto check = at(std::make_unique<ExpressionStatement>(), *arg);
+                check->expression = cloneExpression(arg);
+                bound.push_back(std::move(check));
+                cloner.arguments[param.name] = arg;
+                continue;
+            }
+            declared = true;
+            auto temp = at(std::make_unique<VariableDeclaration>(), *arg);
+            temp->name = param.name + suffix;
+            temp->varType = cloneType(param.type.get());
+            temp->isFinal = !writes.written.count(param.name);
+            temp->initializer = cloneExpression(arg);
+            cloner.renames[param.name] = temp->name;
+            bound.push_back(std::move(temp));
+        }
+        bool ownScope = declared;
+        for (const auto& s : body) {
+            if (dynamic_cast<VariableDeclaration*>(s.get()))
+                ownScope = true;
+        }
+        bool blocked = false;
+        forEachStatement(*fn->body, [&](Statement& s) {
+            auto var = dynamic_cast<VariableDeclaration*>(&s);
+            if (!var || !captured.count(var->name))
+                return;
+            // A renamed qubit would show its new name in diagnostics.
+            if (isQubitType(var->varType.get()))
+                blocked = true;
+            cloner.renames[var->name] = var->name + suffix;
+        });
+        if (blocked)
+            return false;
+        ++m_nextId;
+        m_grown += candidate->nodes;
+
+        std::vector<std::unique_ptr<Statement>> inlined = std::move(bound);
+        for (const auto& s : body) {
+            if (s.get() == trailing)
+                break;
+            inlined.push_back(cloner.clone(s.get()));
+        }
+        if (result) {
+            auto value = cloner.clone(result);
+            if (!sinkName.empty()) {
+                auto assign = at(std::make_unique<AssignmentExpression>(sinkName, std::move(value)),
+                                 *call);
+                auto exprStmt = at(std::make_unique<ExpressionStatement>(), *call);
+                exprStmt->expression = std::move(assign);
+                inlined.push_back(std::move(exprStmt));
+            } else if (!dynamic_cast<LiteralExpression*>(value.get()) &&
+                       !dynamic_cast<VariableExpression*>(value.get())) {
+                auto exprStmt = at(std::make_unique<ExpressionStatement>(), *call);
+                exprStmt->expression = std::move(value);
+                inlined.push_back(std::move(exprStmt));
+            }
+        }
+
+        // The block takes its position before resetting the initialiser
+        // frees the call.
+        std::unique_ptr<BlockStatement> block;
+        if (ownScope)
+            block = at(std::make_unique<BlockStatement>(), *call);
+        if (sinkDecl) {
+            sinkDecl->initializer.reset();
+            out.push_back(std::move(stmt));
+        }
+        if (block) {
+            block->statements = std::move(inlined);
+            out.push_back(std::move(block));
+        } else {
+            for (auto& s : inlined) out.push_back(std::move(s));
+        }
+        return true;
+    }
+
+}  // namespace bloch::compiler
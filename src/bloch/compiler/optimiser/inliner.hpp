@@ -0,0 +1,73 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "bloch/compiler/ast/ast.hpp"
+
+namespace bloch::compiler {
+
+    // Replaces calls to small, non-recursive free functions with the callee's
+    // body. A function whose body is a single `return expr;` is substituted
+    // wherever it is called; any other candidate (its only return being the
+    // last statement) is inlined where the call is a statement of its own,
+    // initialises a declaration, or is assigned to a variable.
+    //
+    // Arguments that are literals or variables are substituted directly;
+    // anything that can fail is bound to a `final` temporary at the call, in
+    // argument order, so its errors survive even if the callee never reads it.
+    // Callee locals are renamed only where they would capture a name used by
+    // the arguments. Inlined code keeps the callee's source
+    // positions, so runtime errors still point into the callee.
+    class Inliner {
+       public:
+        Inliner(int maxCalleeNodes, int maxGrowthNodes)
+            : m_maxCalleeNodes(maxCalleeNodes), m_maxGrowthNodes(maxGrowthNodes) {}
+
+        // Returns the number of call sites inlined.
+        int run(Program& program);
+
+       private:
+        struct Candidate {
+            FunctionDeclaration* fn = nullptr;
+            int nodes = 0;
+            bool singleReturn = false;  // body is exactly `return expr;`
+        };
+
+        int m_maxCalleeNodes;
+        int m_maxGrowthNodes;
+        std::unordered_map<std::string, Candidate> m_candidates;
+        int m_inlined = 0;
+        int m_grown = 0;
+        int m_nextId = 0;
+
+        void collectCandidates(Program& program);
+        void rewriteBody(BlockStatement* body);
+        void rewriteStatements(std::vector<std::unique_ptr<Statement>>& stmts);
+        void rewriteSlot(std::unique_ptr<Statement>& slot);
+        void rewriteChildren(Statement& stmt);
+        void rewriteExpression(std::unique_ptr<Expression>& slot);
+
+        const Candidate* candidateFor(Expression* expr) const;
+        bool inlineStatement(std::unique_ptr<Statement>& stmt,
+                             std::vector<std::unique_ptr<Statement>>& out);
+    };
+
+}  // namespace bloch::compiler
@@ -0,0 +1,437 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bloch/compiler/optimiser/optimiser.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+
+#include "bloch/compiler/ast/ast_clone.hpp"
+#include "bloch/compiler/optimiser/inliner.hpp"
+#include "bloch/compiler/optimiser/rewrite_utils.hpp"
+#include "bloch/compiler/semantics/const_eval.hpp"
+#include "bloch/support/error/bloch_error.hpp"
+
+namespace bloch::compiler {
+
+    using support::BlochError;
+
+    namespace {
+        // Copies a loop body with the induction variable replaced by a literal.
+        class InductionSubstituter : public AstCloner {
+           public:
+            InductionSubstituter(std::string name, int value)
+                : m_name(std::move(name)), m_value(value) {}
+
+           protected:
+            std::unique_ptr<Expression> substitute(const Expression& expr) override {
+                auto var = dynamic_cast<const VariableExpression*>(&expr);
+                if (!var || var->name != m_name)
+                    return nullptr;
+                auto lit = std::make_unique<LiteralExpression>(std::to_string(m_value), "int");
+                lit->line = var->line;
+                lit->column = var->column;
+                return lit;
+            }
+
+           private:
+            std::string m_name;
+            int m_value;
+        };
+
+        const std::string* primitiveName(Type* type) {
+            auto prim = dynamic_cast<PrimitiveType*>(type);
+            return prim ? &prim->name : nullptr;
+        }
+
+        bool isNumericType(const std::string& name) {
+            return name == "int" || name == "long" || name == "float";
+        }
+
+        bool isLiteralLeaf(Expression* expr) {
+            return dynamic_cast<LiteralExpression*>(expr) ||
+                   dynamic_cast<VariableExpression*>(expr);
+        }
+    }  // namespace
+
+    OptimiserStats Optimiser::optimise(Program& program) {
+        m_stats = {};
+        if (m_options.inlineCalls) {
+            Inliner inliner(m_options.maxInlineNodes, m_options.maxInlineGrowth);
+            m_stats.callsInlined = inliner.run(program);
+        }
+        for (auto& fn : program.functions) optimiseBody(fn->params, fn->body.get());
+        for (auto& cls : program.classes) {
+            for (auto& member : cls->members) {
+                if (auto method = dynamic_cast<MethodDeclaration*>(member.get())) {
+                    optimiseBody(method->params, method->body.get());
+                } else if (auto ctor = dynamic_cast<ConstructorDeclaration*>(member.get())) {
+                    optimiseBody(ctor->params, ctor->body.get());
+                } else if (auto dtor = dynamic_cast<DestructorDeclaration*>(member.get())) {
+                    optimiseBody({}, dtor->body.get());
+                }
+            }
+        }
+        return m_stats;
+    }
+
+    void Optimiser::optimiseBody(const std::vector<std::unique_ptr<Parameter>>& params,
+                                 BlockStatement* body) {
+        if (!body)
+            return;
+        m_scopes.clear();
+        m_scopes.emplace_back();
+        m_unrolledNodes = 0;
+        for (const auto& param : params) {
+            LocalInfo info;
+            if (auto name = primitiveName(param->type.get()); name && isNumericType(*name))
+                info.numericType = *name;
+            declare(param->name, info);
+        }
+        m_scopes.emplace_back();
+        rewriteStatements(body->statements);
+        m_scopes.clear();
+    }
+
+    void Optimiser::declare(const std::string& name, LocalInfo info) {
+        if (!m_scopes.empty())
+            m_scopes.back()[name] = std::move(info);
+    }
+
+    const Optimiser::LocalInfo* Optimiser::findLocal(const std::string& name) const {
+        for (auto it = m_scopes.rbegin(); it != m_scopes.rend(); ++it) {
+            auto found = it->find(name);
+            if (found != it->end())
+                return &found->second;
+        }
+        return nullptr;
+    }
+
+    std::optional<int> Optimiser::constantOf(Expression* expr) const {
+        auto resolve = [this](VariableExpression& var) -> std::optional<int> {
+            const LocalInfo* info = findLocal(var.name);
+            return info ? info->constant : std::nullopt;
+        };
+        try {
+            // int/int is a float at runtime, so '/' never folds here.
+            return evaluateConstInt(expr, resolve, false);
+        } catch (const BlochError&) {
+            // Modulo by zero: leave it for the runtime to report.
+            return std::nullopt;
+        }
+    }
+
+    void Optimiser::foldConstants(std::unique_ptr<Expression>& slot) const {
+        if (!slot || dynamic_cast<LiteralExpression*>(slot.get()))
+            return;
+        bool foldable = dynamic_cast<BinaryExpression*>(slot.get()) ||
+                        dynamic_cast<UnaryExpression*>(slot.get()) ||
+                        dynamic_cast<CastExpression*>(slot.get()) ||
+                        dynamic_cast<ParenthesizedExpression*>(slot.get());
+        if (foldable) {
+            if (auto value = constantOf(slot.get())) {
+                auto lit = std::make_unique<LiteralExpression>(std::to_string(*value), "int");
+                lit->line = slot->line;
+                lit->column = slot->column;
+                slot = std::move(lit);
+                return;
+            }
+        }
+        forEachChildSlot(*slot, [this](std::unique_ptr<Expression>& child) {
+            foldConstants(child);
+        });
+    }
+
+    void Optimiser::rewriteSlot(std::unique_ptr<Statement>& slot) {
+        if (!slot)
+            return;
+        if (auto block = dynamic_cast<BlockStatement*>(slot.get())) {
+            m_scopes.emplace_back();
+            rewriteStatements(block->statements);
+            m_scopes.pop_back();
+            return;
+        }
+        // A lone statement (e.g. an unbraced if-branch) may expand into
+        // several; only then does it need a block of its own.
+        std::vector<std::unique_ptr<Statement>> stmts;
+        stmts.push_back(std::move(slot));
+        rewriteStatements(stmts);
+        if (stmts.size() == 1) {
+            slot = std::move(stmts.front());
+            return;
+        }
+        auto block = std::make_unique<BlockStatement>();
+        if (!stmts.empty()) {
+            block->line = stmts.front()->line;
+            block->column = stmts.front()->column;
+        }
+        block->statements = std::move(stmts);
+        slot = std::move(block);
+    }
+
+    void Optimiser::rewriteStatements(std::vector<std::unique_ptr<Statement>>& stmts) {
+        for (size_t i = 0; i < stmts.size(); ++i) {
+            Statement* stmt = stmts[i].get();
+            if (!stmt)
+                continue;
+            if (auto fors = dynamic_cast<ForStatement*>(stmt); fors && m_options.unrollLoops) {
+                std::vector<std::unique_ptr<Statement>> copies;
+                if (tryUnroll(*fors, copies)) {
+                    ++m_stats.loopsUnrolled;
+                    stmts.erase(stmts.begin() + static_cast<std::ptrdiff_t>(i));
+                    stmts.insert(stmts.begin() + static_cast<std::ptrdiff_t>(i),
+                                 std::make_move_iterator(copies.begin()),
+                                 std::make_move_iterator(copies.end()));
+                    // Revisit the copies: nested loops may now have constant bounds.
+                    --i;
+                    continue;
+                }
+            }
+            if (m_options.hoistInvariants &&
+                (dynamic_cast<ForStatement*>(stmt) || dynamic_cast<WhileStatement*>(stmt))) {
+                std::vector<std::unique_ptr<Statement>> hoisted;
+                hoistInvariants(*stmt, hoisted);
+                if (!hoisted.empty()) {
+                    size_t count = hoisted.size();
+                    stmts.insert(stmts.begin() + static_cast<std::ptrdiff_t>(i),
+                                 std::make_move_iterator(hoisted.begin()),
+                                 std::make_move_iterator(hoisted.end()));
+                    i += count;
+                }
+            }
+            rewriteChildren(*stmts[i]);
+        }
+    }
+
+    void Optimiser::rewriteChildren(Statement& stmt) {
+        if (auto var = dynamic_cast<VariableDeclaration*>(&stmt)) {
+            LocalInfo info;
+            const std::string* type = primitiveName(var->varType.get());
+            if (var->isFinal && type && *type == "int")
+                info.constant = constantOf(var->initializer.get());
+            if (type && isNumericType(*type) && var->initializer && !var->isTracked)
+                info.numericType = *type;
+            declare(var->name, info);
+        } else if (auto block = dynamic_cast<BlockStatement*>(&stmt)) {
+            m_scopes.emplace_back();
+            rewriteStatements(block->statements);
+            m_scopes.pop_back();
+        } else if (auto ifs = dynamic_cast<IfStatement*>(&stmt)) {
+            rewriteSlot(ifs->thenBranch);
+            rewriteSlot(ifs->elseBranch);
+        } else if (auto tern = dynamic_cast<TernaryStatement*>(&stmt)) {
+            rewriteSlot(tern->thenBranch);
+            rewriteSlot(tern->elseBranch);
+        } else if (auto fors = dynamic_cast<ForStatement*>(&stmt)) {
+            m_scopes.emplace_back();
+            if (fors->initializer)
+                rewriteChildren(*fors->initializer);
+            rewriteSlot(fors->body);
+            m_scopes.pop_back();
+        } else if (auto whiles = dynamic_cast<WhileStatement*>(&stmt)) {
+            rewriteSlot(whiles->body);
+        }
+    }
+
+    bool Optimiser::tryUnroll(ForStatement& loop, std::vector<std::unique_ptr<Statement>>& out) {
+        // for (int i = A; i <op> B; i++ | i-- | i = i +/- C) body
+        auto init = dynamic_cast<VariableDeclaration*>(loop.initializer.get());
+        if (!init || init->isTracked || !init->annotations.empty() || !loop.body)
+            return false;
+        const std::string* initType = primitiveName(init->varType.get());
+        if (!initType || *initType != "int")
+            return false;
+        const std::string& name = init->name;
+        auto start = constantOf(init->initializer.get());
+        if (!start)
+            return false;
+
+        auto cond = dynamic_cast<BinaryExpression*>(loop.condition.get());
+        if (!cond)
+            return false;
+        auto condVar = dynamic_cast<VariableExpression*>(cond->left.get());
+        if (!condVar || condVar->name != name)
+            return false;
+        const std::string& op = cond->op;
+        if (op != "<" && op != "<=" && op != ">" && op != ">=" && op != "!=")
+            return false;
+        auto bound = constantOf(cond->right.get());
+        if (!bound)
+            return false;
+
+        std::int64_t step = 0;
+        if (auto post = dynamic_cast<PostfixExpression*>(loop.increment.get())) {
+            auto var = dynamic_cast<VariableExpression*>(post->left.get());
+            if (!var || var->name != name)
+                return false;
+            step = post->op == "++" ? 1 : -1;
+        } else if (auto assign = dynamic_cast<AssignmentExpression*>(loop.increment.get())) {
+            auto rhs = dynamic_cast<BinaryExpression*>(assign->value.get());
+            if (assign->name != name || !rhs || (rhs->op != "+" && rhs->op != "-"))
+                return false;
+            auto rhsVar = dynamic_cast<VariableExpression*>(rhs->left.get());
+            auto amount = constantOf(rhs->right.get());
+            if (!rhsVar || rhsVar->name != name || !amount)
+                return false;
+            step = rhs->op == "+" ? *amount : -static_cast<std::int64_t>(*amount);
+        } else {
+            return false;
+        }
+        if (step == 0)
+            return false;
+
+        WriteSet writes = collectWrites(loop.body.get());
+        if (writes.written.count(name))
+            return false;
+
+        auto holds = [&](std::int64_t v) {
+            std::int64_t b = *bound;
+            if (op == "<")
+                return v < b;
+            if (op == "<=")
+                return v <= b;
+            if (op == ">")
+                return v > b;
+            if (op == ">=")
+                return v >= b;
+            return v != b;
+        };
+        std::vector<int> values;
+        for (std::int64_t v = *start; holds(v); v += step) {
+            if (static_cast<int>(values.size()) >= m_options.maxUnrollTrips ||
+                v < std::numeric_limits<int>::min() || v > std::numeric_limits<int>::max())
+                return false;
+            values.push_back(static_cast<int>(v));
+        }
+        std::int64_t added =
+            static_cast<std::int64_t>(countNodes(loop.body.get())) * std::ssize(values);
+        if (m_unrolledNodes + added > m_options.maxUnrollNodes)
+            return false;
+        m_unrolledNodes += added;
+
+        for (int value : values) {
+            InductionSubstituter substituter(name, value);
+            std::unique_ptr<Statement> copy = substituter.clone(loop.body.get());
+            if (!copy)
+                return false;
+            forEachStatement(*copy, [this](Statement& s) {
+                forEachExpressionSlot(
+                    s, [this](std::unique_ptr<Expression>& slot) { foldConstants(slot); });
+            });
+            auto block = dynamic_cast<BlockStatement*>(copy.get());
+            bool declares = false;
+            if (block) {
+                for (const auto& s : block->statements)
+                    declares = declares || dynamic_cast<VariableDeclaration*>(s.get());
+            }
+            // Each iteration of the loop had a scope of its own; keep one only
+            // when the body declares something that must not leak or collide.
+            if (block && !declares) {
+                for (auto& s : block->statements) out.push_back(std::move(s));
+            } else if (!block && dynamic_cast<VariableDeclaration*>(copy.get())) {
+                auto wrapper = std::make_unique<BlockStatement>();
+                wrapper->line = copy->line;
+                wrapper->column = copy->column;
+                wrapper->statements.push_back(std::move(copy));
+                out.push_back(std::move(wrapper));
+            } else {
+                out.push_back(std::move(copy));
+            }
+        }
+        return true;
+    }
+
+    void Optimiser::hoistInvariants(Statement& loop, std::vector<std::unique_ptr<Statement>>& out) {
+        WriteSet writes = collectWrites(&loop);
+
+        // The numeric type of an invariant expression, or empty if it is not one.
+        std::function<std::string(Expression*)> invariantType =
+            [&](Expression* expr) -> std::string {
+            if (auto lit = dynamic_cast<LiteralExpression*>(expr))
+                return isNumericType(lit->literalType) ? lit->literalType : "";
+            if (auto var = dynamic_cast<VariableExpression*>(expr)) {
+                if (writes.written.count(var->name) || writes.declared.count(var->name))
+                    return "";
+                const LocalInfo* info = findLocal(var->name);
+                return info ? info->numericType : "";
+            }
+            if (auto paren = dynamic_cast<ParenthesizedExpression*>(expr))
+                return invariantType(paren->expression.get());
+            if (auto unary = dynamic_cast<UnaryExpression*>(expr))
+                return unary->op == "-" ? invariantType(unary->right.get()) : "";
+            if (auto bin = dynamic_cast<BinaryExpression*>(expr)) {
+                // '/' and '%' can throw, so they stay where the program put them.
+                if (bin->op != "+" && bin->op != "-" && bin->op != "*")
+                    return "";
+                std::string l = invariantType(bin->left.get());
+                std::string r = l.empty() ? "" : invariantType(bin->right.get());
+                if (l.empty() || r.empty())
+                    return "";
+                if (l == "float" || r == "float")
+                    return "float";
+                return (l == "long" || r == "long") ? "long" : "int";
+            }
+            return "";
+        };
+        auto readsVariable = [](Expression* expr) {
+            bool found = false;
+            std::function<void(Expression*)> scan = [&](Expression* e) {
+                if (dynamic_cast<VariableExpression*>(e))
+                    found = true;
+                else
+                    forEachChildSlot(*e, [&](std::unique_ptr<Expression>& c) { scan(c.get()); });
+            };
+            scan(expr);
+            return found;
+        };
+
+        std::function<void(std::unique_ptr<Expression>&)> hoist =
+            [&](std::unique_ptr<Expression>& slot) {
+                if (!slot)
+                    return;
+                if (!isLiteralLeaf(slot.get()) && readsVariable(slot.get())) {
+                    std::string type = invariantType(slot.get());
+                    if (!type.empty()) {
+                        auto decl = std::make_unique<VariableDeclaration>();
+                        decl->line = slot->line;
+                        decl->column = slot->column;
+                        decl->name = "$hoist" + std::to_string(m_nextTemp++);
+                        decl->isFinal = true;
+                        decl->varType = std::make_unique<PrimitiveType>(type);
+                        auto ref = std::make_unique<VariableExpression>(decl->name);
+                        ref->line = slot->line;
+                        ref->column = slot->column;
+                        decl->initializer = std::move(slot);
+                        slot = std::move(ref);
+                        out.push_back(std::move(decl));
+                        ++m_stats.expressionsHoisted;
+                        return;
+                    }
+                }
+                forEachChildSlot(*slot, hoist);
+            };
+
+        // A for-initialiser runs once anyway; hoisting from it gains nothing.
+        Statement* init = nullptr;
+        if (auto fors = dynamic_cast<ForStatement*>(&loop))
+            init = fors->initializer.get();
+        forEachStatement(loop, [&](Statement& s) {
+            if (&s != init)
+                forEachExpressionSlot(s, hoist);
+        });
+    }
+
+}  // namespace bloch::compiler
@@ -0,0 +1,90 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bloch/compiler/ast/ast.hpp"
+
+namespace bloch::compiler {
+
+    struct OptimiserOptions {
+        bool inlineCalls = true;
+        // Only functions of at most this many AST nodes are inlined...
+        int maxInlineNodes = 64;
+        // ...and inlining into one function body adds at most this many nodes.
+        int maxInlineGrowth = 4096;
+        bool unrollLoops = true;
+        bool hoistInvariants = true;
+        // A loop is unrolled only if it runs at most this many times...
+        int maxUnrollTrips = 64;
+        // ...and unrolling in one function body adds at most this many AST nodes.
+        int maxUnrollNodes = 4096;
+    };
+
+    struct OptimiserStats {
+        int callsInlined = 0;
+        int loopsUnrolled = 0;
+        int expressionsHoisted = 0;
+    };
+
+    // AST-to-AST rewrites run after semantic analysis. Every rewrite keeps
+    // the observable behaviour of the program (output, gate order, errors)
+    // and only reduces the work the tree-walking runtime does:
+    //  - calls to small non-recursive functions are replaced by the callee's
+    //    body (see Inliner), which also exposes their loops to the passes below;
+    //  - `for` loops with constant int bounds and a constant step are fully
+    //    unrolled, with the loop variable substituted and folded;
+    //  - pure arithmetic over locals that a loop never writes is evaluated
+    //    once before the loop into a `final` temporary.
+    class Optimiser {
+       public:
+        explicit Optimiser(OptimiserOptions options = {}) : m_options(options) {}
+
+        OptimiserStats optimise(Program& program);
+
+       private:
+        struct LocalInfo {
+            std::optional<int> constant;  // final int with a foldable initialiser
+            std::string numericType;      // "int"/"long"/"float" when hoistable
+        };
+
+        OptimiserOptions m_options;
+        OptimiserStats m_stats;
+        std::vector<std::unordered_map<std::string, LocalInfo>> m_scopes;
+        int m_nextTemp = 0;
+        std::int64_t m_unrolledNodes = 0;
+
+        void optimiseBody(const std::vector<std::unique_ptr<Parameter>>& params,
+                          BlockStatement* body);
+        void rewriteStatements(std::vector<std::unique_ptr<Statement>>& stmts);
+        void rewriteSlot(std::unique_ptr<Statement>& slot);
+        void rewriteChildren(Statement& stmt);
+
+        bool tryUnroll(ForStatement& loop, std::vector<std::unique_ptr<Statement>>& out);
+        void hoistInvariants(Statement& loop, std::vector<std::unique_ptr<Statement>>& out);
+
+        void declare(const std::string& name, LocalInfo info);
+        const LocalInfo* findLocal(const std::string& name) const;
+        std::optional<int> constantOf(Expression* expr) const;
+        void foldConstants(std::unique_ptr<Expression>& slot) const;
+    };
+
+}  // namespace bloch::compiler
@@ -0,0 +1,201 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "bloch/compiler/ast/ast.hpp"
+#include "bloch/compiler/ast/recursive_ast_visitor.hpp"
+
+// Helpers shared by the AST rewriting passes. The slot walkers hand out the
+// owning unique_ptr so a pass can replace a node in place.
+namespace bloch::compiler {
+
+    // Direct expression slots owned by a statement (nested statements excluded).
+    template <typename F>
+    void forEachExpressionSlot(Statement& stmt, F&& fn) {
+        if (auto var = dynamic_cast<VariableDeclaration*>(&stmt)) {
+            if (var->initializer)
+                fn(var->initializer);
+        } else if (auto exprStmt = dynamic_cast<ExpressionStatement*>(&stmt)) {
+            fn(exprStmt->expression);
+        } else if (auto ret = dynamic_cast<ReturnStatement*>(&stmt)) {
+            if (ret->value)
+                fn(ret->value);
+        } else if (auto ifs = dynamic_cast<IfStatement*>(&stmt)) {
+            fn(ifs->condition);
+        } else if (auto tern = dynamic_cast<TernaryStatement*>(&stmt)) {
+            fn(tern->condition);
+        } else if (auto fors = dynamic_cast<ForStatement*>(&stmt)) {
+            if (fors->condition)
+                fn(fors->condition);
+            if (fors->increment)
+                fn(fors->increment);
+        } else if (auto whiles = dynamic_cast<WhileStatement*>(&stmt)) {
+            if (whiles->condition)
+                fn(whiles->condition);
+        } else if (auto echo = dynamic_cast<EchoStatement*>(&stmt)) {
+            fn(echo->value);
+        } else if (auto reset = dynamic_cast<ResetStatement*>(&stmt)) {
+            fn(reset->target);
+        } else if (auto meas = dynamic_cast<MeasureStatement*>(&stmt)) {
+            fn(meas->qubit);
+        } else if (auto assign = dynamic_cast<AssignmentStatement*>(&stmt)) {
+            fn(assign->value);
+        }
+    }
+
+    // Direct sub-expression slots of an expression.
+    template <typename F>
+    void forEachChildSlot(Expression& expr, F&& fn) {
+        auto each = [&fn](std::vector<std::unique_ptr<Expression>>& list) {
+            for (auto& item : list) fn(item);
+        };
+        if (auto bin = dynamic_cast<BinaryExpression*>(&expr)) {
+            fn(bin->left);
+            fn(bin->right);
+        } else if (auto unary = dynamic_cast<UnaryExpression*>(&expr)) {
+            fn(unary->right);
+        } else if (auto cast = dynamic_cast<CastExpression*>(&expr)) {
+            fn(cast->expression);
+        } else if (auto post = dynamic_cast<PostfixExpression*>(&expr)) {
+            fn(post->left);
+        } else if (auto call = dynamic_cast<CallExpression*>(&expr)) {
+            each(call->arguments);
+        } else if (auto mem = dynamic_cast<MemberAccessExpression*>(&expr)) {
+            fn(mem->object);
+        } else if (auto newExpr = dynamic_cast<NewExpression*>(&expr)) {
+            each(newExpr->arguments);
+        } else if (auto idx = dynamic_cast<IndexExpression*>(&expr)) {
+            fn(idx->collection);
+            fn(idx->index);
+        } else if (auto arr = dynamic_cast<ArrayLiteralExpression*>(&expr)) {
+            each(arr->elements);
+        } else if (auto paren = dynamic_cast<ParenthesizedExpression*>(&expr)) {
+            fn(paren->expression);
+        } else if (auto meas = dynamic_cast<MeasureExpression*>(&expr)) {
+            fn(meas->qubit);
+        } else if (auto assign = dynamic_cast<AssignmentExpression*>(&expr)) {
+            fn(assign->value);
+        } else if (auto memAssign = dynamic_cast<MemberAssignmentExpression*>(&expr)) {
+            fn(memAssign->object);
+            fn(memAssign->value);
+        } else if (auto arrAssign = dynamic_cast<ArrayAssignmentExpression*>(&expr)) {
+            fn(arrAssign->collection);
+            fn(arrAssign->index);
+            fn(arrAssign->value);
+        }
+    }
+
+    // Every statement nested anywhere below `stmt`, for per-statement slot walks.
+    template <typename F>
+    void forEachStatement(Statement& stmt, F&& fn) {
+        fn(stmt);
+        auto visitChild = [&fn](std::unique_ptr<Statement>& child) {
+            if (child)
+                forEachStatement(*child, fn);
+        };
+        if (auto block = dynamic_cast<BlockStatement*>(&stmt)) {
+            for (auto& child : block->statements) visitChild(child);
+        } else if (auto ifs = dynamic_cast<IfStatement*>(&stmt)) {
+            visitChild(ifs->thenBranch);
+            visitChild(ifs->elseBranch);
+        } else if (auto tern = dynamic_cast<TernaryStatement*>(&stmt)) {
+            visitChild(tern->thenBranch);
+            visitChild(tern->elseBranch);
+        } else if (auto fors = dynamic_cast<ForStatement*>(&stmt)) {
+            visitChild(fors->initializer);
+            visitChild(fors->body);
+        } else if (auto whiles = dynamic_cast<WhileStatement*>(&stmt)) {
+            visitChild(whiles->body);
+        }
+    }
+
+    // Names a subtree assigns to (including ++/--, element writes and destroy)
+    // and names it declares.
+    struct WriteSet {
+        std::unordered_set<std::string> written;
+        std::unordered_set<std::string> declared;
+    };
+
+    namespace detail {
+        class WriteCollector : public RecursiveASTVisitor {
+           public:
+            WriteSet result;
+
+            void collect(ASTNode* node) { walk(node); }
+
+            void visit(VariableDeclaration& node) override {
+                result.declared.insert(node.name);
+                RecursiveASTVisitor::visit(node);
+            }
+            void visit(AssignmentStatement& node) override {
+                result.written.insert(node.name);
+                RecursiveASTVisitor::visit(node);
+            }
+            void visit(AssignmentExpression& node) override {
+                result.written.insert(node.name);
+                RecursiveASTVisitor::visit(node);
+            }
+            void visit(PostfixExpression& node) override {
+                if (auto var = dynamic_cast<VariableExpression*>(node.left.get()))
+                    result.written.insert(var->name);
+                RecursiveASTVisitor::visit(node);
+            }
+            void visit(ArrayAssignmentExpression& node) override {
+                if (auto var = dynamic_cast<VariableExpression*>(node.collection.get()))
+                    result.written.insert(var->name);
+                RecursiveASTVisitor::visit(node);
+            }
+            void visit(DestroyStatement& node) override {
+                if (auto var = dynamic_cast<VariableExpression*>(node.target.get()))
+                    result.written.insert(var->name);
+                RecursiveASTVisitor::visit(node);
+            }
+        };
+
+        class NodeCounter : public RecursiveASTVisitor {
+           public:
+            int count = 0;
+
+            void run(ASTNode* node) { walk(node); }
+
+           protected:
+            void walk(ASTNode* node) override {
+                if (!node)
+                    return;
+                ++count;
+                RecursiveASTVisitor::walk(node);
+            }
+        };
+    }  // namespace detail
+
+    inline WriteSet collectWrites(ASTNode* node) {
+        detail::WriteCollector collector;
+        collector.collect(node);
+        return std::move(collector.result);
+    }
+
+    // Number of AST nodes in a subtree; the size measure for code-growth budgets.
+    inline int countNodes(ASTNode* node) {
+        detail::NodeCounter counter;
+        counter.run(node);
+        return counter.count;
+    }
+
+}  // namespace bloch::compiler
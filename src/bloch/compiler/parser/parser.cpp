@@ -757,12 +757,15 @@ namespace bloch::compiler {
         if (check(TokenType::Identifier) && checkNext(TokenType::Equals))
             return parseAssignment();
 
+        const Token& start = peek();
         std::unique_ptr<Expression> expr = parseExpression();
         if (match(TokenType::Question)) {
             std::unique_ptr<Statement> thenBranch = parseStatement();
             (void)expect(TokenType::Colon, "Expected ':' after true branch");
             std::unique_ptr<Statement> elseBranch = parseStatement();
             std::unique_ptr<TernaryStatement> stmt = std::make_unique<TernaryStatement>();
+            stmt->line = start.line;
+            stmt->column = start.column;
             stmt->condition = std::move(expr);
             stmt->thenBranch = std::move(thenBranch);
             stmt->elseBranch = std::move(elseBranch);
@@ -771,6 +774,8 @@ namespace bloch::compiler {
 
         (void)expect(TokenType::Semicolon, "Expected ';' after expression");
         std::unique_ptr<ExpressionStatement> stmt = std::make_unique<ExpressionStatement>();
+        stmt->line = start.line;
+        stmt->column = start.column;
         stmt->expression = std::move(expr);
         return stmt;
     }
@@ -807,6 +812,7 @@ namespace bloch::compiler {
 
     // if (cond) {...} else {...}
     std::unique_ptr<IfStatement> Parser::parseIf() {
+        const Token& keyword = previous();
         (void)expect(TokenType::LParen, "Expected '(' after 'if'");
         std::unique_ptr<Expression> condition = parseExpression();
         (void)expect(TokenType::RParen, "Expected ')' after condition");
@@ -819,6 +825,8 @@ namespace bloch::compiler {
         }
 
         std::unique_ptr<IfStatement> stmt = std::make_unique<IfStatement>();
+        stmt->line = keyword.line;
+        stmt->column = keyword.column;
         stmt->condition = std::move(condition);
         stmt->thenBranch = std::move(thenBranch);
         stmt->elseBranch = std::move(elseBranch);
@@ -827,6 +835,7 @@ namespace bloch::compiler {
 
     // for (init; cond; update) {...}
     std::unique_ptr<ForStatement> Parser::parseFor() {
+        const Token& keyword = previous();
         (void)expect(TokenType::LParen, "Expected '(' after 'for'");
 
         std::unique_ptr<Statement> initializer = nullptr;
@@ -856,6 +865,8 @@ namespace bloch::compiler {
         std::unique_ptr<BlockStatement> body = parseBlock();
 
         std::unique_ptr<ForStatement> stmt = std::make_unique<ForStatement>();
+        stmt->line = keyword.line;
+        stmt->column = keyword.column;
         stmt->initializer = std::move(initializer);
         stmt->condition = std::move(condition);
         stmt->increment = std::move(increment);
@@ -866,12 +877,15 @@ namespace bloch::compiler {
 
     // while (cond) {...}
     std::unique_ptr<WhileStatement> Parser::parseWhile() {
+        const Token& keyword = previous();
         (void)expect(TokenType::LParen, "Expected '(' after 'while'");
         std::unique_ptr<Expression> condition = parseExpression();
         (void)expect(TokenType::RParen, "Expected ')' after condition");
         std::unique_ptr<BlockStatement> body = parseBlock();
 
         std::unique_ptr<WhileStatement> stmt = std::make_unique<WhileStatement>();
+        stmt->line = keyword.line;
+        stmt->column = keyword.column;
         stmt->condition = std::move(condition);
         stmt->body = std::move(body);
         return stmt;
@@ -946,9 +960,12 @@ namespace bloch::compiler {
     }
 
     std::unique_ptr<ExpressionStatement> Parser::parseExpressionStatement() {
+        const Token& start = peek();
         std::unique_ptr<Expression> expr = parseExpression();
         (void)expect(TokenType::Semicolon, "Expected ';' after expression");
         std::unique_ptr<ExpressionStatement> stmt = std::make_unique<ExpressionStatement>();
+        stmt->line = start.line;
+        stmt->column = start.column;
         stmt->expression = std::move(expr);
         return stmt;
     }
@@ -0,0 +1,99 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bloch/compiler/semantics/const_eval.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "bloch/support/error/bloch_error.hpp"
+
+namespace bloch::compiler {
+
+    using support::BlochError;
+    using support::ErrorCategory;
+
+    namespace {
+        std::optional<int> narrow(std::int64_t value) {
+            if (value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max())
+                return std::nullopt;
+            return static_cast<int>(value);
+        }
+    }  // namespace
+
+    std::optional<int> evaluateConstInt(Expression* expr, const ConstIntResolver& resolve,
+                                        bool integerDivision) {
+        if (!expr)
+            return std::nullopt;
+        if (auto lit = dynamic_cast<LiteralExpression*>(expr)) {
+            if (lit->literalType != "int")
+                return std::nullopt;
+            try {
+                return std::stoi(lit->value);
+            } catch (...) {
+                return std::nullopt;
+            }
+        }
+        if (auto var = dynamic_cast<VariableExpression*>(expr))
+            return resolve ? resolve(*var) : std::nullopt;
+        if (auto par = dynamic_cast<ParenthesizedExpression*>(expr))
+            return evaluateConstInt(par->expression.get(), resolve, integerDivision);
+        if (auto unary = dynamic_cast<UnaryExpression*>(expr)) {
+            if (unary->op == "-") {
+                auto val = evaluateConstInt(unary->right.get(), resolve, integerDivision);
+                if (val)
+                    return narrow(-static_cast<std::int64_t>(*val));
+            }
+            return std::nullopt;
+        }
+        if (auto cast = dynamic_cast<CastExpression*>(expr)) {
+            auto prim = dynamic_cast<PrimitiveType*>(cast->targetType.get());
+            if (prim && prim->name == "int")
+                return evaluateConstInt(cast->expression.get(), resolve, integerDivision);
+            return std::nullopt;
+        }
+        if (auto bin = dynamic_cast<BinaryExpression*>(expr)) {
+            if (bin->op == "/" && !integerDivision)
+                return std::nullopt;
+            auto left = evaluateConstInt(bin->left.get(), resolve, integerDivision);
+            auto right = evaluateConstInt(bin->right.get(), resolve, integerDivision);
+            if (!left || !right)
+                return std::nullopt;
+            std::int64_t l = *left;
+            std::int64_t r = *right;
+            if (bin->op == "+")
+                return narrow(l + r);
+            if (bin->op == "-")
+                return narrow(l - r);
+            if (bin->op == "*")
+                return narrow(l * r);
+            if (bin->op == "/") {
+                if (r == 0)
+                    throw BlochError(ErrorCategory::Semantic, bin->line, bin->column,
+                                     "division by zero in constant integer expression");
+                return narrow(l / r);
+            }
+            if (bin->op == "%") {
+                if (r == 0)
+                    throw BlochError(ErrorCategory::Semantic, bin->line, bin->column,
+                                     "modulo by zero in constant integer expression");
+                return narrow(l % r);
+            }
+            return std::nullopt;
+        }
+        return std::nullopt;
+    }
+
+}  // namespace bloch::compiler
@@ -0,0 +1,37 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <functional>
+#include <optional>
+
+#include "bloch/compiler/ast/ast.hpp"
+
+namespace bloch::compiler {
+
+    // Resolves a variable reference to its compile-time integer value, or
+    // nullopt when the variable is not a known constant.
+    using ConstIntResolver = std::function<std::optional<int>(VariableExpression&)>;
+
+    // Fold an integer expression built from int literals, resolvable
+    // variables, parentheses, unary minus, casts to int and + - * / %.
+    // Results that overflow int are treated as non-constant. When
+    // `integerDivision` is false, '/' is never folded: at runtime int/int
+    // promotes to float, so only contexts that truncate (array sizes) may
+    // fold it. Division or modulo by zero throws a semantic BlochError.
+    std::optional<int> evaluateConstInt(Expression* expr, const ConstIntResolver& resolve,
+                                        bool integerDivision = true);
+
+}  // namespace bloch::compiler
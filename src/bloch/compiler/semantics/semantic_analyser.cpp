@@ -22,6 +22,7 @@
 #include <utility>
 
 #include "bloch/compiler/semantics/built_ins.hpp"
+#include "bloch/compiler/semantics/const_eval.hpp"
 
 namespace bloch::compiler {
 
@@ -1461,70 +1462,18 @@ namespace bloch::compiler {
     }
 
     std::optional<int> SemanticAnalyser::evaluateConstInt(Expression* expr) const {
-        if (!expr)
-            return std::nullopt;
-        if (auto lit = dynamic_cast<LiteralExpression*>(expr)) {
-            if (lit->literalType != "int")
-                return std::nullopt;
-            try {
-                return std::stoi(lit->value);
-            } catch (...) {
-                return std::nullopt;
-            }
-        }
-        if (auto var = dynamic_cast<VariableExpression*>(expr)) {
-            if (!isDeclared(var->name)) {
-                throw BlochError(ErrorCategory::Semantic, var->line, var->column,
-                                 "Variable '" + var->name + "' not declared");
+        auto resolve = [this](VariableExpression& var) -> std::optional<int> {
+            if (!isDeclared(var.name)) {
+                throw BlochError(ErrorCategory::Semantic, var.line, var.column,
+                                 "Variable '" + var.name + "' not declared");
             }
-            if (!isFinal(var->name))
-                return std::nullopt;
-            if (m_symbols.getType(var->name) != ValueType::Int)
+            if (!isFinal(var.name))
                 return std::nullopt;
-            return m_symbols.getConstInt(var->name);
-        }
-        if (auto par = dynamic_cast<ParenthesizedExpression*>(expr))
-            return evaluateConstInt(par->expression.get());
-        if (auto unary = dynamic_cast<UnaryExpression*>(expr)) {
-            if (unary->op == "-") {
-                auto val = evaluateConstInt(unary->right.get());
-                if (val)
-                    return -*val;
-            }
-            return std::nullopt;
-        }
-        if (auto cast = dynamic_cast<CastExpression*>(expr)) {
-            auto target = typeFromAst(cast->targetType.get());
-            if (target.value == ValueType::Int)
-                return evaluateConstInt(cast->expression.get());
-            return std::nullopt;
-        }
-        if (auto bin = dynamic_cast<BinaryExpression*>(expr)) {
-            auto left = evaluateConstInt(bin->left.get());
-            auto right = evaluateConstInt(bin->right.get());
-            if (!left || !right)
+            if (m_symbols.getType(var.name) != ValueType::Int)
                 return std::nullopt;
-            if (bin->op == "+")
-                return *left + *right;
-            if (bin->op == "-")
-                return *left - *right;
-            if (bin->op == "*")
-                return *left * *right;
-            if (bin->op == "/") {
-                if (*right == 0)
-                    throw BlochError(ErrorCategory::Semantic, bin->line, bin->column,
-                                     "division by zero in constant integer expression");
-                return *left / *right;
-            }
-            if (bin->op == "%") {
-                if (*right == 0)
-                    throw BlochError(ErrorCategory::Semantic, bin->line, bin->column,
-                                     "modulo by zero in constant integer expression");
-                return *left % *right;
-            }
-            return std::nullopt;
-        }
-        return std::nullopt;
+            return m_symbols.getConstInt(var.name);
+        };
+        return compiler::evaluateConstInt(expr, resolve);
     }
 
     void SemanticAnalyser::analyse(Program& program) {
@@ -0,0 +1,314 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "bloch/runtime/batched_simulator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace bloch::runtime {
+
+    BatchedSimulator::BatchedSimulator(int qubits, int lanes)
+        : m_qubits(qubits),
+          m_lanes(lanes),
+          m_re((size_t{1} << qubits) * lanes, 0.0),
+          m_im((size_t{1} << qubits) * lanes, 0.0) {
+        std::fill(m_re.begin(), m_re.begin() + lanes, 1.0);
+    }
+
+    void BatchedSimulator::clear() {
+        std::fill(m_re.begin(), m_re.end(), 0.0);
+        std::fill(m_im.begin(), m_im.end(), 0.0);
+        std::fill(m_re.begin(), m_re.begin() + m_lanes, 1.0);
+    }
+
+    void BatchedSimulator::apply(const GateOp& op) {
+        if (op.kind == GateKind::CX)
+            swapControlledAmplitudes(op.control, op.target);
+        else
+            applySingleQubitGate(op.target, gateMatrix(op.kind, op.theta));
+    }
+
+    void BatchedSimulator::apply(const GateOp& op, std::uint64_t lanes) {
+        const std::uint64_t all =
+            m_lanes == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << m_lanes) - 1;
+        lanes &= all;
+        if (lanes == all) {
+            apply(op);
+            return;
+        }
+        if (lanes == 0)
+            return;
+        m_mask.resize(m_lanes);
+        for (int s = 0; s < m_lanes; ++s) m_mask[s] = (lanes >> s) & 1u;
+        if (op.kind == GateKind::CX)
+            swapMaskedControlledAmplitudes(op.control, op.target);
+        else
+            applyMaskedSingleQubitGate(op.target, gateMatrix(op.kind, op.theta));
+    }
+
+    void BatchedSimulator::applySingleQubitGate(int q,
+                                                const std::array<std::complex<double>, 4>& m) {
+        const double m0r = m[0].real(), m0i = m[0].imag(), m1r = m[1].real(), m1i = m[1].imag();
+        const double m2r = m[2].real(), m2i = m[2].imag(), m3r = m[3].real(), m3i = m[3].imag();
+        // z and rz only rescale each half, at half the arithmetic.
+        const bool diagonal = m[1] == 0.0 && m[2] == 0.0;
+        const size_t lanes = m_lanes;
+        const size_t step = size_t{1} << q;
+        const size_t states = size_t{1} << m_qubits;
+        for (size_t i = 0; i < states; i += 2 * step) {
+            for (size_t j = i; j < i + step; ++j) {
+                double* r0 = &m_re[j * lanes];
+                double* i0 = &m_im[j * lanes];
+                double* r1 = &m_re[(j + step) * lanes];
+                double* i1 = &m_im[(j + step) * lanes];
+                if (diagonal) {
+                    for (size_t s = 0; s < lanes; ++s) {
+                        double ar = r0[s], ai = i0[s], br = r1[s], bi = i1[s];
+                        r0[s] = m0r * ar - m0i * ai;
+                        i0[s] = m0r * ai + m0i * ar;
+                        r1[s] = m3r * br - m3i * bi;
+                        i1[s] = m3r * bi + m3i * br;
+                    }
+                } else {
+                    for (size_t s = 0; s < lanes; ++s) {
+                        double ar = r0[s], ai = i0[s], br = r1[s], bi = i1[s];
+                        r0[s] = m0r * ar - m0i * ai + m1r * br - m1i * bi;
+                        i0[s] = m0r * ai + m0i * ar + m1r * bi + m1i * br;
+                        r1[s] = m2r * ar - m2i * ai + m3r * br - m3i * bi;
+                        i1[s] = m2r * ai + m2i * ar + m3r * bi + m3i * br;
+                    }
+                }
+            }
+        }
+    }
+
+    void BatchedSimulator::swapControlledAmplitudes(int control, int target) {
+        const size_t lanes = m_lanes;
+        const size_t controlBit = size_t{1} << control;
+        const size_t targetBit = size_t{1} << target;
+        const size_t states = size_t{1} << m_qubits;
+        for (size_t i = 0; i < states; ++i) {
+            if (!(i & controlBit) || (i & targetBit))
+                continue;
+            size_t j = i | targetBit;
+            std::swap_ranges(&m_re[i * lanes], &m_re[i * lanes] + lanes, &m_re[j * lanes]);
+            std::swap_ranges(&m_im[i * lanes], &m_im[i * lanes] + lanes, &m_im[j * lanes]);
+        }
+    }
+
+    void BatchedSimulator::applyMaskedSingleQubitGate(
+        int q, const std::array<std::complex<double>, 4>& m) {
+        const double m0r = m[0].real(), m0i = m[0].imag(), m1r = m[1].real(), m1i = m[1].imag();
+        const double m2r = m[2].real(), m2i = m[2].imag(), m3r = m[3].real(), m3i = m[3].imag();
+        const unsigned char* mask = m_mask.data();
+        const size_t lanes = m_lanes;
+        const size_t step = size_t{1} << q;
+        const size_t states = size_t{1} << m_qubits;
+        for (size_t i = 0; i < states; i += 2 * step) {
+            for (size_t j = i; j < i + step; ++j) {
+                double* r0 = &m_re[j * lanes];
+                double* i0 = &m_im[j * lanes];
+                double* r1 = &m_re[(j + step) * lanes];
+                double* i1 = &m_im[(j + step) * lanes];
+                // Every lane computes the gate; the mask picks which keep it.
+                for (size_t s = 0; s < lanes; ++s) {
+                    double ar = r0[s], ai = i0[s], br = r1[s], bi = i1[s];
+                    double nr0 = m0r * ar - m0i * ai + m1r * br - m1i * bi;
+                    double ni0 = m0r * ai + m0i * ar + m1r * bi + m1i * br;
+                    double nr1 = m2r * ar - m2i * ai + m3r * br - m3i * bi;
+                    double ni1 = m2r * ai + m2i * ar + m3r * bi + m3i * br;
+                    r0[s] = mask[s] ? nr0 : ar;
+                    i0[s] = mask[s] ? ni0 : ai;
+                    r1[s] = mask[s] ? nr1 : br;
+                    i1[s] = mask[s] ? ni1 : bi;
+                }
+            }
+        }
+    }
+
+    void BatchedSimulator::swapMaskedControlledAmplitudes(int control, int target) {
+        const unsigned char* mask = m_mask.data();
+        const size_t lanes = m_lanes;
+        const size_t controlBit = size_t{1} << control;
+        const size_t targetBit = size_t{1} << target;
+        const size_t states = size_t{1} << m_qubits;
+        for (size_t i = 0; i < states; ++i) {
+            if (!(i & controlBit) || (i & targetBit))
+                continue;
+            size_t j = i | targetBit;
+            double* ra = &m_re[i * lanes];
+            double* ia = &m_im[i * lanes];
+            double* rb = &m_re[j * lanes];
+            double* ib = &m_im[j * lanes];
+            for (size_t s = 0; s < lanes; ++s) {
+                double ar = ra[s], ai = ia[s], br = rb[s], bi = ib[s];
+                ra[s] = mask[s] ? br : ar;
+                ia[s] = mask[s] ? bi : ai;
+                rb[s] = mask[s] ? ar : br;
+                ib[s] = mask[s] ? ai : bi;
+            }
+        }
+    }
+
+    void BatchedSimulator::probabilityOfOne(int q, std::vector<double>& p1) {
+        const size_t lanes = m_lanes;
+        const size_t bit = size_t{1} << q;
+        const size_t states = size_t{1} << m_qubits;
+        p1.assign(lanes, 0.0);
+        for (size_t i = 0; i < states; ++i) {
+            if (!(i & bit))
+                continue;
+            const double* re = &m_re[i * lanes];
+            const double* im = &m_im[i * lanes];
+            for (size_t s = 0; s < lanes; ++s) p1[s] += re[s] * re[s] + im[s] * im[s];
+        }
+    }
+
+    void BatchedSimulator::measure(int q, std::vector<int>& outcomes) {
+        const size_t lanes = m_lanes;
+        const size_t bit = size_t{1} << q;
+        const size_t states = size_t{1} << m_qubits;
+        probabilityOfOne(q, m_scratch);
+        // Per lane: the scale for amplitudes with q = 0 and with q = 1.
+        std::vector<double> keep0(lanes), keep1(lanes);
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+        outcomes.resize(lanes);
+        for (size_t s = 0; s < lanes; ++s) {
+            double p1 = m_scratch[s];
+            int res = dist(m_rng) < p1 ? 1 : 0;
+            outcomes[s] = res;
+            double norm = std::sqrt(res ? p1 : 1 - p1);
+            keep0[s] = res ? 0.0 : 1.0 / norm;
+            keep1[s] = res ? 1.0 / norm : 0.0;
+        }
+        for (size_t i = 0; i < states; ++i) {
+            const double* keep = (i & bit) ? keep1.data() : keep0.data();
+            double* re = &m_re[i * lanes];
+            double* im = &m_im[i * lanes];
+            for (size_t s = 0; s < lanes; ++s) {
+                re[s] *= keep[s];
+                im[s] *= keep[s];
+            }
+        }
+    }
+
+    void BatchedSimulator::reset(int q) {
+        // Same rule as QasmSimulator::reset, per lane: renormalise the q = 0
+        // half, or move the q = 1 half down when the q = 0 half is empty.
+        const size_t lanes = m_lanes;
+        const size_t bit = size_t{1} << q;
+        const size_t states = size_t{1} << m_qubits;
+        std::vector<double>& norm0 = m_scratch;
+        norm0.assign(lanes, 0.0);
+        for (size_t i = 0; i < states; ++i) {
+            if (i & bit)
+                continue;
+            const double* re = &m_re[i * lanes];
+            const double* im = &m_im[i * lanes];
+            for (size_t s = 0; s < lanes; ++s) norm0[s] += re[s] * re[s] + im[s] * im[s];
+        }
+        std::vector<double> scale0(lanes), moveDown(lanes);
+        for (size_t s = 0; s < lanes; ++s) {
+            scale0[s] = norm0[s] == 0.0 ? 0.0 : 1.0 / std::sqrt(norm0[s]);
+            moveDown[s] = norm0[s] == 0.0 ? 1.0 : 0.0;
+        }
+        for (size_t i = 0; i < states; ++i) {
+            if (i & bit)
+                continue;
+            double* r0 = &m_re[i * lanes];
+            double* i0 = &m_im[i * lanes];
+            double* r1 = &m_re[(i | bit) * lanes];
+            double* i1 = &m_im[(i | bit) * lanes];
+            for (size_t s = 0; s < lanes; ++s) {
+                r0[s] = scale0[s] * r0[s] + moveDown[s] * r1[s];
+                i0[s] = scale0[s] * i0[s] + moveDown[s] * i1[s];
+                r1[s] = 0.0;
+                i1[s] = 0.0;
+            }
+        }
+    }
+
+    void replayCircuitBatched(const Circuit& circuit, const ReplaySlice& slice,
+                              TrackedCounts& counts, ShotLog* log) {
+        if (slice.begin >= slice.end)
+            return;
+        std::vector<int> outcomes;
+        BatchedSimulator sim(circuit.qubits, std::min(BatchedSimulator::kMaxLanes, slice.shots));
+        const int width = sim.lanes();
+        // Batch b holds shots [b * width, (b + 1) * width) and draws from its
+        // own stream, whichever slice it is run for.
+        for (int batch = slice.begin / width; batch * width < slice.end; ++batch) {
+            int first = batch * width;
+            // Lanes outside the slice (or past the last shot) run but are not counted.
+            int lo = std::max(0, slice.begin - first);
+            int hi = std::min({width, slice.end - first, slice.shots - first});
+            if (batch * width > slice.begin)
+                sim.clear();
+            sim.seed(streamSeed(slice.seed, static_cast<std::uint64_t>(batch)));
+            std::vector<std::vector<int>> lastMeasurement(width,
+                                                          std::vector<int>(circuit.qubits, -1));
+            // Each measurement's outcomes across lanes, for conditional gates.
+            std::vector<std::uint64_t> laneOutcomes(
+                circuit.conditions.empty() ? 0 : circuit.ops.size());
+            // Per lane, the tracked outcomes in order, for the log.
+            std::vector<std::vector<std::pair<const std::string*, std::string>>> samples(
+                log ? width : 0);
+            for (size_t pc = 0; pc < circuit.ops.size(); ++pc) {
+                const CircuitOp& op = circuit.ops[pc];
+                switch (op.kind) {
+                    case CircuitOp::Kind::Gate:
+                        if (op.condition < 0)
+                            sim.apply(op.gate);
+                        else
+                            sim.apply(op.gate, conditionLanes(circuit.conditions[op.condition],
+                                                              laneOutcomes));
+                        break;
+                    case CircuitOp::Kind::Measure:
+                        sim.measure(op.qubit, outcomes);
+                        for (int s = lo; s < hi; ++s) lastMeasurement[s][op.qubit] = outcomes[s];
+                        if (!laneOutcomes.empty()) {
+                            std::uint64_t ones = 0;
+                            for (int s = 0; s < width; ++s)
+                                ones |= static_cast<std::uint64_t>(outcomes[s] & 1) << s;
+                            laneOutcomes[pc] = ones;
+                        }
+                        break;
+                    case CircuitOp::Kind::Reset:
+                        sim.reset(op.qubit);
+                        for (int s = lo; s < hi; ++s) lastMeasurement[s][op.qubit] = -1;
+                        break;
+                    case CircuitOp::Kind::Track: {
+                        auto& values = counts[op.key];
+                        for (int s = lo; s < hi; ++s) {
+                            std::string outcome = trackedOutcome(lastMeasurement[s], op.qubits);
+                            values[outcome]++;
+                            if (log)
+                                samples[s].emplace_back(&op.key, std::move(outcome));
+                        }
+                        break;
+                    }
+                }
+            }
+            if (log) {
+                for (int s = lo; s < hi; ++s) {
+                    for (const auto& sample : samples[s]) log->record(*sample.first, sample.second);
+                    log->endShot();
+                }
+            }
+        }
+    }
+
+}  // namespace bloch::runtime
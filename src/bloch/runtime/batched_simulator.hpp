@@ -0,0 +1,80 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "bloch/runtime/circuit.hpp"
+#include "bloch/runtime/gate.hpp"
+#include "bloch/runtime/random.hpp"
+
+namespace bloch::runtime {
+
+    // Runs one small circuit for many shots in lockstep. Each basis state
+    // holds a contiguous row of amplitudes, one lane per shot, with real and
+    // imaginary parts in separate arrays, so every gate's inner loop runs
+    // across shots and vectorises. Lanes differ through their measurement
+    // outcomes, which are sampled and collapsed per lane, and through gates
+    // applied to only some lanes (a circuit's conditional gates).
+    class BatchedSimulator {
+       public:
+        // Registers above this size are faster one shot at a time.
+        static constexpr int kMaxQubits = 12;
+        static constexpr int kMaxLanes = 64;
+
+        BatchedSimulator(int qubits, int lanes);
+
+        // Puts every lane back in |0...0>.
+        void clear();
+        void apply(const GateOp& op);
+        // Applies `op` in the lanes set in `lanes` and leaves the rest alone.
+        void apply(const GateOp& op, std::uint64_t lanes);
+        void reset(int q);
+        // Measures q in every lane; outcomes[lane] receives 0 or 1.
+        void measure(int q, std::vector<int>& outcomes);
+
+        int lanes() const { return m_lanes; }
+        void seed(std::uint64_t seed) { m_rng.seed(seed); }
+
+       private:
+        int m_qubits;
+        int m_lanes;
+        // Amplitude of basis state i in lane s lives at i * m_lanes + s.
+        std::vector<double> m_re;
+        std::vector<double> m_im;
+        std::vector<double> m_scratch;
+        // Per lane, 1 where a masked gate applies.
+        std::vector<unsigned char> m_mask;
+        Rng m_rng;
+
+        void applySingleQubitGate(int q, const std::array<std::complex<double>, 4>& m);
+        void swapControlledAmplitudes(int control, int target);
+        // As above, in the lanes m_mask selects.
+        void applyMaskedSingleQubitGate(int q, const std::array<std::complex<double>, 4>& m);
+        void swapMaskedControlledAmplitudes(int control, int target);
+        // Per-lane probability that qubit q reads 1.
+        void probabilityOfOne(int q, std::vector<double>& p1);
+    };
+
+    // Runs `slice` of `circuit` through BatchedSimulator, kMaxLanes shots at a
+    // time, and adds their tracked outcomes to `counts`. The circuit must have
+    // at most BatchedSimulator::kMaxQubits qubits. With a `log`, each batch
+    // appends its shots once it has run.
+    void replayCircuitBatched(const Circuit& circuit, const ReplaySlice& slice,
+                              TrackedCounts& counts, ShotLog* log = nullptr);
+
+}  // namespace bloch::runtime
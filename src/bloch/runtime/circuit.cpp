@@ -0,0 +1,239 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "bloch/runtime/circuit.hpp"
+
+#include <algorithm>
+#include <random>
+#include <utility>
+
+#include "bloch/runtime/qasm_simulator.hpp"
+#include "bloch/runtime/random.hpp"
+
+namespace bloch::runtime {
+
+    std::string trackedOutcome(const std::vector<int>& lastMeasurement,
+                               const std::vector<int>& qubits) {
+        std::string bits;
+        for (int q : qubits) {
+            if (q < 0 || q >= static_cast<int>(lastMeasurement.size()) ||
+                lastMeasurement[q] == -1)
+                return "?";
+            bits.push_back(lastMeasurement[q] ? '1' : '0');
+        }
+        return bits;
+    }
+
+    bool combineConditions(const CircuitCondition& a, const CircuitCondition& b, bool negateB,
+                           CircuitCondition& combined) {
+        combined.measurements = a.measurements;
+        for (int m : b.measurements)
+            if (std::find(combined.measurements.begin(), combined.measurements.end(), m) ==
+                combined.measurements.end())
+                combined.measurements.push_back(m);
+        const int width = static_cast<int>(combined.measurements.size());
+        if (width > CircuitCondition::kMaxMeasurements)
+            return false;
+        // Where each operand's measurements sit in the combined assignment.
+        auto positions = [&](const CircuitCondition& c) {
+            std::vector<int> at;
+            for (int m : c.measurements)
+                at.push_back(static_cast<int>(
+                    std::find(combined.measurements.begin(), combined.measurements.end(), m) -
+                    combined.measurements.begin()));
+            return at;
+        };
+        auto holds = [](const CircuitCondition& c, const std::vector<int>& at, unsigned bits) {
+            unsigned index = 0;
+            for (size_t j = 0; j < at.size(); ++j) index |= ((bits >> at[j]) & 1u) << j;
+            return ((c.truth >> index) & 1u) != 0;
+        };
+        std::vector<int> inA = positions(a);
+        std::vector<int> inB = positions(b);
+        combined.truth = 0;
+        for (unsigned bits = 0; bits < (1u << width); ++bits)
+            if (holds(a, inA, bits) && holds(b, inB, bits) != negateB)
+                combined.truth |= std::uint64_t{1} << bits;
+        return true;
+    }
+
+    std::uint64_t conditionLanes(const CircuitCondition& condition,
+                                 const std::vector<std::uint64_t>& outcomes) {
+        const size_t width = condition.measurements.size();
+        std::uint64_t lanes = 0;
+        for (unsigned bits = 0; bits < (1u << width); ++bits) {
+            if (!((condition.truth >> bits) & 1u))
+                continue;
+            std::uint64_t match = ~std::uint64_t{0};
+            for (size_t j = 0; j < width; ++j) {
+                std::uint64_t read = outcomes[condition.measurements[j]];
+                match &= ((bits >> j) & 1u) ? read : ~read;
+            }
+            lanes |= match;
+        }
+        return lanes;
+    }
+
+    namespace {
+        constexpr int kMaxBranchingQubits = 20;
+        constexpr int kMaxBranchingMeasurements = 16;
+
+        // Shots [first, first + shots) of the slice's run reach this branch.
+        struct Branch {
+            size_t pc = 0;
+            int first = 0;
+            int shots = 0;
+            std::uint64_t node = 0;
+        };
+
+        int overlap(const ReplaySlice& slice, int first, int shots) {
+            return std::max(0, std::min(slice.end, first + shots) - std::max(slice.begin, first));
+        }
+
+        // Whether a shot applies `op`; `outcomes` holds each measurement's
+        // outcome in bit 0.
+        bool applies(const Circuit& circuit, const CircuitOp& op,
+                     const std::vector<std::uint64_t>& outcomes) {
+            return op.condition < 0 ||
+                   (conditionLanes(circuit.conditions[op.condition], outcomes) & 1u);
+        }
+
+        // `samples` holds the branch's tracked outcomes so far, for the log;
+        // `outcomes` is only kept for circuits with conditions.
+        void runBranch(const Circuit& circuit, const ReplaySlice& slice, Branch at,
+                       QasmSimulator sim, std::vector<int> lastMeasurement,
+                       std::vector<std::uint64_t> outcomes,
+                       std::vector<std::pair<const std::string*, std::string>> samples,
+                       TrackedCounts& counts, ShotLog* log) {
+            const bool conditional = !circuit.conditions.empty();
+            for (; at.pc < circuit.ops.size(); ++at.pc) {
+                const CircuitOp& op = circuit.ops[at.pc];
+                switch (op.kind) {
+                    case CircuitOp::Kind::Gate:
+                        if (applies(circuit, op, outcomes))
+                            sim.apply(op.gate);
+                        break;
+                    case CircuitOp::Kind::Measure: {
+                        double p1 = std::clamp(sim.probabilityOfOne(op.qubit), 0.0, 1.0);
+                        Rng rng(at.node);
+                        int ones = std::binomial_distribution<int>(at.shots, p1)(rng);
+                        Branch one{at.pc + 1, at.first, ones, streamSeed(at.node, 1)};
+                        if (ones > 0 && ones < at.shots) {
+                            // Fork the shots that read 1; this branch keeps the rest.
+                            if (overlap(slice, one.first, one.shots) > 0) {
+                                QasmSimulator branch = sim;
+                                branch.measureAs(op.qubit, 1);
+                                std::vector<int> branchLast = lastMeasurement;
+                                branchLast[op.qubit] = 1;
+                                std::vector<std::uint64_t> branchOutcomes = outcomes;
+                                if (conditional)
+                                    branchOutcomes[at.pc] = 1;
+                                runBranch(circuit, slice, one, std::move(branch),
+                                          std::move(branchLast), std::move(branchOutcomes),
+                                          samples, counts, log);
+                            }
+                            at.first += ones;
+                            at.shots -= ones;
+                            ones = 0;
+                            if (overlap(slice, at.first, at.shots) == 0)
+                                return;
+                        }
+                        int outcome = ones > 0 ? 1 : 0;
+                        sim.measureAs(op.qubit, outcome);
+                        lastMeasurement[op.qubit] = outcome;
+                        if (conditional)
+                            outcomes[at.pc] = static_cast<std::uint64_t>(outcome);
+                        at.node = streamSeed(at.node, outcome);
+                        break;
+                    }
+                    case CircuitOp::Kind::Reset:
+                        sim.reset(op.qubit);
+                        lastMeasurement[op.qubit] = -1;
+                        break;
+                    case CircuitOp::Kind::Track: {
+                        std::string outcome = trackedOutcome(lastMeasurement, op.qubits);
+                        counts[op.key][outcome] += overlap(slice, at.first, at.shots);
+                        if (log)
+                            samples.emplace_back(&op.key, std::move(outcome));
+                        break;
+                    }
+                }
+            }
+            if (log) {
+                for (const auto& sample : samples) log->record(*sample.first, sample.second);
+                log->endShot(static_cast<std::uint64_t>(overlap(slice, at.first, at.shots)));
+            }
+        }
+    }  // namespace
+
+    void replayCircuit(const Circuit& circuit, std::uint64_t seed, TrackedCounts& counts,
+                       ShotLog* log) {
+        QasmSimulator sim(false);
+        sim.seed(seed);
+        sim.allocateQubits(circuit.qubits);
+        std::vector<int> lastMeasurement(circuit.qubits, -1);
+        std::vector<std::uint64_t> outcomes(circuit.conditions.empty() ? 0 : circuit.ops.size());
+        for (size_t pc = 0; pc < circuit.ops.size(); ++pc) {
+            const CircuitOp& op = circuit.ops[pc];
+            switch (op.kind) {
+                case CircuitOp::Kind::Gate:
+                    if (applies(circuit, op, outcomes))
+                        sim.apply(op.gate);
+                    break;
+                case CircuitOp::Kind::Measure:
+                    lastMeasurement[op.qubit] = sim.measure(op.qubit);
+                    if (!outcomes.empty())
+                        outcomes[pc] = static_cast<std::uint64_t>(lastMeasurement[op.qubit]);
+                    break;
+                case CircuitOp::Kind::Reset:
+                    sim.reset(op.qubit);
+                    lastMeasurement[op.qubit] = -1;
+                    break;
+                case CircuitOp::Kind::Track: {
+                    std::string outcome = trackedOutcome(lastMeasurement, op.qubits);
+                    if (log)
+                        log->record(op.key, outcome);
+                    counts[op.key][std::move(outcome)]++;
+                    break;
+                }
+            }
+        }
+        if (log)
+            log->endShot();
+    }
+
+    void replayCircuitBranching(const Circuit& circuit, const ReplaySlice& slice,
+                                TrackedCounts& counts, ShotLog* log) {
+        if (overlap(slice, 0, slice.shots) == 0)
+            return;
+        QasmSimulator sim(false);
+        sim.allocateQubits(circuit.qubits);
+        runBranch(circuit, slice, Branch{0, 0, slice.shots, slice.seed}, std::move(sim),
+                  std::vector<int>(circuit.qubits, -1),
+                  std::vector<std::uint64_t>(circuit.conditions.empty() ? 0 : circuit.ops.size()),
+                  {}, counts, log);
+    }
+
+    bool prefersBranching(const Circuit& circuit) {
+        if (circuit.qubits > kMaxBranchingQubits)
+            return false;
+        int measurements = 0;
+        for (const auto& op : circuit.ops)
+            if (op.kind == CircuitOp::Kind::Measure)
+                ++measurements;
+        return measurements <= kMaxBranchingMeasurements;
+    }
+
+}  // namespace bloch::runtime
@@ -0,0 +1,111 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bloch/runtime/gate.hpp"
+#include "bloch/runtime/shot_log.hpp"
+
+namespace bloch::runtime {
+
+    using TrackedCounts = std::unordered_map<std::string, std::unordered_map<std::string, int>>;
+
+    // One simulator-level event of a recorded run.
+    struct CircuitOp {
+        enum class Kind { Gate, Measure, Reset, Track };
+        Kind kind = Kind::Gate;
+        GateOp gate;              // Gate
+        int condition = -1;       // Gate: index into Circuit::conditions, or -1
+        int qubit = -1;           // Measure, Reset
+        std::string key;          // Track: trackedCounts key, e.g. "qubit[] q"
+        std::vector<int> qubits;  // Track: the qubits whose outcomes form the value
+    };
+
+    // A predicate over earlier measurements of the same shot, as a truth
+    // table: assignment a (bit j the outcome of `measurements[j]`, an index
+    // into Circuit::ops) satisfies it when bit a of `truth` is set.
+    struct CircuitCondition {
+        static constexpr int kMaxMeasurements = 6;
+        std::vector<int> measurements;
+        std::uint64_t truth = 1;  // no measurements: always true
+    };
+
+    // Sets `combined` to the predicate that holds where `a` and `b` (or `a`
+    // and not `b`) both do; false when it would read too many measurements.
+    bool combineConditions(const CircuitCondition& a, const CircuitCondition& b, bool negateB,
+                           CircuitCondition& combined);
+
+    // The lanes for which `condition` holds, given each Measure op's outcome
+    // in every lane as a bit mask indexed like Circuit::ops.
+    std::uint64_t conditionLanes(const CircuitCondition& condition,
+                                 const std::vector<std::uint64_t>& outcomes);
+
+    // Everything one run did to the simulator, in order, plus the points
+    // where @tracked values were sampled. For a feedback-free program this is
+    // the same in every shot, so it can be replayed without the interpreter.
+    // Branches whose condition only reads measured bits and that only apply
+    // gates are recorded whichever way the run went, with their gates under
+    // a condition, so replay applies them in just the shots that take them.
+    struct Circuit {
+        int qubits = 0;
+        std::vector<CircuitOp> ops;
+        std::vector<CircuitCondition> conditions;
+        // False once the run met a controlled branch it could not record;
+        // its shots must then be interpreted.
+        bool replayable = true;
+    };
+
+    // The @tracked outcome string for `qubits`: their last measured bits, or
+    // "?" if any has not been measured since allocation or reset.
+    std::string trackedOutcome(const std::vector<int>& lastMeasurement,
+                               const std::vector<int>& qubits);
+
+    // Runs one shot of `circuit` on a fresh, non-logging simulator seeded
+    // with `seed` and adds its tracked outcomes to `counts` (and, when given,
+    // a shot to `log`).
+    void replayCircuit(const Circuit& circuit, std::uint64_t seed, TrackedCounts& counts,
+                       ShotLog* log = nullptr);
+
+    // Shots [begin, end) of a replay of `shots` shots whose draws all derive
+    // from `seed`. Replaying the slices of a split in any order adds the same
+    // counts as replaying all the shots at once.
+    struct ReplaySlice {
+        int shots = 0;
+        int begin = 0;
+        int end = 0;
+        std::uint64_t seed = 0;
+    };
+
+    // Runs `slice` of `circuit` as a tree over measurement outcomes. At each
+    // measurement the shots reaching it are split between the outcomes
+    // binomially, and each side continues on its own copy of the state, so
+    // shared prefixes are simulated once and every leaf adds its exact shot
+    // count to `counts`. Shot indices are laid out depth first, outcome 1
+    // before outcome 0, and each split draws from a generator seeded by its
+    // position in the tree, so subtrees outside the slice are skipped. Leaves
+    // finish in shot order, so each appends its shots to `log` in turn.
+    void replayCircuitBranching(const Circuit& circuit, const ReplaySlice& slice,
+                                TrackedCounts& counts, ShotLog* log = nullptr);
+
+    // Whether the branching replay suits `circuit`: few enough measurements
+    // to bound the tree and a state small enough to copy at each split.
+    bool prefersBranching(const Circuit& circuit);
+
+}  // namespace bloch::runtime
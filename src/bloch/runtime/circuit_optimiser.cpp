@@ -0,0 +1,194 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "bloch/runtime/circuit_optimiser.hpp"
+
+#include <cmath>
+#include <utility>
+
+namespace bloch::runtime {
+
+    namespace {
+        enum class Axis { None, X, Y, Z };
+
+        Axis axisOf(GateKind kind) {
+            switch (kind) {
+                case GateKind::X:
+                case GateKind::RX:
+                    return Axis::X;
+                case GateKind::Y:
+                case GateKind::RY:
+                    return Axis::Y;
+                case GateKind::Z:
+                case GateKind::RZ:
+                    return Axis::Z;
+                default:
+                    return Axis::None;
+            }
+        }
+
+        // Whether two gates that share a qubit may swap places.
+        bool commutes(const GateOp& a, const GateOp& b) {
+            bool aCx = a.kind == GateKind::CX;
+            bool bCx = b.kind == GateKind::CX;
+            if (aCx && bCx)
+                return a.control != b.target && a.target != b.control;
+            if (aCx || bCx) {
+                const GateOp& cx = aCx ? a : b;
+                const GateOp& single = aCx ? b : a;
+                Axis axis = axisOf(single.kind);
+                if (single.target == cx.control)
+                    return axis == Axis::Z;
+                return axis == Axis::X;
+            }
+            Axis axis = axisOf(a.kind);
+            return axis != Axis::None && axis == axisOf(b.kind);
+        }
+
+        bool isIdentityAngle(double theta) {
+            constexpr double kFourPi = 4.0 * 3.14159265358979323846;
+            double rem = std::fmod(std::fabs(theta), kFourPi);
+            return rem < 1e-12 || kFourPi - rem < 1e-12;
+        }
+    }  // namespace
+
+    void CircuitOptimiser::setEnabled(bool enabled) {
+        if (!enabled)
+            flush();
+        m_enabled = enabled;
+    }
+
+    void CircuitOptimiser::setCondition(int condition) {
+        flush();
+        m_condition = condition;
+    }
+
+    void CircuitOptimiser::setRecordOnly(bool recordOnly) {
+        flush();
+        m_recordOnly = recordOnly;
+    }
+
+    void CircuitOptimiser::apply(const GateOp& op) {
+        if (m_recordOnly) {
+            if (m_recorder) {
+                CircuitOp rec;
+                rec.gate = op;
+                rec.condition = m_condition;
+                m_recorder->ops.push_back(std::move(rec));
+            }
+            return;
+        }
+        ++m_submitted;
+        if (!m_enabled) {
+            emit(op);
+            return;
+        }
+        for (size_t i = m_pending.size(); i-- > 0;) {
+            GateOp& prev = m_pending[i];
+            bool shared = prev.acts(op.target) || (op.control >= 0 && prev.acts(op.control));
+            if (!shared)
+                continue;
+            if (prev.kind == op.kind && prev.target == op.target && prev.control == op.control) {
+                if (!op.isRotation()) {
+                    m_pending.erase(m_pending.begin() + static_cast<std::ptrdiff_t>(i));
+                    m_removed += 2;
+                    return;
+                }
+                prev.theta += op.theta;
+                ++m_removed;
+                if (isIdentityAngle(prev.theta)) {
+                    m_pending.erase(m_pending.begin() + static_cast<std::ptrdiff_t>(i));
+                    ++m_removed;
+                }
+                return;
+            }
+            if (!commutes(prev, op))
+                break;
+        }
+        m_pending.push_back(op);
+        if (m_pending.size() > kWindow) {
+            emit(m_pending.front());
+            m_pending.pop_front();
+        }
+    }
+
+    int CircuitOptimiser::measure(int q) {
+        flush();
+        ++m_simulatorOps;
+        double start = m_timeline ? m_timeline->now() : 0.0;
+        int bit = m_sim.measure(q);
+        if (m_timeline) {
+            m_timeline->complete("measure", "measure", start,
+                                 {{"qubit", q},
+                                  {"outcome", bit},
+                                  {"amplitudes", static_cast<long long>(m_sim.stateSize())}});
+        }
+        if (m_recorder) {
+            CircuitOp rec;
+            rec.kind = CircuitOp::Kind::Measure;
+            rec.qubit = q;
+            m_recorder->ops.push_back(std::move(rec));
+        }
+        return bit;
+    }
+
+    void CircuitOptimiser::reset(int q) {
+        flush();
+        ++m_simulatorOps;
+        double start = m_timeline ? m_timeline->now() : 0.0;
+        m_sim.reset(q);
+        if (m_timeline) {
+            m_timeline->complete("gate", "reset", start,
+                                 {{"qubit", q},
+                                  {"amplitudes", static_cast<long long>(m_sim.stateSize())}});
+        }
+        if (m_recorder) {
+            CircuitOp rec;
+            rec.kind = CircuitOp::Kind::Reset;
+            rec.qubit = q;
+            m_recorder->ops.push_back(std::move(rec));
+        }
+    }
+
+    void CircuitOptimiser::flush() {
+        for (const auto& op : m_pending) emit(op);
+        m_pending.clear();
+    }
+
+    void CircuitOptimiser::emit(const GateOp& op) {
+        ++m_simulatorOps;
+        ++m_applied[static_cast<size_t>(op.kind)];
+        double start = m_timeline ? m_timeline->now() : 0.0;
+        m_sim.apply(op);
+        if (m_timeline) {
+            auto amplitudes = static_cast<long long>(m_sim.stateSize());
+            if (op.control >= 0)
+                m_timeline->complete("gate", gateName(op.kind), start,
+                                     {{"control", op.control},
+                                      {"target", op.target},
+                                      {"amplitudes", amplitudes}});
+            else
+                m_timeline->complete("gate", gateName(op.kind), start,
+                                     {{"target", op.target}, {"amplitudes", amplitudes}});
+        }
+        if (m_recorder) {
+            CircuitOp rec;
+            rec.gate = op;
+            rec.condition = m_condition;
+            m_recorder->ops.push_back(std::move(rec));
+        }
+    }
+
+}  // namespace bloch::runtime
@@ -0,0 +1,93 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+
+#include "bloch/runtime/circuit.hpp"
+#include "bloch/runtime/gate.hpp"
+#include "bloch/runtime/qasm_simulator.hpp"
+#include "bloch/runtime/timeline.hpp"
+
+namespace bloch::runtime {
+
+    // Peephole stage between the evaluator and the simulator. When enabled,
+    // gates are held in a window and only reach the simulator (and its QASM
+    // log) once something needs the state: a measurement, a reset, flush(),
+    // or the window filling up. While held, a new gate is matched against
+    // the most recent gate it does not commute with:
+    //  - self-inverse pairs (h h, x x, y y, z z, cx cx on the same pair) cancel;
+    //  - rotations about the same axis on the same qubit merge, and vanish
+    //    when the merged angle is a multiple of 4*pi;
+    //  - z/rz pass through cx controls and x/rx through cx targets, so pairs
+    //    separated by such a cx still meet.
+    // Every rewrite leaves the statevector unchanged, so measurement
+    // statistics are exactly those of the unoptimised circuit.
+    class CircuitOptimiser {
+       public:
+        explicit CircuitOptimiser(QasmSimulator& sim) : m_sim(sim) {}
+
+        void setEnabled(bool enabled);
+        bool enabled() const { return m_enabled; }
+        // Appends every gate, measurement and reset that reaches the simulator
+        // to `circuit` (nullptr stops recording).
+        void setRecorder(Circuit* circuit) { m_recorder = circuit; }
+        // Records the gates that follow under `condition`, an index into the
+        // recorder's conditions (-1 for none). Held gates are flushed first.
+        void setCondition(int condition);
+        int condition() const { return m_condition; }
+        // While set, gates are only recorded: they reach neither the simulator
+        // nor the counters. Used for the branch a recorded run did not take.
+        void setRecordOnly(bool recordOnly);
+        bool recordOnly() const { return m_recordOnly; }
+        // Adds an event for every gate, measurement and reset the simulator
+        // runs to `timeline` (nullptr stops).
+        void setTimeline(Timeline* timeline) { m_timeline = timeline; }
+
+        void apply(const GateOp& op);
+        int measure(int q);
+        void reset(int q);
+        // Applies every held gate to the simulator.
+        void flush();
+
+        size_t gatesSubmitted() const { return m_submitted; }
+        size_t gatesRemoved() const { return m_removed; }
+        // Gates, measurements and resets passed on to the simulator.
+        size_t simulatorOps() const { return m_simulatorOps; }
+        // Gates passed on to the simulator, by kind.
+        const GateCounts& gatesApplied() const { return m_applied; }
+
+       private:
+        // Held gates beyond this are applied oldest first.
+        static constexpr size_t kWindow = 256;
+
+        QasmSimulator& m_sim;
+        bool m_enabled = false;
+        Circuit* m_recorder = nullptr;
+        Timeline* m_timeline = nullptr;
+        int m_condition = -1;
+        bool m_recordOnly = false;
+        std::deque<GateOp> m_pending;
+        size_t m_submitted = 0;
+        size_t m_removed = 0;
+        size_t m_simulatorOps = 0;
+        GateCounts m_applied{};
+
+        void emit(const GateOp& op);
+    };
+
+}  // namespace bloch::runtime
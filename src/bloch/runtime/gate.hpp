@@ -0,0 +1,80 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <string_view>
+
+namespace bloch::runtime {
+
+    enum class GateKind { H, X, Y, Z, RX, RY, RZ, CX };
+    constexpr size_t kGateKinds = 8;
+
+    // Gates applied, indexed by GateKind.
+    using GateCounts = std::array<long long, kGateKinds>;
+
+    // The gate's QASM name.
+    constexpr std::string_view gateName(GateKind kind) {
+        constexpr std::array<std::string_view, kGateKinds> names = {"h",  "x",  "y",  "z",
+                                                                    "rx", "ry", "rz", "cx"};
+        return names[static_cast<size_t>(kind)];
+    }
+
+    // One built-in gate application. Single-qubit gates use `target` only;
+    // `cx` uses `control` and `target`; rotations carry `theta`.
+    struct GateOp {
+        GateKind kind = GateKind::H;
+        int target = -1;
+        int control = -1;
+        double theta = 0.0;
+
+        bool isRotation() const {
+            return kind == GateKind::RX || kind == GateKind::RY || kind == GateKind::RZ;
+        }
+        bool acts(int q) const { return target == q || control == q; }
+    };
+
+    // The 2x2 unitary of a single-qubit gate, row-major.
+    inline std::array<std::complex<double>, 4> gateMatrix(GateKind kind, double theta = 0.0) {
+        using C = std::complex<double>;
+        double ct = std::cos(theta / 2);
+        double st = std::sin(theta / 2);
+        switch (kind) {
+            case GateKind::H:
+                return {1 / std::sqrt(2.0), 1 / std::sqrt(2.0), 1 / std::sqrt(2.0),
+                        -1 / std::sqrt(2.0)};
+            case GateKind::X:
+                return {0.0, 1.0, 1.0, 0.0};
+            case GateKind::Y:
+                return {0.0, C(0, -1), C(0, 1), 0.0};
+            case GateKind::Z:
+                return {1.0, 0.0, 0.0, -1.0};
+            case GateKind::RX:
+                return {ct, C(0, -st), C(0, -st), ct};
+            case GateKind::RY:
+                return {ct, -st, st, ct};
+            case GateKind::RZ:
+                return {std::exp(C(0, -theta / 2)), 0.0, 0.0, std::exp(C(0, theta / 2))};
+            case GateKind::CX:
+                break;
+        }
+        return {1.0, 0.0, 0.0, 1.0};
+    }
+
+}  // namespace bloch::runtime
@@ -0,0 +1,121 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "bloch/runtime/measurement_trace.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+#include "bloch/runtime/varint.hpp"
+#include "bloch/support/error/bloch_error.hpp"
+
+namespace bloch::runtime {
+
+    using support::BlochError;
+    using support::ErrorCategory;
+
+    namespace {
+        constexpr char kMagic[4] = {'B', 'L', 'T', 'R'};
+        constexpr char kVersion = 1;
+
+        std::string qubitLabel(int qubit) { return "q[" + std::to_string(qubit) + "]"; }
+    }  // namespace
+
+    void MeasurementTrace::recordMeasurement(int qubit, int outcome) {
+        m_events.push_back(((static_cast<std::uint64_t>(qubit) << 1) | (outcome ? 1 : 0)) + 1);
+    }
+
+    void MeasurementTrace::recordShotEnd() { m_events.push_back(kShotEnd); }
+
+    int MeasurementTrace::replayMeasurement(int qubit, int line, int column) {
+        std::string where = "shot " + std::to_string(m_shot + 1) + ": ";
+        if (m_cursor >= m_events.size() || m_events[m_cursor] == kShotEnd)
+            throw BlochError(ErrorCategory::Runtime, line, column,
+                             where + "measurement of " + qubitLabel(qubit) +
+                                 " is not in the trace; control flow diverged from the "
+                                 "recorded run");
+        std::uint64_t event = m_events[m_cursor] - 1;
+        int recorded = static_cast<int>(event >> 1);
+        if (recorded != qubit)
+            throw BlochError(ErrorCategory::Runtime, line, column,
+                             where + "measured " + qubitLabel(qubit) + " but the trace recorded " +
+                                 qubitLabel(recorded) +
+                                 "; control flow diverged from the recorded run");
+        ++m_cursor;
+        return static_cast<int>(event & 1);
+    }
+
+    void MeasurementTrace::replayShotEnd() {
+        size_t end = m_cursor;
+        while (end < m_events.size() && m_events[end] != kShotEnd) ++end;
+        if (end == m_events.size())
+            throw BlochError(ErrorCategory::Runtime, 0, 0,
+                             "the trace has fewer shots than this run");
+        if (end != m_cursor)
+            throw BlochError(ErrorCategory::Runtime, 0, 0,
+                             "shot " + std::to_string(m_shot + 1) + " ended with " +
+                                 std::to_string(end - m_cursor) +
+                                 " recorded measurements left; control flow diverged from the "
+                                 "recorded run");
+        m_cursor = end + 1;
+        ++m_shot;
+    }
+
+    int MeasurementTrace::shots() const {
+        return static_cast<int>(std::count(m_events.begin(), m_events.end(), kShotEnd));
+    }
+
+    size_t MeasurementTrace::measurements() const {
+        return m_events.size() - static_cast<size_t>(shots());
+    }
+
+    void MeasurementTrace::save(const std::string& path) const {
+        std::string bytes(kMagic, sizeof(kMagic));
+        bytes.push_back(kVersion);
+        for (std::uint64_t event : m_events) putVarint(bytes, event);
+        std::ofstream out(path, std::ios::binary);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (!out)
+            throw BlochError(ErrorCategory::Runtime, 0, 0,
+                             "cannot write measurement trace '" + path + "'");
+    }
+
+    MeasurementTrace MeasurementTrace::load(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            throw BlochError(ErrorCategory::Runtime, 0, 0,
+                             "cannot read measurement trace '" + path + "'");
+        std::string bytes{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+        auto invalid = [&path]() {
+            return BlochError(ErrorCategory::Runtime, 0, 0,
+                              "'" + path + "' is not a Bloch measurement trace");
+        };
+        if (bytes.size() < sizeof(kMagic) + 1 ||
+            !std::equal(kMagic, kMagic + sizeof(kMagic), bytes.begin()) ||
+            bytes[sizeof(kMagic)] != kVersion)
+            throw invalid();
+        MeasurementTrace trace;
+        size_t pos = sizeof(kMagic) + 1;
+        while (pos < bytes.size()) {
+            std::uint64_t event = 0;
+            if (!readVarint(bytes, pos, event))
+                throw invalid();
+            trace.m_events.push_back(event);
+        }
+        return trace;
+    }
+
+}  // namespace bloch::runtime
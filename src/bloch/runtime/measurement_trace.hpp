@@ -0,0 +1,57 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace bloch::runtime {
+
+    // Every measurement outcome of a run, in order, with the qubit measured.
+    // Outcomes are the only random draws the simulator makes, so replaying a
+    // trace reproduces the run's classical behaviour without a statevector.
+    //
+    // On disk: the bytes "BLTR", a format version byte, then one LEB128
+    // varint per event: 0 ends a shot, otherwise ((qubit << 1) | outcome) + 1.
+    class MeasurementTrace {
+       public:
+        void recordMeasurement(int qubit, int outcome);
+        void recordShotEnd();
+
+        // The recorded outcome of the next measurement, which must be of
+        // `qubit` in the current shot; otherwise the run has diverged from the
+        // trace and a runtime BlochError at line:column is thrown.
+        int replayMeasurement(int qubit, int line, int column);
+        // Throws if the current shot recorded more measurements than it made.
+        void replayShotEnd();
+
+        int shots() const;
+        size_t measurements() const;
+
+        // Both throw a BlochError naming `path` on I/O or format errors.
+        void save(const std::string& path) const;
+        static MeasurementTrace load(const std::string& path);
+
+       private:
+        static constexpr std::uint64_t kShotEnd = 0;
+
+        std::vector<std::uint64_t> m_events;
+        size_t m_cursor = 0;
+        int m_shot = 0;
+    };
+
+}  // namespace bloch::runtime
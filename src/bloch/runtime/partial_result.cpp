@@ -0,0 +1,165 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bloch/runtime/partial_result.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <limits>
+
+#include "bloch/runtime/varint.hpp"
+#include "bloch/support/error/bloch_error.hpp"
+
+namespace bloch::runtime {
+
+    using support::BlochError;
+    using support::ErrorCategory;
+
+    namespace {
+        constexpr char kMagic[4] = {'B', 'L', 'P', 'R'};
+        constexpr char kVersion = 1;
+
+        void putString(std::string& bytes, const std::string& value) {
+            putVarint(bytes, value.size());
+            bytes += value;
+        }
+
+        // Reads fields in order; any read past the end or malformed varint
+        // sets `ok` to false and yields zeroes.
+        struct Reader {
+            const std::string& bytes;
+            size_t pos = 0;
+            bool ok = true;
+
+            std::uint64_t varint() {
+                std::uint64_t value = 0;
+                if (readVarint(bytes, pos, value))
+                    return value;
+                ok = false;
+                return 0;
+            }
+
+            int count() {
+                std::uint64_t value = varint();
+                if (value > static_cast<std::uint64_t>(std::numeric_limits<int>::max()))
+                    ok = false;
+                return ok ? static_cast<int>(value) : 0;
+            }
+
+            std::string string() {
+                std::uint64_t size = varint();
+                if (!ok || size > bytes.size() - pos) {
+                    ok = false;
+                    return {};
+                }
+                std::string value = bytes.substr(pos, size);
+                pos += size;
+                return value;
+            }
+        };
+    }  // namespace
+
+    void PartialResult::save(const std::string& path) const {
+        std::string bytes(kMagic, sizeof(kMagic));
+        bytes.push_back(kVersion);
+        putVarint(bytes, seed);
+        putVarint(bytes, static_cast<std::uint64_t>(totalShots));
+        putVarint(bytes, static_cast<std::uint64_t>(shardCount));
+        putVarint(bytes, static_cast<std::uint64_t>(shard));
+        putVarint(bytes, static_cast<std::uint64_t>(shotsRun));
+        putVarint(bytes, trackedCounts.size());
+        for (const auto& var : trackedCounts) {
+            putString(bytes, var.first);
+            putVarint(bytes, var.second.size());
+            for (const auto& outcome : var.second) {
+                putString(bytes, outcome.first);
+                putVarint(bytes, static_cast<std::uint64_t>(outcome.second));
+            }
+        }
+        std::ofstream out(path, std::ios::binary);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (!out)
+            throw BlochError(ErrorCategory::Runtime, 0, 0,
+                             "cannot write partial result '" + path + "'");
+    }
+
+    PartialResult PartialResult::load(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            throw BlochError(ErrorCategory::Runtime, 0, 0,
+                             "cannot read partial result '" + path + "'");
+        std::string bytes{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+        auto invalid = [&path]() {
+            return BlochError(ErrorCategory::Runtime, 0, 0,
+                              "'" + path + "' is not a Bloch partial result");
+        };
+        if (bytes.size() < sizeof(kMagic) + 1 ||
+            !std::equal(kMagic, kMagic + sizeof(kMagic), bytes.begin()) ||
+            bytes[sizeof(kMagic)] != kVersion)
+            throw invalid();
+        Reader reader{bytes, sizeof(kMagic) + 1};
+        PartialResult result;
+        result.seed = reader.varint();
+        result.totalShots = reader.count();
+        result.shardCount = reader.count();
+        result.shard = reader.count();
+        result.shotsRun = reader.count();
+        int values = reader.count();
+        for (int v = 0; v < values && reader.ok; ++v) {
+            auto& counts = result.trackedCounts[reader.string()];
+            int outcomes = reader.count();
+            for (int o = 0; o < outcomes && reader.ok; ++o) {
+                std::string outcome = reader.string();
+                counts[outcome] += reader.count();
+            }
+        }
+        if (!reader.ok || reader.pos != bytes.size() || result.shardCount <= 0 ||
+            result.shard >= result.shardCount)
+            throw invalid();
+        return result;
+    }
+
+    MergedResult mergePartialResults(const std::vector<PartialResult>& partials) {
+        MergedResult merged;
+        if (partials.empty())
+            return merged;
+        const PartialResult& first = partials.front();
+        merged.seed = first.seed;
+        merged.totalShots = first.totalShots;
+        merged.shardCount = first.shardCount;
+        std::vector<bool> seen(first.shardCount, false);
+        for (const auto& partial : partials) {
+            if (partial.seed != first.seed || partial.totalShots != first.totalShots ||
+                partial.shardCount != first.shardCount)
+                throw BlochError(ErrorCategory::Runtime, 0, 0,
+                                 "partial results come from different runs (seed, shot count "
+                                 "or shard count differ)");
+            if (seen[partial.shard])
+                throw BlochError(ErrorCategory::Runtime, 0, 0,
+                                 "shard " + std::to_string(partial.shard) + "/" +
+                                     std::to_string(partial.shardCount) + " appears twice");
+            seen[partial.shard] = true;
+            merged.shotsRun += partial.shotsRun;
+            for (const auto& var : partial.trackedCounts)
+                for (const auto& outcome : var.second)
+                    merged.trackedCounts[var.first][outcome.first] += outcome.second;
+        }
+        for (int shard = 0; shard < merged.shardCount; ++shard)
+            if (!seen[shard])
+                merged.missingShards.push_back(shard);
+        return merged;
+    }
+
+}  // namespace bloch::runtime
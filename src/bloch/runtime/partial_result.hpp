@@ -0,0 +1,59 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "bloch/runtime/circuit.hpp"
+
+namespace bloch::runtime {
+
+    // The @tracked counts of one shard of a sharded run (ShotOptions::shard),
+    // saved so shards run on separate machines can be combined.
+    //
+    // On disk: the bytes "BLPR", a format version byte, then LEB128 varints:
+    // seed, total shots, shard count, shard, shots run, the number of tracked
+    // values, and for each its key, its number of outcomes and every outcome
+    // with its count. Strings are a varint length followed by the bytes.
+    struct PartialResult {
+        std::uint64_t seed = 0;
+        int totalShots = 0;
+        int shardCount = 1;
+        int shard = 0;
+        int shotsRun = 0;
+        TrackedCounts trackedCounts;
+
+        // Both throw a BlochError naming `path` on I/O or format errors.
+        void save(const std::string& path) const;
+        static PartialResult load(const std::string& path);
+    };
+
+    struct MergedResult {
+        std::uint64_t seed = 0;
+        int totalShots = 0;
+        int shardCount = 0;
+        int shotsRun = 0;
+        TrackedCounts trackedCounts;
+        // Shards of the run that were not among the partials.
+        std::vector<int> missingShards;
+    };
+
+    // Adds up partial results of one run. Throws a BlochError if they come
+    // from different runs (seed, shot count or shard count) or repeat a shard.
+    MergedResult mergePartialResults(const std::vector<PartialResult>& partials);
+
+}  // namespace bloch::runtime
@@ -0,0 +1,248 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bloch/runtime/profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+
+namespace bloch::runtime {
+
+    Profiler::Profiler(Mode mode) : m_mode(mode), m_last(std::chrono::steady_clock::now()) {
+        m_functions.push_back(Function{"(run)", 0});
+        m_nodes.push_back(Node{});
+        m_stack.push_back(Position{});
+        if (m_mode == Mode::Sampled) {
+            m_sampler = std::thread([this] {
+                while (!m_stop.load(std::memory_order_relaxed)) {
+                    std::this_thread::sleep_for(kSampleInterval);
+                    m_ticks.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+    }
+
+    Profiler::~Profiler() {
+        m_stop = true;
+        if (m_sampler.joinable())
+            m_sampler.join();
+    }
+
+    void Profiler::beginRun() {
+        m_stack.assign(1, Position{});
+        m_counters = {};
+        m_last = std::chrono::steady_clock::now();
+        m_ticks.store(0, std::memory_order_relaxed);
+    }
+
+    void Profiler::endRun(const ProfileCounters& now) {
+        charge(now);
+        m_stack.resize(1);
+    }
+
+    void Profiler::enterFunction(const void* key, std::string_view owner, std::string_view name,
+                                 const ProfileCounters& now) {
+        charge(now);
+        size_t function;
+        auto found = m_functionIndex.find(key);
+        if (found != m_functionIndex.end()) {
+            function = found->second;
+        } else {
+            std::string label(owner);
+            if (!label.empty())
+                label += ".";
+            label += name;
+            function = functionFor(key, label);
+        }
+        ++m_functions[function].calls;
+        m_stack.push_back(Position{child(m_stack.back().node, function), nullptr});
+    }
+
+    void Profiler::leaveFunction(const ProfileCounters& now) {
+        charge(now);
+        if (m_stack.size() > 1)
+            m_stack.pop_back();
+    }
+
+    void Profiler::enterStatement(int line, const ProfileCounters& now) {
+        charge(now);
+        size_t node = m_stack.back().node;
+        if (line <= 0) {
+            // Statements the optimiser made up belong to the enclosing line.
+            m_stack.push_back(m_stack.back());
+            return;
+        }
+        size_t function = m_nodes[node].function;
+        std::uint64_t key = (static_cast<std::uint64_t>(function) << 32) |
+                            static_cast<std::uint32_t>(line);
+        Line& stats = m_lines[key];
+        stats.function = function;
+        stats.line = line;
+        ++stats.hits;
+        m_stack.push_back(Position{node, &stats});
+    }
+
+    void Profiler::leaveStatement(const ProfileCounters& now) {
+        charge(now);
+        if (m_stack.size() > 1)
+            m_stack.pop_back();
+    }
+
+    void Profiler::addExternal(std::string_view name, double seconds) {
+        size_t function = functionFor(nullptr, name);
+        ++m_functions[function].calls;
+        m_nodes[child(0, function)].self.seconds += seconds;
+    }
+
+    void Profiler::charge(const ProfileCounters& now) {
+        double seconds = 0.0;
+        if (m_mode == Mode::Instrumented) {
+            auto time = std::chrono::steady_clock::now();
+            seconds = std::chrono::duration<double>(time - m_last).count();
+            m_last = time;
+        } else if (m_ticks.load(std::memory_order_relaxed) != 0) {
+            seconds = static_cast<double>(m_ticks.exchange(0, std::memory_order_relaxed)) *
+                      std::chrono::duration<double>(kSampleInterval).count();
+        }
+        size_t gates = now.gates - m_counters.gates;
+        size_t passes = now.passes - m_counters.passes;
+        m_counters = now;
+        const Position& top = m_stack.back();
+        Stats& node = m_nodes[top.node].self;
+        node.seconds += seconds;
+        node.gates += gates;
+        node.passes += passes;
+        if (top.line) {
+            top.line->self.seconds += seconds;
+            top.line->self.gates += gates;
+            top.line->self.passes += passes;
+        }
+    }
+
+    size_t Profiler::child(size_t node, size_t function) {
+        for (size_t index : m_nodes[node].children)
+            if (m_nodes[index].function == function)
+                return index;
+        m_nodes.push_back(Node{function, node, {}, {}});
+        m_nodes[node].children.push_back(m_nodes.size() - 1);
+        return m_nodes.size() - 1;
+    }
+
+    size_t Profiler::functionFor(const void* key, std::string_view name) {
+        if (key) {
+            auto found = m_functionIndex.find(key);
+            if (found != m_functionIndex.end())
+                return found->second;
+        } else {
+            // Frames without a declaration are few; find them by name.
+            for (size_t f = 0; f < m_functions.size(); ++f)
+                if (m_functions[f].name == name)
+                    return f;
+        }
+        m_functions.push_back(Function{std::string(name), 0});
+        if (key)
+            m_functionIndex.emplace(key, m_functions.size() - 1);
+        return m_functions.size() - 1;
+    }
+
+    double Profiler::inclusiveSeconds(size_t node) const {
+        double seconds = m_nodes[node].self.seconds;
+        for (size_t index : m_nodes[node].children) seconds += inclusiveSeconds(index);
+        return seconds;
+    }
+
+    void Profiler::report(std::ostream& out, size_t maxLines) const {
+        // Self figures add up over call paths; a function's total counts
+        // only its outermost frame on each path, so recursion is not doubled.
+        std::vector<Stats> self(m_functions.size());
+        std::vector<double> total(m_functions.size(), 0.0);
+        std::vector<int> active(m_functions.size(), 0);
+        std::function<void(size_t)> visit = [&](size_t index) {
+            const Node& node = m_nodes[index];
+            self[node.function].seconds += node.self.seconds;
+            self[node.function].gates += node.self.gates;
+            self[node.function].passes += node.self.passes;
+            if (active[node.function]++ == 0)
+                total[node.function] += inclusiveSeconds(index);
+            for (size_t child : node.children) visit(child);
+            --active[node.function];
+        };
+        visit(0);
+
+        auto ms = [](double seconds) { return seconds * 1000.0; };
+        out << std::fixed << std::setprecision(3);
+        out << "Profile: " << ms(total[0]) << " ms";
+        if (m_mode == Mode::Sampled)
+            out << ", sampled every "
+                << std::chrono::duration<double, std::milli>(kSampleInterval).count() << " ms";
+        else
+            out << ", timed at every statement";
+        out << "\n\n";
+
+        std::vector<size_t> functions;
+        for (size_t f = 0; f < m_functions.size(); ++f)
+            if (m_functions[f].calls > 0 || self[f].seconds > 0.0)
+                functions.push_back(f);
+        std::stable_sort(functions.begin(), functions.end(),
+                         [&](size_t a, size_t b) { return self[a].seconds > self[b].seconds; });
+        out << std::right << std::setw(10) << "self ms" << std::setw(11) << "total ms"
+            << std::setw(10) << "calls" << std::setw(10) << "gates" << std::setw(10) << "passes"
+            << "  function\n";
+        for (size_t f : functions) {
+            out << std::setw(10) << ms(self[f].seconds) << std::setw(11) << ms(total[f])
+                << std::setw(10) << m_functions[f].calls << std::setw(10) << self[f].gates
+                << std::setw(10) << self[f].passes << "  " << m_functions[f].name << "\n";
+        }
+
+        std::vector<const Line*> lines;
+        lines.reserve(m_lines.size());
+        for (const auto& entry : m_lines) lines.push_back(&entry.second);
+        std::sort(lines.begin(), lines.end(), [](const Line* a, const Line* b) {
+            if (a->self.seconds != b->self.seconds)
+                return a->self.seconds > b->self.seconds;
+            if (a->function != b->function)
+                return a->function < b->function;
+            return a->line < b->line;
+        });
+        if (lines.size() > maxLines)
+            lines.resize(maxLines);
+        out << "\n"
+            << std::setw(10) << "self ms" << std::setw(11) << "hits" << std::setw(10) << "gates"
+            << std::setw(10) << "passes" << "  line\n";
+        for (const Line* line : lines) {
+            out << std::setw(10) << ms(line->self.seconds) << std::setw(11) << line->hits
+                << std::setw(10) << line->self.gates << std::setw(10) << line->self.passes << "  "
+                << m_functions[line->function].name << ":" << line->line << "\n";
+        }
+    }
+
+    void Profiler::writeCollapsed(std::ostream& out) const {
+        std::string path;
+        std::function<void(size_t)> visit = [&](size_t index) {
+            const Node& node = m_nodes[index];
+            size_t length = path.size();
+            if (index != 0)
+                path += (length ? ";" : "") + m_functions[node.function].name;
+            auto micros = static_cast<long long>(std::llround(node.self.seconds * 1e6));
+            if (micros > 0)
+                out << (index == 0 ? m_functions[0].name : path) << " " << micros << "\n";
+            for (size_t child : node.children) visit(child);
+            path.resize(length);
+        };
+        visit(0);
+    }
+
+}  // namespace bloch::runtime
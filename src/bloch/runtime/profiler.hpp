@@ -0,0 +1,126 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace bloch::runtime {
+
+    // Work one interpreted run has done so far.
+    struct ProfileCounters {
+        size_t gates = 0;   // gates the program issued
+        size_t passes = 0;  // gates, measurements and resets applied to the statevector
+    };
+
+    // Attributes wall time, gates and statevector passes to a program's
+    // functions and lines. The evaluator reports function and statement
+    // boundaries, and everything between two boundaries is charged to the
+    // innermost statement running (and the call path it runs on).
+    //
+    // Instrumented mode reads the clock at every boundary. Sampled mode
+    // instead has a background thread tick every kSampleInterval, and each
+    // boundary charges the ticks since the previous one, so statements cost
+    // no clock reads and times are estimates to within an interval.
+    class Profiler {
+       public:
+        enum class Mode { Instrumented, Sampled };
+        static constexpr std::chrono::microseconds kSampleInterval{1000};
+
+        explicit Profiler(Mode mode);
+        Profiler(const Profiler&) = delete;
+        Profiler& operator=(const Profiler&) = delete;
+        ~Profiler();
+
+        Mode mode() const { return m_mode; }
+
+        // Brackets one run of the evaluator, whose counters start at zero.
+        void beginRun();
+        void endRun(const ProfileCounters& now);
+
+        // `key` identifies the function (its declaration); `owner` and `name`
+        // are only read the first time it is seen.
+        void enterFunction(const void* key, std::string_view owner, std::string_view name,
+                           const ProfileCounters& now);
+        void leaveFunction(const ProfileCounters& now);
+        void enterStatement(int line, const ProfileCounters& now);
+        void leaveStatement(const ProfileCounters& now);
+
+        // Charges time spent outside the interpreter, e.g. replaying a
+        // recorded circuit, to a top-level frame called `name`.
+        void addExternal(std::string_view name, double seconds);
+
+        // Functions, then the `maxLines` hottest lines, by self time.
+        void report(std::ostream& out, size_t maxLines = 20) const;
+        // One "main;f;g <microseconds>" line per call path, the collapsed
+        // stack format flame graph tools read.
+        void writeCollapsed(std::ostream& out) const;
+
+       private:
+        struct Stats {
+            double seconds = 0.0;  // self time
+            size_t gates = 0;
+            size_t passes = 0;
+        };
+        // A node of the calling context tree: one call path.
+        struct Node {
+            size_t function = 0;
+            size_t parent = 0;
+            std::vector<size_t> children;
+            Stats self;
+        };
+        struct Function {
+            std::string name;
+            size_t calls = 0;
+        };
+        struct Line {
+            size_t function = 0;
+            int line = 0;
+            size_t hits = 0;
+            Stats self;
+        };
+        struct Position {
+            size_t node = 0;
+            Line* line = nullptr;  // null before the function's first statement
+        };
+
+        Mode m_mode;
+        std::vector<Function> m_functions;
+        std::unordered_map<const void*, size_t> m_functionIndex;
+        std::vector<Node> m_nodes;
+        std::unordered_map<std::uint64_t, Line> m_lines;
+        std::vector<Position> m_stack;
+        ProfileCounters m_counters;
+        std::chrono::steady_clock::time_point m_last;
+        std::atomic<std::uint64_t> m_ticks{0};
+        std::atomic<bool> m_stop{false};
+        std::thread m_sampler;
+
+        // Charges everything since the previous boundary to the stack top.
+        void charge(const ProfileCounters& now);
+        size_t child(size_t node, size_t function);
+        size_t functionFor(const void* key, std::string_view name);
+        double inclusiveSeconds(size_t node) const;
+    };
+
+}  // namespace bloch::runtime
@@ -14,8 +14,10 @@
 
 #include "bloch/runtime/qasm_simulator.hpp"
 
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <limits>
 #include <random>
 #include <sstream>
 #include <stdexcept>
@@ -25,25 +27,38 @@ namespace bloch::runtime {
     using support::BlochError;
     using support::ErrorCategory;
 
-    static std::mt19937 rng{std::random_device{}()};
-    // TODO(REFACTOR): inject RNG via a Strategy/adapter so simulator is
-    // deterministic under test and replaceable by other random sources.
-
-    int QasmSimulator::allocateQubit() {
-        // Grow the state by a factor of two, keeping existing amplitudes
-        // in the |...0> subspace and zeroing the |...1> subspace.
-        int index = m_qubits++;
-        if (index >= static_cast<int>(m_measured.size()))
-            m_measured.resize(index + 1, false);
-        else
-            m_measured[index] = false;
-        std::vector<std::complex<double>> newState(m_state.size() * 2);
-        for (size_t i = 0; i < m_state.size(); ++i) {
-            newState[i] = m_state[i];
-            newState[i + m_state.size()] = 0;
+    int QasmSimulator::allocateQubit() { return allocateQubits(1); }
+
+    int QasmSimulator::allocateQubits(int n) {
+        int first = m_qubits;
+        if (n <= 0)
+            return first;
+        if (m_simulate && (n >= std::numeric_limits<size_t>::digits ||
+                           (m_state.max_size() >> n) < m_state.size()))
+            throw BlochError(ErrorCategory::Runtime, 0, 0,
+                             "cannot simulate " + std::to_string(m_qubits + n) +
+                                 " qubits: the statevector would not fit in memory");
+        m_qubits += n;
+        if (m_qubits > static_cast<int>(m_measured.size()))
+            m_measured.resize(m_qubits, false);
+        std::fill(m_measured.begin() + first, m_measured.begin() + m_qubits, false);
+        if (!m_simulate)
+            return first;
+        // New qubits are the high bits, so existing amplitudes keep their
+        // indices (the |0...0> block of the new qubits) and the rest is zero.
+        m_state.resize(m_state.size() << n);
+        return first;
+    }
+
+    void QasmSimulator::reserveQubits(int qubits) {
+        if (!m_simulate || qubits <= 0 || qubits >= std::numeric_limits<size_t>::digits ||
+            (m_state.max_size() >> qubits) == 0)
+            return;
+        try {
+            m_state.reserve(size_t{1} << qubits);
+        } catch (const std::exception&) {
+            // Growing on demand still works, or fails with a clearer error.
         }
-        m_state.swap(newState);
-        return index;
     }
 
     // REFACTOR: Consider a small Instruction/Gate registry (Command pattern)
@@ -51,6 +66,8 @@ namespace bloch::runtime {
     // function per gate; would shrink interface and simplify adding new ops.
     void QasmSimulator::applySingleQubitGate(int q, const std::array<std::complex<double>, 4>& m) {
         ensureQubitActive(q);
+        if (!m_simulate)
+            return;
         // Standard blocked application over basis pairs differing at bit q.
         size_t step = size_t{1} << q;
         size_t size = m_state.size();
@@ -67,59 +84,43 @@ namespace bloch::runtime {
     }
 
     void QasmSimulator::h(int q) {
-        const std::array<std::complex<double>, 4> m{1 / std::sqrt(2.0), 1 / std::sqrt(2.0),
-                                                    1 / std::sqrt(2.0), -1 / std::sqrt(2.0)};
-        applySingleQubitGate(q, m);
+        applySingleQubitGate(q, gateMatrix(GateKind::H));
         if (m_logOps)
             m_ops.emplace_back("h q[" + std::to_string(q) + "];\n");
     }
 
     void QasmSimulator::x(int q) {
-        const std::array<std::complex<double>, 4> m{0, 1, 1, 0};
-        applySingleQubitGate(q, m);
+        applySingleQubitGate(q, gateMatrix(GateKind::X));
         if (m_logOps)
             m_ops.emplace_back("x q[" + std::to_string(q) + "];\n");
     }
 
     void QasmSimulator::y(int q) {
-        const std::array<std::complex<double>, 4> m{0.0, std::complex<double>(0, -1),
-                                                    std::complex<double>(0, 1), 0.0};
-        applySingleQubitGate(q, m);
+        applySingleQubitGate(q, gateMatrix(GateKind::Y));
         if (m_logOps)
             m_ops.emplace_back("y q[" + std::to_string(q) + "];\n");
     }
 
     void QasmSimulator::z(int q) {
-        const std::array<std::complex<double>, 4> m{1.0, 0.0, 0.0, -1.0};
-        applySingleQubitGate(q, m);
+        applySingleQubitGate(q, gateMatrix(GateKind::Z));
         if (m_logOps)
             m_ops.emplace_back("z q[" + std::to_string(q) + "];\n");
     }
 
     void QasmSimulator::rx(int q, double t) {
-        double ct = std::cos(t / 2);
-        double st = std::sin(t / 2);
-        const std::array<std::complex<double>, 4> m{ct, std::complex<double>(0, -st),
-                                                    std::complex<double>(0, -st), ct};
-        applySingleQubitGate(q, m);
+        applySingleQubitGate(q, gateMatrix(GateKind::RX, t));
         if (m_logOps)
             m_ops.emplace_back("rx(" + std::to_string(t) + ") q[" + std::to_string(q) + "];\n");
     }
 
     void QasmSimulator::ry(int q, double t) {
-        double ct = std::cos(t / 2);
-        double st = std::sin(t / 2);
-        const std::array<std::complex<double>, 4> m{ct, -st, st, ct};
-        applySingleQubitGate(q, m);
+        applySingleQubitGate(q, gateMatrix(GateKind::RY, t));
         if (m_logOps)
             m_ops.emplace_back("ry(" + std::to_string(t) + ") q[" + std::to_string(q) + "];\n");
     }
 
     void QasmSimulator::rz(int q, double t) {
-        std::complex<double> epos = std::exp(std::complex<double>(0, -t / 2));
-        std::complex<double> eneg = std::exp(std::complex<double>(0, t / 2));
-        const std::array<std::complex<double>, 4> m{epos, 0.0, 0.0, eneg};
-        applySingleQubitGate(q, m);
+        applySingleQubitGate(q, gateMatrix(GateKind::RZ, t));
         if (m_logOps)
             m_ops.emplace_back("rz(" + std::to_string(t) + ") q[" + std::to_string(q) + "];\n");
     }
@@ -127,6 +128,14 @@ namespace bloch::runtime {
     void QasmSimulator::cx(int control, int target) {
         ensureQubitActive(control);
         ensureQubitActive(target);
+        if (m_simulate)
+            swapControlledAmplitudes(control, target);
+        if (m_logOps)
+            m_ops.emplace_back("cx q[" + std::to_string(control) + "],q[" + std::to_string(target) +
+                               "];\n");
+    }
+
+    void QasmSimulator::swapControlledAmplitudes(int control, int target) {
         // Swap amplitudes where control is 1 and target is 0 to flip target,
         // iterating only the affected subspace to avoid per-index branching.
         int low = std::min(control, target);
@@ -149,9 +158,35 @@ namespace bloch::runtime {
                 }
             }
         }
-        if (m_logOps)
-            m_ops.emplace_back("cx q[" + std::to_string(control) + "],q[" + std::to_string(target) +
-                               "];\n");
+    }
+
+    void QasmSimulator::apply(const GateOp& op) {
+        switch (op.kind) {
+            case GateKind::H:
+                h(op.target);
+                break;
+            case GateKind::X:
+                x(op.target);
+                break;
+            case GateKind::Y:
+                y(op.target);
+                break;
+            case GateKind::Z:
+                z(op.target);
+                break;
+            case GateKind::RX:
+                rx(op.target, op.theta);
+                break;
+            case GateKind::RY:
+                ry(op.target, op.theta);
+                break;
+            case GateKind::RZ:
+                rz(op.target, op.theta);
+                break;
+            case GateKind::CX:
+                cx(op.control, op.target);
+                break;
+        }
     }
 
     void QasmSimulator::reset(int q) {
@@ -161,6 +196,13 @@ namespace bloch::runtime {
         }
         if (q >= 0 && q < static_cast<int>(m_measured.size()))
             m_measured[q] = false;
+        if (m_simulate)
+            collapseToZero(q);
+        if (m_logOps)
+            m_ops.emplace_back("reset q[" + std::to_string(q) + "];\n");
+    }
+
+    void QasmSimulator::collapseToZero(int q) {
         // Put qubit q into |0>.
         // If the state already has amplitude in the |...0> subspace, zero the |...1> subspace
         // and renormalize. If all amplitude is in |...1>, deterministically move it into
@@ -192,35 +234,57 @@ namespace bloch::runtime {
                 }
             }
         }
+    }
 
+    int QasmSimulator::measure(int q) {
+        ensureQubitActive(q);
+        int res = m_simulate ? sampleAndCollapse(q) : 0;
         if (m_logOps)
-            m_ops.emplace_back("reset q[" + std::to_string(q) + "];\n");
+            m_ops.emplace_back("measure q[" + std::to_string(q) + "] -> c[" + std::to_string(q) +
+                               "];\n");
+        if (q >= 0 && q < static_cast<int>(m_measured.size()))
+            m_measured[q] = true;
+        return res;
     }
 
-    int QasmSimulator::measure(int q) {
+    void QasmSimulator::measureAs(int q, int outcome) {
         ensureQubitActive(q);
-        // Compute probability of |1>, sample, and collapse the state accordingly.
+        if (m_simulate)
+            collapseTo(q, outcome, probabilityOfOne(q));
+        if (m_logOps)
+            m_ops.emplace_back("measure q[" + std::to_string(q) + "] -> c[" + std::to_string(q) +
+                               "];\n");
+        m_measured[q] = true;
+    }
+
+    double QasmSimulator::probabilityOfOne(int q) const {
         size_t bit = size_t{1} << q;
         double p1 = 0;
         for (size_t i = 0; i < m_state.size(); ++i)
             if (i & bit)
                 p1 += std::norm(m_state[i]);
+        return p1;
+    }
+
+    int QasmSimulator::sampleAndCollapse(int q) {
+        // Compute probability of |1>, sample, and collapse the state accordingly.
+        double p1 = probabilityOfOne(q);
         std::uniform_real_distribution<double> dist(0.0, 1.0);
-        double r = dist(rng);
+        double r = dist(m_rng);
         int res = r < p1 ? 1 : 0;
-        double norm = std::sqrt(res ? p1 : 1 - p1);
+        collapseTo(q, res, p1);
+        return res;
+    }
+
+    void QasmSimulator::collapseTo(int q, int outcome, double p1) {
+        size_t bit = size_t{1} << q;
+        double norm = std::sqrt(outcome ? p1 : 1 - p1);
         for (size_t i = 0; i < m_state.size(); ++i) {
-            if (((i & bit) ? 1 : 0) != res)
+            if (((i & bit) ? 1 : 0) != outcome)
                 m_state[i] = 0;
             else
                 m_state[i] /= norm;
         }
-        if (m_logOps)
-            m_ops.emplace_back("measure q[" + std::to_string(q) + "] -> c[" + std::to_string(q) +
-                               "];\n");
-        if (q >= 0 && q < static_cast<int>(m_measured.size()))
-            m_measured[q] = true;
-        return res;
     }
 
     std::string QasmSimulator::getQasm() const {
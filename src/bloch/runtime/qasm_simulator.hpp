@@ -16,18 +16,34 @@
 
 #include <array>
 #include <complex>
+#include <cstdint>
 #include <string>
 #include <vector>
+#include "bloch/runtime/gate.hpp"
+#include "bloch/runtime/random.hpp"
 #include "bloch/support/error/bloch_error.hpp"
 
 namespace bloch::runtime {
 
     // An ideal statevector simulator with a QASM log.
+    // With `simulate` off no statevector is kept: operations are only checked
+    // and logged, and measurements read 0. That mode has no qubit limit.
     // TODO: performance optimisation post 1.0.0
     class QasmSimulator {
        public:
-        explicit QasmSimulator(bool logOps = true) : m_logOps(logOps) {}
+        // Statevector storage per basis state; n qubits take this << n bytes.
+        static constexpr size_t kBytesPerAmplitude = sizeof(std::complex<double>);
+
+        explicit QasmSimulator(bool logOps = true, bool simulate = true)
+            : m_logOps(logOps), m_simulate(simulate) {}
         int allocateQubit();
+        // Adds n qubits in |0> with a single resize of the statevector and
+        // returns the index of the first.
+        int allocateQubits(int n);
+        // Sets aside statevector storage for `qubits` qubits so allocations
+        // up to that count never reallocate. Best effort: ignored if the
+        // memory is not available.
+        void reserveQubits(int qubits);
         void h(int q);
         void x(int q);
         void y(int q);
@@ -36,21 +52,42 @@ namespace bloch::runtime {
         void ry(int q, double theta);
         void rz(int q, double theta);
         void cx(int control, int target);
+        // Dispatches to the gate method for op.kind.
+        void apply(const GateOp& op);
         void reset(int q);
         int measure(int q);
+        // Measures q as if `outcome` had been sampled; that outcome must have
+        // nonzero probability. Used to follow one branch of a measurement.
+        void measureAs(int q, int outcome);
+        // Probability that measuring q now reads 1 (0 when not simulating).
+        double probabilityOfOne(int q) const;
         std::string getQasm() const;
         size_t stateSize() const { return m_state.size(); }
+        // Bytes the statevector holds, including reserved capacity.
+        size_t stateBytes() const { return m_state.capacity() * kBytesPerAmplitude; }
+        // Amplitude i belongs to the basis state whose bit q is qubit q.
+        const std::vector<std::complex<double>>& state() const { return m_state; }
+        // Restarts the measurement generator. Until then it draws the
+        // generator's default sequence, so callers wanting fresh draws seed it.
+        void seed(std::uint64_t seed) { m_rng.seed(seed); }
 
        private:
         int m_qubits = 0;
         std::vector<std::complex<double>> m_state{1};
         std::vector<std::string> m_ops;
         bool m_logOps = true;
+        bool m_simulate = true;
         std::vector<bool> m_measured;
+        Rng m_rng;
 
         // Apply a 2x2 unitary to qubit q.
         void applySingleQubitGate(int q, const std::array<std::complex<double>, 4>& m);
         void ensureQubitActive(int q) const;
+        // Statevector updates behind cx, reset and measure.
+        void swapControlledAmplitudes(int control, int target);
+        void collapseToZero(int q);
+        int sampleAndCollapse(int q);
+        void collapseTo(int q, int outcome, double p1);
     };
 
 }  // namespace bloch::runtime
@@ -0,0 +1,45 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <random>
+
+namespace bloch::runtime {
+
+    // The generator behind every measurement draw.
+    using Rng = std::mt19937_64;
+
+    // Seed for stream `stream` of a run seeded with `seed`. Streams are
+    // independent of each other, so a shot or a branch of the replay tree can
+    // seed its own generator from its index alone and give the same draws
+    // however the run is split up. Two rounds of the SplitMix64 finaliser.
+    inline std::uint64_t streamSeed(std::uint64_t seed, std::uint64_t stream) {
+        std::uint64_t z = seed + 0x9e3779b97f4a7c15ULL * (stream + 1);
+        for (int round = 0; round < 2; ++round) {
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            z ^= z >> 31;
+        }
+        return z;
+    }
+
+    // A fresh seed from the operating system.
+    inline std::uint64_t randomSeed() {
+        std::random_device device;
+        return (static_cast<std::uint64_t>(device()) << 32) ^ device();
+    }
+
+}  // namespace bloch::runtime
@@ -44,6 +44,75 @@ namespace bloch::runtime {
 
     static constexpr bool kTraceConstructors = false;
 
+    namespace {
+        // Closes a profiled function or statement when it goes out of scope,
+        // so frames a runtime error unwinds are closed too.
+        class ProfileScope {
+           public:
+            ProfileScope(Profiler* profiler, const RuntimeEvaluator& eval, bool statement)
+                : m_profiler(profiler), m_eval(eval), m_statement(statement) {}
+            ProfileScope(const ProfileScope&) = delete;
+            ProfileScope& operator=(const ProfileScope&) = delete;
+            ~ProfileScope() {
+                if (!m_profiler)
+                    return;
+                if (m_statement)
+                    m_profiler->leaveStatement(m_eval.profileCounters());
+                else
+                    m_profiler->leaveFunction(m_eval.profileCounters());
+            }
+
+           private:
+            Profiler* m_profiler;
+            const RuntimeEvaluator& m_eval;
+            bool m_statement;
+        };
+
+        // Adds a call event covering its own lifetime to a timeline, if any.
+        class TimelineScope {
+           public:
+            TimelineScope(Timeline* timeline, std::string_view owner, std::string_view name)
+                : m_timeline(timeline) {
+                if (!m_timeline)
+                    return;
+                if (!owner.empty()) {
+                    m_name.assign(owner);
+                    m_name += ".";
+                }
+                m_name += name;
+                m_start = m_timeline->now();
+            }
+            TimelineScope(const TimelineScope&) = delete;
+            TimelineScope& operator=(const TimelineScope&) = delete;
+            ~TimelineScope() {
+                if (m_timeline)
+                    m_timeline->complete("call", m_name, m_start);
+            }
+
+           private:
+            Timeline* m_timeline;
+            std::string m_name;
+            double m_start = 0.0;
+        };
+
+        bool isTruthy(const Value& v) {
+            switch (v.type) {
+                case Value::Type::Boolean:
+                    return v.boolValue;
+                case Value::Type::Bit:
+                    return v.bitValue != 0;
+                case Value::Type::Int:
+                    return v.intValue != 0;
+                case Value::Type::Long:
+                    return v.longValue != 0;
+                case Value::Type::Float:
+                    return v.floatValue != 0.0;
+                default:
+                    return false;
+            }
+        }
+    }  // namespace
+
     static std::pair<RuntimeField*, RuntimeClass*> findStaticFieldWithOwner(
         RuntimeClass* cls, const std::string& name) {
         RuntimeClass* cur = cls;
@@ -489,9 +558,8 @@ namespace bloch::runtime {
                 break;
             case Value::Type::QubitArray: {
                 int n = std::max(0, field.arraySize);
-                v.qubitArray.resize(n);
-                for (int i = 0; i < n; ++i)
-                    v.qubitArray[i] = allocateTrackedQubit(makeQubitName(i));
+                v.qubitArray = allocateTrackedQubits(makeQubitName(0), n);
+                for (int i = 1; i < n; ++i) m_qubits[v.qubitArray[i]].name = makeQubitName(i);
                 break;
             }
             case Value::Type::ObjectArray: {
@@ -534,20 +602,33 @@ namespace bloch::runtime {
         m_gcRequested = false;
         m_gcThreadStarted = false;
         m_allocSinceGc = 0;
-        m_sim = QasmSimulator{m_collectQasmLog};
+        m_sim = QasmSimulator{m_collectQasmLog, m_simulate};
+        m_sim.reserveQubits(m_reserveQubits);
+        m_sim.seed(m_seed ? *m_seed : randomSeed());
         bool hasClasses = !program.classes.empty();
         if (hasClasses) {
+            Stopwatch classTableWatch;
             buildClassTable(program);
             for (auto& kv : m_classTable) initStaticFields(kv.second.get());
+            m_classTableTime = classTableWatch.elapsed();
             ensureGcThread();
         }
         for (auto& fn : program.functions) {
             m_functions[fn->name] = fn.get();
         }
         auto it = m_functions.find("main");
+        if (m_profiler)
+            m_profiler->beginRun();
         if (it != m_functions.end()) {
             call(it->second, {});
         }
+        m_circuit.flush();
+        if (m_profiler)
+            m_profiler->endRun(profileCounters());
+        if (m_traceRecorder)
+            m_traceRecorder->recordShotEnd();
+        if (m_traceReplay)
+            m_traceReplay->replayShotEnd();
         if (m_gcThreadStarted) {
             m_stopGc = true;
             m_gcRequested = true;
@@ -605,6 +686,24 @@ namespace bloch::runtime {
         return {};
     }
 
+    const Value* RuntimeEvaluator::findLocal(const std::string& name) const {
+        for (auto it = m_env.rbegin(); it != m_env.rend(); ++it) {
+            auto fit = it->find(name);
+            if (fit != it->end())
+                return &fit->second.value;
+        }
+        return nullptr;
+    }
+
+    Value* RuntimeEvaluator::findLocal(const std::string& name) {
+        for (auto it = m_env.rbegin(); it != m_env.rend(); ++it) {
+            auto fit = it->find(name);
+            if (fit != it->end())
+                return &fit->second.value;
+        }
+        return nullptr;
+    }
+
     void RuntimeEvaluator::assign(const std::string& name, const Value& v) {
         for (auto it = m_env.rbegin(); it != m_env.rend(); ++it) {
             auto fit = it->find(name);
@@ -1240,6 +1339,7 @@ namespace bloch::runtime {
         }
         if (objects.empty())
             return;
+        double gcStart = m_timeline ? m_timeline->now() : 0.0;
         // Mark roots: environment variables and static storage
         for (const auto& scope : m_env) {
             for (const auto& kv : scope) markValue(kv.second.value);
@@ -1262,33 +1362,31 @@ namespace bloch::runtime {
         }
         // unreachable will drop here and be reclaimed without running destructors
         m_allocSinceGc = 0;
+        if (m_timeline) {
+            m_timeline->complete("gc", "cycle collection", gcStart,
+                                 {{"objects", static_cast<long long>(objects.size())},
+                                  {"unreachable", static_cast<long long>(unreachable.size())}});
+        }
     }
 
     void RuntimeEvaluator::recordTrackedValue(const std::string& name, const Value& v) {
-        if (v.type == Value::Type::Qubit) {
-            int q = v.qubit;
-            std::string outcome = "?";
-            if (q >= 0 && q < static_cast<int>(m_lastMeasurement.size()) &&
-                m_lastMeasurement[q] != -1) {
-                outcome = m_lastMeasurement[q] ? "1" : "0";
-            }
-            m_trackedCounts[name][outcome]++;
-        } else if (v.type == Value::Type::QubitArray) {
-            bool allMeasured = true;
-            std::string bits;
-            for (int q : v.qubitArray) {
-                if (!(q >= 0 && q < static_cast<int>(m_lastMeasurement.size()) &&
-                      m_lastMeasurement[q] != -1)) {
-                    allMeasured = false;
-                    break;
-                }
-            }
-            std::string outcome = "?";
-            if (allMeasured) {
-                for (int q : v.qubitArray) bits.push_back(m_lastMeasurement[q] ? '1' : '0');
-                outcome = bits;
-            }
-            m_trackedCounts[name][outcome]++;
+        std::vector<int> qubits;
+        if (v.type == Value::Type::Qubit)
+            qubits.push_back(v.qubit);
+        else if (v.type == Value::Type::QubitArray)
+            qubits = v.qubitArray;
+        else
+            return;
+        std::string outcome = trackedOutcome(m_lastMeasurement, qubits);
+        if (m_shotLog)
+            m_shotLog->record(name, outcome);
+        m_trackedCounts[name][std::move(outcome)]++;
+        if (m_recording) {
+            CircuitOp op;
+            op.kind = CircuitOp::Kind::Track;
+            op.key = name;
+            op.qubits = std::move(qubits);
+            m_recording->ops.push_back(std::move(op));
         }
     }
 
@@ -1341,12 +1439,12 @@ namespace bloch::runtime {
                 if (obj->fields[i].type == Value::Type::Qubit) {
                     int q = obj->fields[i].qubit;
                     ensureQubitExists(q, fieldMeta.line, fieldMeta.column);
-                    m_sim.reset(q);
+                    m_circuit.reset(q);
                     releaseQubit(q);
                 } else if (obj->fields[i].type == Value::Type::QubitArray) {
                     for (int q : obj->fields[i].qubitArray) {
                         ensureQubitExists(q, fieldMeta.line, fieldMeta.column);
-                        m_sim.reset(q);
+                        m_circuit.reset(q);
                         releaseQubit(q);
                     }
                 }
@@ -1399,6 +1497,12 @@ namespace bloch::runtime {
         if (kTraceConstructors) {
             std::cerr << "[ctor] " << cls->name << " args=" << args.size() << std::endl;
         }
+        if (m_profiler) {
+            const void* key = ctor ? static_cast<const void*>(ctor) : cls;
+            m_profiler->enterFunction(key, cls->name, "constructor", profileCounters());
+        }
+        ProfileScope profileScope(m_profiler, *this, false);
+        TimelineScope timelineScope(m_timeline, cls->name, "constructor");
 
         bool savedReturn = m_hasReturn;
         m_hasReturn = false;
@@ -1540,6 +1644,13 @@ namespace bloch::runtime {
                                        const std::vector<Value>& args) {
         if (!method || !method->decl)
             return {};
+        if (m_profiler) {
+            m_profiler->enterFunction(method->decl, method->owner ? method->owner->name : "",
+                                      method->decl->name, profileCounters());
+        }
+        ProfileScope profileScope(m_profiler, *this, false);
+        TimelineScope timelineScope(m_timeline, method->owner ? method->owner->name : "",
+                                    method->decl->name);
         auto prevClass = m_currentClassCtx;
         bool prevStatic = m_inStaticContext;
         bool prevCtor = m_inConstructor;
@@ -1581,6 +1692,10 @@ namespace bloch::runtime {
 
     Value RuntimeEvaluator::call(FunctionDeclaration* fn, const std::vector<Value>& args) {
         // Bind parameters, run the body until a return is hit, then unwind.
+        if (m_profiler)
+            m_profiler->enterFunction(fn, "", fn->name, profileCounters());
+        ProfileScope profileScope(m_profiler, *this, false);
+        TimelineScope timelineScope(m_timeline, "", fn->name);
         beginScope();
         for (size_t i = 0; i < fn->params.size() && i < args.size(); ++i) {
             m_env.back()[fn->params[i]->name] = {args[i], false, true};
@@ -1606,22 +1721,9 @@ namespace bloch::runtime {
             runCycleCollector();
         if (!s)
             return;
-        auto isTruthy = [](const Value& v) {
-            switch (v.type) {
-                case Value::Type::Boolean:
-                    return v.boolValue;
-                case Value::Type::Bit:
-                    return v.bitValue != 0;
-                case Value::Type::Int:
-                    return v.intValue != 0;
-                case Value::Type::Long:
-                    return v.longValue != 0;
-                case Value::Type::Float:
-                    return v.floatValue != 0.0;
-                default:
-                    return false;
-            }
-        };
+        if (m_profiler)
+            m_profiler->enterStatement(s->line, profileCounters());
+        ProfileScope profileScope(m_profiler, *this, true);
         if (auto var = dynamic_cast<VariableDeclaration*>(s)) {
             Value v;
             if (auto prim = dynamic_cast<PrimitiveType*>(var->varType.get())) {
@@ -1691,11 +1793,8 @@ namespace bloch::runtime {
                         v.stringArray.assign(n, "");
                     else if (v.type == Value::Type::CharArray)
                         v.charArray.assign(n, '\0');
-                    else if (v.type == Value::Type::QubitArray) {
-                        v.qubitArray.resize(n);
-                        for (int i = 0; i < n; ++i)
-                            v.qubitArray[i] = allocateTrackedQubit(var->name);
-                    }
+                    else if (v.type == Value::Type::QubitArray)
+                        v.qubitArray = allocateTrackedQubits(var->name, n);
                 }
             } else if (dynamic_cast<NamedType*>(var->varType.get())) {
                 v.type = Value::Type::Object;
@@ -1852,7 +1951,9 @@ namespace bloch::runtime {
             if (ret->value)
                 m_returnValue = eval(ret->value.get());
             m_hasReturn = true;
-        } else if (auto ifs = dynamic_cast<IfStatement*>(s)) {
+        } else if (auto ifs = dynamic_cast<IfStatement*>(s); ifs && recordsControlled(ifs)) {
+            execControlledIf(*ifs);
+        } else if (ifs) {
             Value cond = eval(ifs->condition.get());
             if (isTruthy(cond)) {
                 exec(ifs->thenBranch.get());
@@ -1901,7 +2002,7 @@ namespace bloch::runtime {
         } else if (auto reset = dynamic_cast<ResetStatement*>(s)) {
             Value q = eval(reset->target.get());
             ensureQubitExists(q.qubit, reset->line, reset->column);
-            m_sim.reset(q.qubit);
+            m_circuit.reset(q.qubit);
             unmarkMeasured(q.qubit);
         } else if (auto meas = dynamic_cast<MeasureStatement*>(s)) {
             Value q = eval(meas->qubit.get());
@@ -1909,14 +2010,14 @@ namespace bloch::runtime {
                 for (int idx = 0; idx < static_cast<int>(q.qubitArray.size()); ++idx) {
                     int qid = q.qubitArray[idx];
                     ensureQubitActive(qid, meas->line, meas->column);
-                    int bit = m_sim.measure(qid);
+                    int bit = measureQubit(qid, meas->line, meas->column);
                     markMeasured(qid);
                     if (qid >= 0 && qid < static_cast<int>(m_lastMeasurement.size()))
                         m_lastMeasurement[qid] = bit;
                 }
             } else {
                 ensureQubitActive(q.qubit, meas->line, meas->column);
-                int bit = m_sim.measure(q.qubit);
+                int bit = measureQubit(q.qubit, meas->line, meas->column);
                 markMeasured(q.qubit);
                 if (q.qubit >= 0 && q.qubit < static_cast<int>(m_lastMeasurement.size()))
                     m_lastMeasurement[q.qubit] = bit;
@@ -2724,35 +2825,10 @@ namespace bloch::runtime {
                 std::vector<Value> args;
                 for (auto& a : callExpr->arguments) args.push_back(eval(a.get()));
                 if (builtin != builtInGates.end()) {
-                    // Map built-ins directly to simulator operations.
-                    // TODO: In the noisy simulator this logic will have to remain the same
-                    // so we will need the same basic quantum operations
-                    if (name == "h") {
-                        ensureQubitActive(args[0].qubit, callExpr->line, callExpr->column);
-                        m_sim.h(args[0].qubit);
-                    } else if (name == "x") {
-                        ensureQubitActive(args[0].qubit, callExpr->line, callExpr->column);
-                        m_sim.x(args[0].qubit);
-                    } else if (name == "y") {
-                        ensureQubitActive(args[0].qubit, callExpr->line, callExpr->column);
-                        m_sim.y(args[0].qubit);
-                    } else if (name == "z") {
-                        ensureQubitActive(args[0].qubit, callExpr->line, callExpr->column);
-                        m_sim.z(args[0].qubit);
-                    } else if (name == "rx") {
-                        ensureQubitActive(args[0].qubit, callExpr->line, callExpr->column);
-                        m_sim.rx(args[0].qubit, args[1].floatValue);
-                    } else if (name == "ry") {
-                        ensureQubitActive(args[0].qubit, callExpr->line, callExpr->column);
-                        m_sim.ry(args[0].qubit, args[1].floatValue);
-                    } else if (name == "rz") {
-                        ensureQubitActive(args[0].qubit, callExpr->line, callExpr->column);
-                        m_sim.rz(args[0].qubit, args[1].floatValue);
-                    } else if (name == "cx") {
-                        ensureQubitActive(args[0].qubit, callExpr->line, callExpr->column);
-                        ensureQubitActive(args[1].qubit, callExpr->line, callExpr->column);
-                        m_sim.cx(args[0].qubit, args[1].qubit);
-                    }
+                    if (recordsControlled(callExpr))
+                        applyControlledGate(*callExpr, name, args);
+                    else
+                        applyGate(name, args, callExpr->line, callExpr->column);
                     return {};  // void
                 }
                 auto fit = m_functions.find(name);
@@ -2828,15 +2904,32 @@ namespace bloch::runtime {
         } else if (auto idx = dynamic_cast<MeasureExpression*>(e)) {
             Value q = eval(idx->qubit.get());
             ensureQubitActive(q.qubit, idx->line, idx->column);
-            int bit = m_sim.measure(q.qubit);
+            int bit = measureQubit(q.qubit, idx->line, idx->column);
             markMeasured(q.qubit);
             if (q.qubit >= 0 && q.qubit < static_cast<int>(m_lastMeasurement.size()))
                 m_lastMeasurement[q.qubit] = bit;
             m_measurements[e].push_back(bit);
-            return {Value::Type::Bit, 0, 0.0, bit};
+            Value v{Value::Type::Bit, 0, 0.0, bit};
+            if (m_recording)
+                v.measurement = static_cast<int>(m_recording->ops.size()) - 1;
+            return v;
         } else if (auto indexExpr = dynamic_cast<IndexExpression*>(e)) {
-            Value coll = eval(indexExpr->collection.get());
+            // A named array is read in place rather than copied for every element
+            // access. Its lookup is deferred until after the index is evaluated
+            // (variable lookups have no side effects) so nothing can move m_env
+            // while the reference is held.
+            auto collVar = dynamic_cast<VariableExpression*>(indexExpr->collection.get());
+            Value collStorage;
+            if (!collVar)
+                collStorage = eval(indexExpr->collection.get());
             Value idxv = eval(indexExpr->index.get());
+            const Value* collPtr = collVar ? findLocal(collVar->name) : nullptr;
+            if (!collPtr) {
+                if (collVar)
+                    collStorage = eval(collVar);
+                collPtr = &collStorage;
+            }
+            const Value& coll = *collPtr;
             int idxi = 0;
             if (idxv.type == Value::Type::Int)
                 idxi = idxv.intValue;
@@ -3104,10 +3197,12 @@ namespace bloch::runtime {
         if (!m_freeQubitIndices.empty()) {
             idx = m_freeQubitIndices.back();
             m_freeQubitIndices.pop_back();
-            m_sim.reset(idx);
+            m_circuit.reset(idx);
             unmarkMeasured(idx);
         } else {
             idx = m_sim.allocateQubit();
+            if (m_recording)
+                m_recording->qubits = idx + 1;
             m_qubits.push_back({name, false});
         }
         if (idx >= static_cast<int>(m_qubits.size()))
@@ -3119,6 +3214,202 @@ namespace bloch::runtime {
         return idx;
     }
 
+    std::vector<int> RuntimeEvaluator::allocateTrackedQubits(const std::string& name, int count) {
+        std::vector<int> indices;
+        indices.reserve(count);
+        while (static_cast<int>(indices.size()) < count && !m_freeQubitIndices.empty())
+            indices.push_back(allocateTrackedQubit(name));
+        int fresh = count - static_cast<int>(indices.size());
+        if (fresh == 0)
+            return indices;
+        int first = m_sim.allocateQubits(fresh);
+        if (m_recording)
+            m_recording->qubits = first + fresh;
+        m_qubits.resize(first + fresh, QubitInfo{name, false});
+        if (first + fresh > static_cast<int>(m_lastMeasurement.size()))
+            m_lastMeasurement.resize(first + fresh, -1);
+        for (int i = 0; i < fresh; ++i) indices.push_back(first + i);
+        return indices;
+    }
+
+    void RuntimeEvaluator::applyGate(const std::string& name, const std::vector<Value>& args,
+                                     int line, int column) {
+        // Map built-ins directly to simulator operations.
+        // TODO: In the noisy simulator this logic will have to remain the same
+        // so we will need the same basic quantum operations
+        if (name == "h") {
+            ensureQubitActive(args[0].qubit, line, column);
+            m_circuit.apply({GateKind::H, args[0].qubit});
+        } else if (name == "x") {
+            ensureQubitActive(args[0].qubit, line, column);
+            m_circuit.apply({GateKind::X, args[0].qubit});
+        } else if (name == "y") {
+            ensureQubitActive(args[0].qubit, line, column);
+            m_circuit.apply({GateKind::Y, args[0].qubit});
+        } else if (name == "z") {
+            ensureQubitActive(args[0].qubit, line, column);
+            m_circuit.apply({GateKind::Z, args[0].qubit});
+        } else if (name == "rx") {
+            ensureQubitActive(args[0].qubit, line, column);
+            m_circuit.apply({GateKind::RX, args[0].qubit, -1, args[1].floatValue});
+        } else if (name == "ry") {
+            ensureQubitActive(args[0].qubit, line, column);
+            m_circuit.apply({GateKind::RY, args[0].qubit, -1, args[1].floatValue});
+        } else if (name == "rz") {
+            ensureQubitActive(args[0].qubit, line, column);
+            m_circuit.apply({GateKind::RZ, args[0].qubit, -1, args[1].floatValue});
+        } else if (name == "cx") {
+            ensureQubitActive(args[0].qubit, line, column);
+            ensureQubitActive(args[1].qubit, line, column);
+            m_circuit.apply({GateKind::CX, args[1].qubit, args[0].qubit});
+        }
+    }
+
+    bool RuntimeEvaluator::recordsControlled(const compiler::ASTNode* node) const {
+        return m_recording && m_recording->replayable && m_controlled &&
+               m_controlled->count(node);
+    }
+
+    bool RuntimeEvaluator::measuredInputs(const compiler::ASTNode* node,
+                                          std::vector<MeasuredInput>& inputs) {
+        for (const auto& name : m_controlled->at(node)) {
+            const Value* v = findLocal(name);
+            if (!v || v->type != Value::Type::Bit || v->measurement < 0)
+                return false;
+            auto it = std::find_if(inputs.begin(), inputs.end(), [&](const MeasuredInput& in) {
+                return in.measurement == v->measurement;
+            });
+            if (it == inputs.end())
+                it = inputs.insert(inputs.end(), MeasuredInput{v->measurement, {}});
+            it->names.push_back(name);
+        }
+        return inputs.size() <= static_cast<size_t>(CircuitCondition::kMaxMeasurements);
+    }
+
+    void RuntimeEvaluator::setMeasuredInputs(const std::vector<MeasuredInput>& inputs,
+                                             unsigned bits) {
+        for (size_t j = 0; j < inputs.size(); ++j)
+            for (const auto& name : inputs[j].names) findLocal(name)->bitValue = (bits >> j) & 1u;
+    }
+
+    bool RuntimeEvaluator::addCondition(const CircuitCondition& condition, bool negate,
+                                        int& index) {
+        int current = m_circuit.condition();
+        CircuitCondition enclosing =
+            current < 0 ? CircuitCondition{} : m_recording->conditions[current];
+        CircuitCondition combined;
+        if (!combineConditions(enclosing, condition, negate, combined))
+            return false;
+        index = static_cast<int>(m_recording->conditions.size());
+        m_recording->conditions.push_back(std::move(combined));
+        return true;
+    }
+
+    void RuntimeEvaluator::recordOnly(const std::function<void()>& fn) {
+        bool wasRecordOnly = m_circuit.recordOnly();
+        Profiler* profiler = m_profiler;
+        size_t depth = m_env.size();
+        m_profiler = nullptr;
+        m_circuit.setRecordOnly(true);
+        try {
+            fn();
+        } catch (const BlochError&) {
+            m_recording->replayable = false;
+            m_env.resize(depth);
+        }
+        m_circuit.setRecordOnly(wasRecordOnly);
+        m_profiler = profiler;
+    }
+
+    void RuntimeEvaluator::execControlledIf(IfStatement& node) {
+        std::vector<MeasuredInput> inputs;
+        CircuitCondition condition;
+        bool recorded = measuredInputs(&node, inputs);
+        unsigned actual = 0;
+        if (recorded) {
+            for (size_t j = 0; j < inputs.size(); ++j) {
+                condition.measurements.push_back(inputs[j].measurement);
+                actual |= static_cast<unsigned>(findLocal(inputs[j].names[0])->bitValue) << j;
+            }
+            // The condition only combines bits, so it can be evaluated for
+            // every outcome the shot could have had.
+            condition.truth = 0;
+            for (unsigned bits = 0; bits < (1u << inputs.size()); ++bits) {
+                setMeasuredInputs(inputs, bits);
+                if (isTruthy(eval(node.condition.get())))
+                    condition.truth |= std::uint64_t{1} << bits;
+            }
+            setMeasuredInputs(inputs, actual);
+        }
+        int thenCondition = -1;
+        int elseCondition = -1;
+        if (!recorded || !addCondition(condition, false, thenCondition) ||
+            !addCondition(condition, true, elseCondition)) {
+            m_recording->replayable = false;
+            if (isTruthy(eval(node.condition.get())))
+                exec(node.thenBranch.get());
+            else
+                exec(node.elseBranch.get());
+            return;
+        }
+        bool taken = (condition.truth >> actual) & 1u;
+        int previous = m_circuit.condition();
+        m_circuit.setCondition(taken ? thenCondition : elseCondition);
+        exec(taken ? node.thenBranch.get() : node.elseBranch.get());
+        m_circuit.setCondition(taken ? elseCondition : thenCondition);
+        recordOnly([&] { exec(taken ? node.elseBranch.get() : node.thenBranch.get()); });
+        m_circuit.setCondition(previous);
+    }
+
+    void RuntimeEvaluator::applyControlledGate(CallExpression& call, const std::string& name,
+                                               const std::vector<Value>& args) {
+        std::vector<MeasuredInput> inputs;
+        bool recorded = measuredInputs(&call, inputs);
+        unsigned actual = 0;
+        for (size_t j = 0; recorded && j < inputs.size(); ++j)
+            actual |= static_cast<unsigned>(findLocal(inputs[j].names[0])->bitValue) << j;
+        // One gate per outcome of the inputs, each under "the inputs were
+        // exactly these".
+        std::vector<int> conditions(size_t{1} << inputs.size(), -1);
+        for (unsigned bits = 0; recorded && bits < conditions.size(); ++bits) {
+            CircuitCondition exactly;
+            for (const auto& in : inputs) exactly.measurements.push_back(in.measurement);
+            exactly.truth = std::uint64_t{1} << bits;
+            recorded = addCondition(exactly, false, conditions[bits]);
+        }
+        if (!recorded) {
+            m_recording->replayable = false;
+            applyGate(name, args, call.line, call.column);
+            return;
+        }
+        int previous = m_circuit.condition();
+        m_circuit.setCondition(conditions[actual]);
+        applyGate(name, args, call.line, call.column);
+        for (unsigned bits = 0; bits < conditions.size(); ++bits) {
+            if (bits == actual)
+                continue;
+            m_circuit.setCondition(conditions[bits]);
+            recordOnly([&] {
+                setMeasuredInputs(inputs, bits);
+                std::vector<Value> other;
+                for (auto& a : call.arguments) other.push_back(eval(a.get()));
+                setMeasuredInputs(inputs, actual);
+                applyGate(name, other, call.line, call.column);
+            });
+        }
+        setMeasuredInputs(inputs, actual);
+        m_circuit.setCondition(previous);
+    }
+
+    int RuntimeEvaluator::measureQubit(int index, int line, int column) {
+        int bit = m_circuit.measure(index);
+        if (m_traceReplay)
+            bit = m_traceReplay->replayMeasurement(index, line, column);
+        if (m_traceRecorder)
+            m_traceRecorder->recordMeasurement(index, bit);
+        return bit;
+    }
+
     void RuntimeEvaluator::markMeasured(int index) {
         if (index >= 0 && index < static_cast<int>(m_qubits.size()))
             m_qubits[index].measured = true;
@@ -3175,38 +3466,11 @@ namespace bloch::runtime {
         for (auto& kv : m_env.back()) {
             if (!kv.second.tracked)
                 continue;
-            const auto& name = kv.first;
-            const auto& entry = kv.second;
-            const auto& v = entry.value;
-            if (v.type == Value::Type::Qubit) {
-                int q = v.qubit;
-                std::string outcome = "?";
-                if (q >= 0 && q < static_cast<int>(m_lastMeasurement.size()) &&
-                    m_lastMeasurement[q] != -1) {
-                    outcome = m_lastMeasurement[q] ? "1" : "0";
-                }
-                std::string key = std::string("qubit ") + name;
-                m_trackedCounts[key][outcome]++;
-            } else if (v.type == Value::Type::QubitArray) {
-                bool allMeasured = true;
-                std::string bits;
-                for (int q : v.qubitArray) {
-                    if (!(q >= 0 && q < static_cast<int>(m_lastMeasurement.size()) &&
-                          m_lastMeasurement[q] != -1)) {
-                        allMeasured = false;
-                        break;
-                    }
-                }
-                std::string outcome;
-                if (!allMeasured) {
-                    outcome = "?";
-                } else {
-                    for (int q : v.qubitArray) bits.push_back(m_lastMeasurement[q] ? '1' : '0');
-                    outcome = bits;
-                }
-                std::string key = std::string("qubit[] ") + name;
-                m_trackedCounts[key][outcome]++;
-            }
+            const auto& v = kv.second.value;
+            if (v.type == Value::Type::Qubit)
+                recordTrackedValue("qubit " + kv.first, v);
+            else if (v.type == Value::Type::QubitArray)
+                recordTrackedValue("qubit[] " + kv.first, v);
         }
         m_env.pop_back();
     }
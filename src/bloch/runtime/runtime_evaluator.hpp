@@ -17,6 +17,7 @@
 #include <atomic>
 #include <condition_variable>
 #include <cstdint>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <mutex>
@@ -27,8 +28,16 @@
 #include <utility>
 #include <vector>
 
+#include "bloch/compiler/analysis/feedback_analysis.hpp"
 #include "bloch/compiler/ast/ast.hpp"
+#include "bloch/runtime/circuit.hpp"
+#include "bloch/runtime/circuit_optimiser.hpp"
+#include "bloch/runtime/measurement_trace.hpp"
+#include "bloch/runtime/profiler.hpp"
 #include "bloch/runtime/qasm_simulator.hpp"
+#include "bloch/runtime/shot_log.hpp"
+#include "bloch/runtime/stopwatch.hpp"
+#include "bloch/runtime/timeline.hpp"
 
 namespace bloch::runtime {
 
@@ -133,6 +142,9 @@ namespace bloch::runtime {
         std::vector<std::shared_ptr<Object>> objectArray;
         RuntimeClass* classRef = nullptr;
         std::string className;
+        // While recording, the index in the circuit's ops of the measurement
+        // a bit came from; -1 for anything computed.
+        int measurement = -1;
 
         Value() = default;
         explicit Value(Type t) : type(t) {}
@@ -227,11 +239,26 @@ namespace bloch::runtime {
             return m_measurements;
         }
         std::string getQasm() const { return m_sim.getQasm(); }
+        // The simulator's statevector once execute() returns.
+        const std::vector<std::complex<double>>& state() const { return m_sim.state(); }
         size_t heapObjectCount();
 
        private:
         QasmSimulator m_sim;
+        // Gates, measurements and resets go through here, never to m_sim directly.
+        CircuitOptimiser m_circuit{m_sim};
+        Circuit* m_recording = nullptr;
+        const compiler::ControlledNodes* m_controlled = nullptr;
         bool m_collectQasmLog = true;
+        bool m_simulate = true;
+        int m_reserveQubits = 0;
+        std::optional<std::uint64_t> m_seed;
+        MeasurementTrace* m_traceRecorder = nullptr;
+        MeasurementTrace* m_traceReplay = nullptr;
+        ShotLog* m_shotLog = nullptr;
+        Profiler* m_profiler = nullptr;
+        Timeline* m_timeline = nullptr;
+        PhaseTime m_classTableTime;
         std::unordered_map<std::string, FunctionDeclaration*> m_functions;
         struct VarEntry {
             Value value;
@@ -278,15 +305,48 @@ namespace bloch::runtime {
         void exec(Statement* stmt);
         Value call(FunctionDeclaration* fn, const std::vector<Value>& args);
         Value lookup(const std::string& name);
+        // Local variable storage without the copy lookup() makes; nullptr if
+        // `name` is not a local. Invalidated by anything that touches m_env.
+        const Value* findLocal(const std::string& name) const;
+        Value* findLocal(const std::string& name);
         void assign(const std::string& name, const Value& v);
 
         // Qubit bookkeeping
         int allocateTrackedQubit(const std::string& name);
+        // Reuses released qubits first and grows the simulator once for the rest.
+        std::vector<int> allocateTrackedQubits(const std::string& name, int count);
+        // Measures through the circuit optimiser, recording or replaying the
+        // outcome when a measurement trace is attached.
+        int measureQubit(int index, int line, int column);
         void markMeasured(int index);
         void unmarkMeasured(int index);
         void ensureQubitActive(int index, int line, int column);
         void ensureQubitExists(int index, int line, int column);
         void warnUnmeasured() const;
+        void applyGate(const std::string& name, const std::vector<Value>& args, int line,
+                       int column);
+
+        // Recording controlled nodes (setControlled). A node's tainted
+        // variables are grouped by the measurement whose bit they hold; the
+        // node is then evaluated once per assignment of those bits.
+        struct MeasuredInput {
+            int measurement = -1;
+            std::vector<std::string> names;
+        };
+        bool recordsControlled(const compiler::ASTNode* node) const;
+        // False when a tainted variable does not hold a measured bit.
+        bool measuredInputs(const compiler::ASTNode* node, std::vector<MeasuredInput>& inputs);
+        // Sets input j's variables to bit j of `bits`.
+        void setMeasuredInputs(const std::vector<MeasuredInput>& inputs, unsigned bits);
+        // Adds the current condition and `condition` (or its negation) to the
+        // recording; false when they read too many measurements.
+        bool addCondition(const CircuitCondition& condition, bool negate, int& index);
+        void execControlledIf(IfStatement& node);
+        void applyControlledGate(CallExpression& call, const std::string& name,
+                                 const std::vector<Value>& args);
+        // Runs `fn` with gates only recorded, for a path this shot did not
+        // take; a failure there makes the recording unreplayable.
+        void recordOnly(const std::function<void()>& fn);
 
         // Class runtime helpers
         RuntimeTypeInfo typeInfoFromAst(Type* type) const;
@@ -338,6 +398,47 @@ namespace bloch::runtime {
        public:
         void setEcho(bool enabled) { m_echoEnabled = enabled; }
         void setWarnOnExit(bool enabled) { m_warnOnExit = enabled; }
+        void setCircuitOptimisation(bool enabled) { m_circuit.setEnabled(enabled); }
+        // Off: gates are only logged and every measurement reads 0 (--emit-only).
+        void setSimulation(bool enabled) { m_simulate = enabled; }
+        // Statevector capacity to set aside before running, e.g. from
+        // compiler::estimateResources.
+        void setQubitReservation(int qubits) { m_reserveQubits = qubits; }
+        // Seeds the simulator's measurement draws for the next run; without
+        // one each run draws a fresh seed from the operating system.
+        void setSeed(std::uint64_t seed) { m_seed = seed; }
+        // Appends every measurement outcome of this run to `trace`.
+        void setTraceRecorder(MeasurementTrace* trace) { m_traceRecorder = trace; }
+        // Takes measurement outcomes from `trace` instead of the simulator;
+        // pair with setSimulation(false).
+        void setTraceReplay(MeasurementTrace* trace) { m_traceReplay = trace; }
+        // Sets each @tracked outcome of this run in the current shot of `log`.
+        void setShotLog(ShotLog* log) { m_shotLog = log; }
+        // Reports this run's function calls and statements to `profiler`.
+        void setProfiler(Profiler* profiler) { m_profiler = profiler; }
+        // Adds this run's calls, gates, measurements and collections to
+        // `timeline`.
+        void setTimeline(Timeline* timeline) {
+            m_timeline = timeline;
+            m_circuit.setTimeline(timeline);
+        }
+        ProfileCounters profileCounters() const {
+            return {m_circuit.gatesSubmitted(), m_simulate ? m_circuit.simulatorOps() : 0};
+        }
+        // Records this run into `circuit` for replay (see analyseFeedback).
+        void setRecording(Circuit* circuit) {
+            m_recording = circuit;
+            m_circuit.setRecorder(circuit);
+        }
+        // While recording, gates of these nodes are recorded under conditions
+        // on the measurements they read, for every way the shot could go.
+        void setControlled(const compiler::ControlledNodes* nodes) { m_controlled = nodes; }
+        size_t gatesSubmitted() const { return m_circuit.gatesSubmitted(); }
+        size_t gatesRemoved() const { return m_circuit.gatesRemoved(); }
+        const GateCounts& gatesApplied() const { return m_circuit.gatesApplied(); }
+        size_t stateBytes() const { return m_sim.stateBytes(); }
+        // Time execute() spent building the class table and static fields.
+        PhaseTime classTableTime() const { return m_classTableTime; }
         const auto& trackedCounts() const { return m_trackedCounts; }
         // Test helper to observe whether the GC worker was started for this run.
         bool gcThreadStartedForTest() const { return m_gcThreadStarted; }
@@ -0,0 +1,176 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bloch/runtime/shot_log.hpp"
+
+#include <algorithm>
+
+#include "bloch/support/error/bloch_error.hpp"
+
+namespace bloch::runtime {
+
+    using support::BlochError;
+    using support::ErrorCategory;
+
+    namespace {
+        constexpr char kMagic[8] = {'B', 'L', 'O', 'C', 'H', 'S', 'H', 'T'};
+        constexpr std::uint32_t kVersion = 1;
+
+        bool isBits(const std::string& outcome) {
+            return !outcome.empty() && outcome.find_first_not_of("01") == std::string::npos;
+        }
+
+        void write(std::string& bytes, std::uint64_t value, int size) {
+            for (int i = 0; i < size; ++i) bytes.push_back(static_cast<char>(value >> (8 * i)));
+        }
+
+        // ORs the low `count` bits of `value` into `words` at bit `pos`.
+        void putBits(std::vector<std::uint64_t>& words, std::uint64_t pos, std::uint64_t value,
+                     size_t count) {
+            size_t last = static_cast<size_t>((pos + count + 63) / 64);
+            if (words.size() < last)
+                words.resize(last, 0);
+            if (value == 0)
+                return;
+            size_t word = static_cast<size_t>(pos / 64);
+            unsigned shift = static_cast<unsigned>(pos % 64);
+            words[word] |= value << shift;
+            if (shift + count > 64)
+                words[word + 1] |= value >> (64 - shift);
+        }
+    }  // namespace
+
+    ShotLog::ShotLog(const std::string& path)
+        : m_path(path), m_out(path, std::ios::binary | std::ios::trunc) {
+        check();
+    }
+
+    ShotLog::~ShotLog() {
+        try {
+            finish();
+        } catch (...) {
+            // Destructors cannot report errors; call finish() to see them.
+        }
+    }
+
+    void ShotLog::start(std::uint64_t seed, std::uint64_t firstShot) {
+        std::string bytes(kMagic, sizeof(kMagic));
+        write(bytes, kVersion, 4);
+        write(bytes, 0, 4);
+        write(bytes, seed, 8);
+        write(bytes, firstShot, 8);
+        m_out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        check();
+    }
+
+    void ShotLog::record(const std::string& key, const std::string& outcome) {
+        auto found = m_index.find(key);
+        if (found == m_index.end()) {
+            // A block has one schema, so a new column starts a new block.
+            flushBlock();
+            found = m_index.emplace(key, m_columns.size()).first;
+            m_columns.push_back(Column{key, 0, {}, {}});
+        }
+        Column& column = m_columns[found->second];
+        if (!isBits(outcome)) {
+            column.outcome.clear();
+            return;
+        }
+        if (outcome.size() > column.width) {
+            flushBlock();
+            column.width = outcome.size();
+        }
+        column.outcome = outcome;
+    }
+
+    void ShotLog::endShot(std::uint64_t copies) {
+        while (copies > 0) {
+            std::uint64_t take = std::min(copies, kBlockShots - m_blockShots);
+            for (auto& column : m_columns) append(column, take);
+            m_blockShots += take;
+            m_total += take;
+            copies -= take;
+            if (m_blockShots == kBlockShots)
+                flushBlock();
+        }
+        for (auto& column : m_columns) column.outcome.clear();
+    }
+
+    void ShotLog::append(Column& column, std::uint64_t copies) {
+        const size_t stride = column.width + 1;
+        std::uint64_t pos = m_blockShots * stride;
+        if (column.outcome.empty()) {
+            putBits(column.bits, pos, 0, static_cast<size_t>(copies * stride));
+            return;
+        }
+        const std::string& outcome = column.outcome;
+        const size_t bits = outcome.size();
+        if (stride <= 64) {
+            std::uint64_t value = 0;
+            for (char c : outcome) value = (value << 1) | (c == '1');
+            std::uint64_t packed = 1 | (value << 1);
+            for (std::uint64_t c = 0; c < copies; ++c, pos += stride)
+                putBits(column.bits, pos, packed, stride);
+            return;
+        }
+        for (std::uint64_t c = 0; c < copies; ++c, pos += stride) {
+            putBits(column.bits, pos, 1, 1);
+            for (size_t k = 0; k < bits; ++k)
+                putBits(column.bits, pos + 1 + k, outcome[bits - 1 - k] == '1', 1);
+            putBits(column.bits, pos + 1 + bits, 0, stride - 1 - bits);
+        }
+    }
+
+    void ShotLog::flushBlock() {
+        if (m_blockShots == 0)
+            return;
+        std::string bytes;
+        write(bytes, m_blockShots, 8);
+        write(bytes, m_columns.size(), 4);
+        write(bytes, 0, 4);
+        for (const auto& column : m_columns) {
+            write(bytes, column.name.size(), 4);
+            write(bytes, column.width, 4);
+            bytes += column.name;
+            bytes.append((8 - column.name.size() % 8) % 8, '\0');
+        }
+        m_out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        for (auto& column : m_columns) {
+            size_t words = static_cast<size_t>((m_blockShots * (column.width + 1) + 63) / 64);
+            column.bits.resize(words, 0);
+            bytes.clear();
+            bytes.reserve(words * 8);
+            for (std::uint64_t word : column.bits) write(bytes, word, 8);
+            m_out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+            column.bits.clear();
+        }
+        m_blockShots = 0;
+        check();
+    }
+
+    void ShotLog::finish() {
+        if (!m_out.is_open())
+            return;
+        flushBlock();
+        m_out.close();
+        check();
+    }
+
+    void ShotLog::check() {
+        if (m_out.fail())
+            throw BlochError(ErrorCategory::Runtime, 0, 0,
+                             "cannot write shot log '" + m_path + "'");
+    }
+
+}  // namespace bloch::runtime
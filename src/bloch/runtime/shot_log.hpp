@@ -0,0 +1,84 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace bloch::runtime {
+
+    // Streams every shot's @tracked outcomes to a file as they are produced,
+    // holding at most one block of shots in memory.
+    //
+    // On disk, little-endian and 8-byte aligned throughout: the bytes
+    // "BLOCHSHT", a u32 format version, a u32 of zero, the u64 run seed and
+    // the u64 index of the first shot logged. Blocks of up to kBlockShots
+    // shots follow until the end of the file. A block is a u64 shot count, a
+    // u32 column count and a u32 of zero, then one descriptor per column (u32
+    // name length, u32 outcome width W in bits, the name zero-padded to 8
+    // bytes), then each column's data in turn: W + 1 bits per shot, packed
+    // from the lowest bit of u64 words and padded to a whole word. A shot's
+    // first bit is set when the value had an outcome (it was sampled, with
+    // every qubit measured); the next W bits hold the outcome read as a
+    // binary number, lowest bit first.
+    class ShotLog {
+       public:
+        static constexpr std::uint64_t kBlockShots = 65536;
+
+        // Opens `path` for writing; throws a BlochError naming it on failure.
+        explicit ShotLog(const std::string& path);
+        ShotLog(const ShotLog&) = delete;
+        ShotLog& operator=(const ShotLog&) = delete;
+        ~ShotLog();
+
+        // Writes the header; called once, before the first shot.
+        void start(std::uint64_t seed, std::uint64_t firstShot);
+
+        // Sets `key`'s outcome in the current shot. A value sampled more than
+        // once in a shot keeps its last outcome.
+        void record(const std::string& key, const std::string& outcome);
+        // Appends the current shot `copies` times and starts the next one.
+        void endShot(std::uint64_t copies = 1);
+
+        // Writes the last partial block. Throws a BlochError on I/O errors.
+        void finish();
+
+        std::uint64_t shots() const { return m_total; }
+
+       private:
+        struct Column {
+            std::string name;
+            size_t width = 0;
+            std::vector<std::uint64_t> bits;  // this block's shots
+            // The current shot's outcome; empty when it has none.
+            std::string outcome;
+        };
+
+        std::string m_path;
+        std::ofstream m_out;
+        std::vector<Column> m_columns;
+        std::unordered_map<std::string, size_t> m_index;
+        std::uint64_t m_blockShots = 0;
+        std::uint64_t m_total = 0;
+
+        void append(Column& column, std::uint64_t copies);
+        void flushBlock();
+        void check();
+    };
+
+}  // namespace bloch::runtime
@@ -0,0 +1,58 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bloch/runtime/shot_progress.hpp"
+
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace bloch::runtime {
+
+    ShotProgress::ShotProgress(std::ostream& out, int total)
+        : m_out(out),
+          m_total(total),
+          m_start(std::chrono::steady_clock::now()),
+          m_nextDraw(m_start + kDelay) {}
+
+    void ShotProgress::draw(int done, std::chrono::steady_clock::time_point now) {
+        m_nextDraw = now + kRefresh;
+        double elapsed = std::chrono::duration<double>(now - m_start).count();
+        double rate = elapsed > 0.0 ? done / elapsed : 0.0;
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(1) << "Shots: " << done << " of " << m_total
+             << " (" << (m_total > 0 ? 100.0 * done / m_total : 100.0) << "%), "
+             << std::setprecision(0) << rate << " shots/s";
+        if (rate > 0.0 && done < m_total) {
+            long long left = std::llround((m_total - done) / rate);
+            line << ", ETA " << left / 60 << ":" << std::setw(2) << std::setfill('0')
+                 << left % 60;
+        }
+        std::string text = line.str();
+        std::size_t width = text.size();
+        if (width < m_width)
+            text.append(m_width - width, ' ');
+        m_width = width;
+        m_out << '\r' << text << std::flush;
+    }
+
+    void ShotProgress::finish() {
+        if (m_width == 0)
+            return;
+        m_out << '\r' << std::string(m_width, ' ') << '\r' << std::flush;
+        m_width = 0;
+    }
+
+}  // namespace bloch::runtime
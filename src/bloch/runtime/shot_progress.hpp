@@ -0,0 +1,55 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+
+namespace bloch::runtime {
+
+    // A one-line progress indicator for long shot runs: shots finished,
+    // shots per second and the time left, redrawn in place with '\r'.
+    // runShots reports every shot boundary; update() reads the steady clock
+    // and draws nothing until the run has taken kDelay, then at most once
+    // per kRefresh, so short runs print nothing and long ones barely pay.
+    class ShotProgress {
+       public:
+        static constexpr std::chrono::milliseconds kDelay{1000};
+        static constexpr std::chrono::milliseconds kRefresh{250};
+
+        // `total` is the most shots the run can take (its budget).
+        ShotProgress(std::ostream& out, int total);
+
+        // Called with the shots finished so far.
+        void update(int done) {
+            auto now = std::chrono::steady_clock::now();
+            if (now >= m_nextDraw)
+                draw(done, now);
+        }
+        // Erases the line, if one was drawn, so results start on a clean one.
+        void finish();
+
+       private:
+        std::ostream& m_out;
+        int m_total;
+        std::chrono::steady_clock::time_point m_start;
+        std::chrono::steady_clock::time_point m_nextDraw;
+        std::size_t m_width = 0;  // of the line on screen
+
+        void draw(int done, std::chrono::steady_clock::time_point now);
+    };
+
+}  // namespace bloch::runtime
@@ -0,0 +1,327 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "bloch/runtime/shot_runner.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "bloch/compiler/analysis/feedback_analysis.hpp"
+#include "bloch/compiler/analysis/resource_estimator.hpp"
+#include "bloch/runtime/batched_simulator.hpp"
+#include "bloch/runtime/random.hpp"
+#include "bloch/runtime/runtime_evaluator.hpp"
+
+namespace bloch::runtime {
+
+    namespace {
+        // Shots before an adaptive run first checks its intervals.
+        constexpr int kFirstAdaptiveRound = 100;
+        // Two-sided 95% normal quantile.
+        constexpr double kZ95 = 1.959963984540054;
+        // Replayed shots between progress reports and stop checks, for the
+        // strategies whose cost grows with the shot count. A multiple of the
+        // batched replay's 64 lanes.
+        constexpr int kReplayChunk = 1 << 16;
+
+        void collect(const RuntimeEvaluator& evaluator, ShotResult& result) {
+            for (const auto& vk : evaluator.trackedCounts())
+                for (const auto& vv : vk.second)
+                    result.trackedCounts[vk.first][vv.first] += vv.second;
+            for (size_t k = 0; k < kGateKinds; ++k)
+                result.gatesApplied[k] += evaluator.gatesApplied()[k];
+            result.peakStateBytes = std::max(result.peakStateBytes, evaluator.stateBytes());
+            result.classTableTime += evaluator.classTableTime();
+        }
+
+        void collectLast(const RuntimeEvaluator& evaluator, const ShotOptions& options,
+                         ShotResult& result) {
+            Stopwatch qasmWatch;
+            result.qasm = evaluator.getQasm();
+            result.qasmTime = qasmWatch.elapsed();
+            if (options.keepState)
+                result.state = evaluator.state();
+            result.gatesSubmitted = evaluator.gatesSubmitted();
+            result.gatesRemoved = evaluator.gatesRemoved();
+        }
+
+        // Statevector storage the replay of `circuit` holds at most: the
+        // tree replay keeps a copy per measurement on the current path, the
+        // batched replay a row of lanes per basis state.
+        size_t replayStateBytes(const Circuit& circuit) {
+            size_t state = QasmSimulator::kBytesPerAmplitude << circuit.qubits;
+            if (prefersBranching(circuit)) {
+                size_t measurements = 0;
+                for (const auto& op : circuit.ops)
+                    if (op.kind == CircuitOp::Kind::Measure)
+                        ++measurements;
+                return state * (measurements + 1);
+            }
+            if (circuit.qubits <= BatchedSimulator::kMaxQubits)
+                return state * BatchedSimulator::kMaxLanes;
+            return state;
+        }
+    }  // namespace
+
+    double wilsonIntervalWidth(int successes, int trials) {
+        if (trials <= 0)
+            return 1.0;
+        constexpr double z = kZ95;
+        double n = trials;
+        double p = successes / n;
+        double z2n = z * z / n;
+        return 2.0 * z * std::sqrt(p * (1.0 - p) / n + z2n / (4.0 * n)) / (1.0 + z2n);
+    }
+
+    double widestInterval(const TrackedCounts& counts) {
+        double widest = -1.0;
+        for (const auto& var : counts) {
+            // A value tracked inside a loop is counted more than once a shot,
+            // so each table is its own sample.
+            int trials = 0;
+            for (const auto& outcome : var.second)
+                trials += outcome.second;
+            for (const auto& outcome : var.second)
+                widest = std::max(widest, wilsonIntervalWidth(outcome.second, trials));
+        }
+        return widest;
+    }
+
+    void planShots(compiler::Program& program, int optLevel, ShotOptions& options) {
+        if (optLevel < 1)
+            return;
+        if (options.simulate && !options.replayTrace) {
+            // Size the statevector once when the qubit count is known
+            // exactly; the budget keeps this cheap for long loops.
+            auto resources = compiler::estimateResources(program, 100'000);
+            if (resources.exact)
+                options.reserveQubits = resources.qubits;
+        }
+        // Feedback-free programs only run the interpreter for one shot, as do
+        // those whose feedback only decides which gates apply.
+        auto feedback = compiler::analyseFeedback(program);
+        options.replay = feedback.replayable;
+        options.controlled = std::move(feedback.controlled);
+    }
+
+    ShotResult runShots(compiler::Program& program, const ShotOptions& options) {
+        ShotResult result;
+        result.seed = options.seed ? *options.seed : randomSeed();
+        // Shot s draws from stream s of shotStream; replayed shots share
+        // replayStream, split by the replay strategy.
+        std::uint64_t shotStream = streamSeed(result.seed, 0);
+        std::uint64_t replayStream = streamSeed(result.seed, 1);
+        // This shard's shots: [begin, end) of the whole run.
+        auto bound = [&](int shard) {
+            return static_cast<int>(static_cast<long long>(options.shots) * shard /
+                                    options.shardCount);
+        };
+        const int begin = bound(options.shard);
+        const int end = bound(options.shard + 1);
+        const int budget = end - begin;
+        if (options.shotLog)
+            options.shotLog->start(result.seed, static_cast<std::uint64_t>(begin));
+        bool adaptive = options.ciWidth > 0.0;
+        // Shots up to the next convergence check: the whole budget, or the
+        // count the current proportions need (normal approximation), taken at
+        // least an eighth and at most a doubling further so checks stay rare.
+        auto nextCheck = [&](int done) {
+            if (!adaptive)
+                return budget;
+            if (done < kFirstAdaptiveRound)
+                return std::min(budget, kFirstAdaptiveRound);
+            double spread = 0.0;
+            for (const auto& var : result.trackedCounts) {
+                int trials = 0;
+                for (const auto& outcome : var.second)
+                    trials += outcome.second;
+                for (const auto& outcome : var.second) {
+                    double p = static_cast<double>(outcome.second) / trials;
+                    spread = std::max(spread, p * (1.0 - p));
+                }
+            }
+            double needed = 4.0 * kZ95 * kZ95 * spread / (options.ciWidth * options.ciWidth);
+            long long target = std::clamp(static_cast<long long>(std::ceil(needed)),
+                                          static_cast<long long>(done) + done / 8 + 1,
+                                          2LL * done);
+            return static_cast<int>(std::min<long long>(budget, target));
+        };
+        auto converged = [&]() {
+            if (!adaptive)
+                return false;
+            double widest = widestInterval(result.trackedCounts);
+            return widest >= 0.0 && widest <= options.ciWidth;
+        };
+        auto stopRequested = [&]() {
+            return options.stop && options.stop->load(std::memory_order_relaxed);
+        };
+        auto reportProgress = [&]() {
+            if (options.progress)
+                options.progress->update(result.shotsRun);
+        };
+        // Interprets shots [from, end) of this shard; `warned` when a shot
+        // before them already printed the warnings.
+        auto interpret = [&](int from, bool warned) {
+            int check = nextCheck(0);
+            for (int s = from; s < end; ++s) {
+                // Adaptive runs cannot know their last shot, so they report the first.
+                bool last = adaptive ? s == begin : s == end - 1;
+                // An interruptible run keeps the first shot's QASM until the last
+                // replaces it.
+                bool first = options.stop && !adaptive && s == begin;
+                RuntimeEvaluator evaluator(last || first);
+                evaluator.setEcho(options.echo);
+                evaluator.setCircuitOptimisation(options.circuitOptimisation);
+                evaluator.setSimulation(options.simulate && !options.replayTrace);
+                evaluator.setQubitReservation(options.reserveQubits);
+                evaluator.setSeed(streamSeed(shotStream, static_cast<std::uint64_t>(s)));
+                evaluator.setTraceRecorder(options.recordTrace);
+                evaluator.setTraceReplay(options.replayTrace);
+                evaluator.setShotLog(options.shotLog);
+                evaluator.setProfiler(options.profiler);
+                evaluator.setTimeline(options.timeline);
+                double shotStart = options.timeline ? options.timeline->now() : 0.0;
+                // Suppress per-shot warnings; only show for last shot
+                if (!last || !options.warnings || warned)
+                    evaluator.setWarnOnExit(false);
+                evaluator.execute(program);
+                if (options.timeline)
+                    options.timeline->complete("shot", "shot", shotStart, {{"shot", s}});
+                collect(evaluator, result);
+                if (options.shotLog)
+                    options.shotLog->endShot();
+                if (last || first)
+                    collectLast(evaluator, options, result);
+                result.shotsRun = s - begin + 1;
+                reportProgress();
+                if (result.shotsRun == check) {
+                    if (converged())
+                        break;
+                    check = nextCheck(check);
+                }
+                if (s + 1 < end && stopRequested()) {
+                    result.interrupted = true;
+                    break;
+                }
+            }
+            result.widestInterval = widestInterval(result.trackedCounts);
+        };
+        bool tracing = options.recordTrace || options.replayTrace;
+        if (options.replay && options.simulate && !tracing && !options.echo && options.shots > 1) {
+            // Shot 0 is interpreted as usual (QASM, warnings) and records its
+            // circuit; the rest never touch the interpreter. Every shard
+            // records, but only the one holding shot 0 counts it.
+            Circuit circuit;
+            {
+                RuntimeEvaluator evaluator;
+                evaluator.setEcho(false);
+                evaluator.setWarnOnExit(options.warnings);
+                evaluator.setCircuitOptimisation(options.circuitOptimisation);
+                evaluator.setSimulation(options.simulate);
+                evaluator.setQubitReservation(options.reserveQubits);
+                evaluator.setSeed(streamSeed(shotStream, 0));
+                evaluator.setRecording(&circuit);
+                evaluator.setControlled(&options.controlled);
+                evaluator.setProfiler(options.profiler);
+                evaluator.setTimeline(options.timeline);
+                double shotStart = options.timeline ? options.timeline->now() : 0.0;
+                bool counted = begin == 0 && budget > 0;
+                if (counted)
+                    evaluator.setShotLog(options.shotLog);
+                evaluator.execute(program);
+                if (counted) {
+                    collect(evaluator, result);
+                    if (options.shotLog)
+                        options.shotLog->endShot();
+                    result.shotsRun = 1;
+                }
+                if (options.timeline)
+                    options.timeline->complete("shot", "shot", shotStart, {{"shot", 0}});
+                collectLast(evaluator, options, result);
+            }
+            reportProgress();
+            // Replayed shot r is shot r + 1 of the run.
+            int next = std::max(begin, 1);
+            if (!circuit.replayable) {
+                // A controlled node the run could not record: the remaining
+                // shots are interpreted after all.
+                interpret(next, true);
+                return result;
+            }
+            GateCounts circuitGates{};
+            for (const auto& op : circuit.ops)
+                if (op.kind == CircuitOp::Kind::Gate && op.condition < 0)
+                    ++circuitGates[static_cast<size_t>(op.gate.kind)];
+            if (next < end)
+                result.peakStateBytes =
+                    std::max(result.peakStateBytes, replayStateBytes(circuit));
+            auto replayStart = std::chrono::steady_clock::now();
+            bool branching = prefersBranching(circuit);
+            while (next < end) {
+                if (stopRequested()) {
+                    result.interrupted = true;
+                    break;
+                }
+                int upto = begin + nextCheck(result.shotsRun);
+                if (!adaptive && !branching && (options.progress || options.stop)) {
+                    // Slices draw what they draw in the whole run, so
+                    // chunking leaves the counts unchanged. The tree replay's
+                    // cost barely grows with shots, so it runs in one go.
+                    upto = std::min(upto, next + kReplayChunk - (next - 1) % kReplayChunk);
+                }
+                double roundStart = options.timeline ? options.timeline->now() : 0.0;
+                ReplaySlice slice{options.shots - 1, next - 1, upto - 1, replayStream};
+                if (adaptive) {
+                    // A slice of the tree replay is only a sample once all
+                    // slices are merged, so each round replays a run of its own.
+                    slice = ReplaySlice{upto - next, 0, upto - next,
+                                        streamSeed(replayStream, static_cast<std::uint64_t>(next))};
+                }
+                if (branching) {
+                    replayCircuitBranching(circuit, slice, result.trackedCounts, options.shotLog);
+                } else if (circuit.qubits <= BatchedSimulator::kMaxQubits) {
+                    replayCircuitBatched(circuit, slice, result.trackedCounts, options.shotLog);
+                } else {
+                    for (int r = slice.begin; r < slice.end; ++r)
+                        replayCircuit(circuit, streamSeed(slice.seed, r), result.trackedCounts,
+                                      options.shotLog);
+                }
+                for (size_t k = 0; k < kGateKinds; ++k)
+                    result.gatesApplied[k] += circuitGates[k] * (upto - next);
+                result.replayedShots += upto - next;
+                if (options.timeline) {
+                    options.timeline->complete("shot", "replayed shots", roundStart,
+                                               {{"first", next}, {"shots", upto - next}});
+                }
+                result.shotsRun += upto - next;
+                next = upto;
+                reportProgress();
+                if (converged())
+                    break;
+            }
+            if (options.profiler) {
+                std::chrono::duration<double> replayTime =
+                    std::chrono::steady_clock::now() - replayStart;
+                options.profiler->addExternal("(circuit replay)", replayTime.count());
+            }
+            result.widestInterval = widestInterval(result.trackedCounts);
+            return result;
+        }
+        interpret(begin, false);
+        return result;
+    }
+
+}  // namespace bloch::runtime
@@ -0,0 +1,140 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <atomic>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "bloch/compiler/analysis/feedback_analysis.hpp"
+#include "bloch/compiler/ast/ast.hpp"
+#include "bloch/runtime/circuit.hpp"
+#include "bloch/runtime/measurement_trace.hpp"
+#include "bloch/runtime/profiler.hpp"
+#include "bloch/runtime/shot_log.hpp"
+#include "bloch/runtime/shot_progress.hpp"
+#include "bloch/runtime/stopwatch.hpp"
+#include "bloch/runtime/timeline.hpp"
+
+namespace bloch::runtime {
+
+    struct ShotOptions {
+        int shots = 1;
+        bool echo = true;
+        bool circuitOptimisation = false;
+        // Off: log gates without a statevector; only valid for feedback-free
+        // programs, whose QASM does not depend on measurement outcomes.
+        bool simulate = true;
+        // The program is feedback-free, or its only feedback is in `controlled`
+        // (compiler::analyseFeedback). When echo is off, shots after the first
+        // replay the circuit the first recorded.
+        bool replay = false;
+        // Branches and gate calls the recorded circuit holds under conditions
+        // on measurements; shots are interpreted if the recording run finds
+        // one it cannot express.
+        compiler::ControlledNodes controlled;
+        // Qubits to size the statevector for up front, or 0 to grow on demand.
+        int reserveQubits = 0;
+        // Append every shot's measurement outcomes to this trace.
+        MeasurementTrace* recordTrace = nullptr;
+        // Take measurement outcomes from this trace and keep no statevector.
+        MeasurementTrace* replayTrace = nullptr;
+        // Append every shot's @tracked outcomes to this log, in shot order.
+        // runShots writes its header; the caller calls finish().
+        ShotLog* shotLog = nullptr;
+        // Profile every interpreted shot; replayed shots are charged to a
+        // single "(circuit replay)" frame.
+        Profiler* profiler = nullptr;
+        // Add an event per shot (per round of replayed shots) and everything
+        // interpreted shots do to this timeline.
+        Timeline* timeline = nullptr;
+        // When positive, `shots` is a budget: shots run in doubling rounds and
+        // stop once every @tracked outcome's 95% Wilson interval is at most
+        // this wide.
+        double ciWidth = 0.0;
+        // Seed for every measurement draw; one is drawn from the OS if unset.
+        // Each shot (or block of replayed shots) draws from its own stream of
+        // this seed, so results depend only on the seed and shot count.
+        std::optional<std::uint64_t> seed;
+        // Run shard `shard` of `shardCount`: a contiguous slice of the shots,
+        // drawing exactly what those shots draw in the whole run.
+        int shard = 0;
+        int shardCount = 1;
+        // Off: no unmeasured-qubit warnings on stderr.
+        bool warnings = true;
+        // Copy the statevector of the shot the QASM comes from into the result.
+        bool keepState = false;
+        // Told the shots finished at every shot boundary (every round or
+        // chunk of replayed shots).
+        ShotProgress* progress = nullptr;
+        // Checked at the same boundaries; once set, the run stops there and
+        // returns what the finished shots produced, with `interrupted` set.
+        // The QASM then comes from the first shot.
+        const std::atomic<bool>* stop = nullptr;
+    };
+
+    struct ShotResult {
+        TrackedCounts trackedCounts;
+        // QASM of one interpreted shot; warnings are printed for that shot only.
+        std::string qasm;
+        size_t gatesSubmitted = 0;
+        size_t gatesRemoved = 0;
+        // Gates applied to a simulator over all shots run; a replayed shot
+        // counts every unconditional gate of the recorded circuit, even where
+        // the tree replay shares it with other shots, and no conditional one.
+        GateCounts gatesApplied{};
+        // Most statevector storage held at once by one shot's simulator, or
+        // by a replay strategy across its live copies or lanes.
+        size_t peakStateBytes = 0;
+        // Summed over interpreted shots.
+        PhaseTime classTableTime;
+        // Building `qasm` from the simulator's log.
+        PhaseTime qasmTime;
+        int replayedShots = 0;
+        // Shots run by this call (this shard's share when sharding).
+        int shotsRun = 0;
+        std::uint64_t seed = 0;
+        // Widest 95% interval over all @tracked outcomes, or -1 when nothing
+        // was tracked.
+        double widestInterval = -1.0;
+        // Final statevector of the QASM's shot, with ShotOptions::keepState.
+        std::vector<std::complex<double>> state;
+        // ShotOptions::stop ended the run before its last shot.
+        bool interrupted = false;
+    };
+
+    // Width of the 95% Wilson score interval for `successes` out of `trials`.
+    double wilsonIntervalWidth(int successes, int trials);
+
+    // Widest wilsonIntervalWidth over every outcome of every tracked value,
+    // or -1 when `counts` is empty.
+    double widestInterval(const TrackedCounts& counts);
+
+    // Sets the options that depend on the analysed and optimised program:
+    // the statevector reservation (when the qubit count is known exactly) and
+    // circuit replay (for feedback-free programs and those whose feedback
+    // replay can express). Both need opt level 1+.
+    void planShots(compiler::Program& program, int optLevel, ShotOptions& options);
+
+    // Executes `program` options.shots times (or until options.ciWidth is
+    // met) and aggregates @tracked counts.
+    ShotResult runShots(compiler::Program& program, const ShotOptions& options);
+
+}  // namespace bloch::runtime
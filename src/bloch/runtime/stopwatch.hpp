@@ -0,0 +1,62 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <ctime>
+
+namespace bloch::runtime {
+
+    // Wall-clock and process CPU time spent on something.
+    struct PhaseTime {
+        double wallSeconds = 0.0;
+        double cpuSeconds = 0.0;
+
+        PhaseTime& operator+=(const PhaseTime& other) {
+            wallSeconds += other.wallSeconds;
+            cpuSeconds += other.cpuSeconds;
+            return *this;
+        }
+        PhaseTime& operator-=(const PhaseTime& other) {
+            wallSeconds -= other.wallSeconds;
+            cpuSeconds -= other.cpuSeconds;
+            return *this;
+        }
+    };
+
+    // Measures PhaseTime from construction or the previous lap(). CPU time
+    // is std::clock(), so it covers every thread of the process.
+    class Stopwatch {
+       public:
+        Stopwatch() : m_wall(std::chrono::steady_clock::now()), m_cpu(std::clock()) {}
+
+        PhaseTime elapsed() const {
+            std::chrono::duration<double> wall = std::chrono::steady_clock::now() - m_wall;
+            return {wall.count(), static_cast<double>(std::clock() - m_cpu) / CLOCKS_PER_SEC};
+        }
+        // Returns the time since the previous lap and starts the next.
+        PhaseTime lap() {
+            PhaseTime time = elapsed();
+            m_wall = std::chrono::steady_clock::now();
+            m_cpu = std::clock();
+            return time;
+        }
+
+       private:
+        std::chrono::steady_clock::time_point m_wall;
+        std::clock_t m_cpu;
+    };
+
+}  // namespace bloch::runtime
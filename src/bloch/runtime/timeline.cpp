@@ -0,0 +1,100 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bloch/runtime/timeline.hpp"
+
+#include <atomic>
+#include <iomanip>
+
+#include "bloch/support/error/bloch_error.hpp"
+#include "bloch/support/json.hpp"
+
+namespace bloch::runtime {
+
+    using support::BlochError;
+    using support::ErrorCategory;
+    using support::jsonString;
+
+    namespace {
+        // 1 for the first thread to record an event, 2 for the next, ...
+        int threadId() {
+            static std::atomic<int> next{1};
+            thread_local int id = next.fetch_add(1);
+            return id;
+        }
+    }  // namespace
+
+    Timeline::Timeline(const std::string& path)
+        : m_path(path), m_out(path, std::ios::trunc), m_epoch(std::chrono::steady_clock::now()) {
+        check();
+        m_out << std::fixed << std::setprecision(3);
+        m_out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+              << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << threadId()
+              << ",\"args\":{\"name\":\"bloch\"}}";
+    }
+
+    Timeline::~Timeline() {
+        try {
+            finish();
+        } catch (...) {
+            // Destructors cannot report errors; call finish() to see them.
+        }
+    }
+
+    void Timeline::complete(std::string_view category, std::string_view name, double start,
+                            std::initializer_list<TimelineArg> args) {
+        double end = now();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_out.is_open())
+            return;
+        if (m_events == kMaxEvents) {
+            ++m_dropped;
+            return;
+        }
+        ++m_events;
+        m_out << ",\n{\"name\":" << jsonString(name) << ",\"cat\":" << jsonString(category)
+              << ",\"ph\":\"X\",\"ts\":" << start << ",\"dur\":" << end - start
+              << ",\"pid\":1,\"tid\":" << threadId();
+        if (args.size() != 0) {
+            m_out << ",\"args\":{";
+            bool first = true;
+            for (const auto& arg : args) {
+                m_out << (first ? "" : ",") << jsonString(arg.key) << ":" << arg.value;
+                first = false;
+            }
+            m_out << "}";
+        }
+        m_out << "}";
+    }
+
+    void Timeline::finish() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_out.is_open())
+            return;
+        if (m_dropped > 0) {
+            m_out << ",\n{\"name\":\"events dropped\",\"ph\":\"i\",\"s\":\"g\",\"ts\":" << now()
+                  << ",\"pid\":1,\"tid\":" << threadId() << ",\"args\":{\"dropped\":" << m_dropped
+                  << ",\"limit\":" << kMaxEvents << "}}";
+        }
+        m_out << "\n]}\n";
+        m_out.close();
+        check();
+    }
+
+    void Timeline::check() {
+        if (m_out.fail())
+            throw BlochError(ErrorCategory::Runtime, 0, 0, "cannot write trace '" + m_path + "'");
+    }
+
+}  // namespace bloch::runtime
@@ -0,0 +1,80 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace bloch::runtime {
+
+    // A numeric argument shown with an event, e.g. {"qubit", 3}.
+    struct TimelineArg {
+        std::string_view key;
+        long long value = 0;
+    };
+
+    // Streams Chrome trace events (the JSON format chrome://tracing and
+    // Perfetto open) to a file: one complete event, with a start and a
+    // duration, per phase, call, gate, measurement, collection or shot.
+    // Events may come from any thread and carry a small id for it.
+    //
+    // Callers hold a Timeline pointer that is null when tracing is off, so a
+    // disabled timeline costs one predictable branch per site. After
+    // kMaxEvents events further ones are dropped, and the file records how
+    // many.
+    class Timeline {
+       public:
+        static constexpr size_t kMaxEvents = 1'000'000;
+
+        // Opens `path` for writing; throws a BlochError naming it on failure.
+        explicit Timeline(const std::string& path);
+        Timeline(const Timeline&) = delete;
+        Timeline& operator=(const Timeline&) = delete;
+        ~Timeline();
+
+        // Microseconds since the timeline was created.
+        double now() const {
+            return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() -
+                                                             m_epoch)
+                .count();
+        }
+
+        // An event named `name` in `category` from `start` until now.
+        void complete(std::string_view category, std::string_view name, double start,
+                      std::initializer_list<TimelineArg> args = {});
+
+        // Closes the event list. Throws a BlochError on I/O errors.
+        void finish();
+
+        size_t events() const { return m_events; }
+        size_t dropped() const { return m_dropped; }
+
+       private:
+        std::string m_path;
+        std::ofstream m_out;
+        std::chrono::steady_clock::time_point m_epoch;
+        std::mutex m_mutex;
+        size_t m_events = 0;
+        size_t m_dropped = 0;
+
+        void check();
+    };
+
+}  // namespace bloch::runtime
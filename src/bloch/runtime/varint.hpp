@@ -0,0 +1,51 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace bloch::runtime {
+
+    // LEB128 varints, as used by the runtime's binary files: seven bits per
+    // byte, least significant first, the high bit set on all but the last.
+    inline void putVarint(std::string& bytes, std::uint64_t value) {
+        do {
+            char byte = static_cast<char>(value & 0x7f);
+            value >>= 7;
+            bytes.push_back(static_cast<char>(byte | (value ? 0x80 : 0)));
+        } while (value);
+    }
+
+    // Reads the varint at `pos` into `value` and moves `pos` past it. Returns
+    // false if the bytes end first or the value does not fit in 64 bits.
+    inline bool readVarint(const std::string& bytes, std::size_t& pos, std::uint64_t& value) {
+        value = 0;
+        for (int shift = 0; pos < bytes.size(); shift += 7) {
+            auto byte = static_cast<unsigned char>(bytes[pos++]);
+            // The tenth byte holds only the top bit.
+            if (shift == 63 && (byte & 0x7e))
+                return false;
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+                return true;
+            if (shift == 63)
+                return false;
+        }
+        return false;
+    }
+
+}  // namespace bloch::runtime
@@ -94,18 +94,22 @@ namespace bloch::support {
             : std::runtime_error(format(category, line, column, msg)),
               line(line),
               column(column),
-              category(category) {}
+              category(category),
+              message(msg) {}
 
         // default to Generic error category
         BlochError(int line, int column, const std::string& msg)
             : std::runtime_error(format(ErrorCategory::Generic, line, column, msg)),
               line(line),
               column(column),
-              category(ErrorCategory::Generic) {}
+              category(ErrorCategory::Generic),
+              message(msg) {}
 
         int line;
         int column;
         ErrorCategory category;
+        // The message without category, location or colour codes.
+        std::string message;
     };
 
     inline void blochInfo(int line, int column, const std::string& msg) {
@@ -0,0 +1,132 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "bloch/capi/bloch.h"
+#include "test_framework.hpp"
+
+namespace {
+    std::string tracked(const bloch_result* result, size_t index) {
+        size_t length = 0;
+        bloch_result_tracked_name(result, index, nullptr, 0, &length);
+        std::string name(length + 1, '\0');
+        bloch_result_tracked_name(result, index, name.data(), name.size(), nullptr);
+        name.resize(length);
+        return name;
+    }
+}  // namespace
+
+TEST(CApiTest, CompilesRunsAndReportsHistogram) {
+    const char* source = R"(
+@shots(200)
+function main() -> void {
+    @tracked qubit[2] q;
+    h(q[0]);
+    cx(q[0], q[1]);
+    measure q;
+})";
+    bloch_program* program = nullptr;
+    ASSERT_TRUE(bloch_program_compile(source, "bell.bloch", nullptr, 0, 1, &program) == BLOCH_OK);
+    EXPECT_EQ(bloch_program_shots(program), 200);
+
+    bloch_result* result = nullptr;
+    ASSERT_TRUE(bloch_run(program, 0, 11, 0, &result) == BLOCH_OK);
+    EXPECT_EQ(bloch_result_shots(result), 200);
+    ASSERT_TRUE(bloch_result_tracked_count(result) == 1);
+    EXPECT_EQ(tracked(result, 0), "qubit[] q");
+    ASSERT_TRUE(bloch_result_outcome_count(result, 0) == 2);
+    uint64_t total = 0;
+    for (size_t i = 0; i < 2; ++i) {
+        char outcome[8];
+        uint64_t count = 0;
+        ASSERT_TRUE(bloch_result_outcome(result, 0, i, outcome, sizeof outcome, nullptr,
+                                         &count) == BLOCH_OK);
+        EXPECT_EQ(std::string(outcome), i == 0 ? "00" : "11");
+        total += count;
+    }
+    EXPECT_EQ(total, 200u);
+
+    // The same seed gives the same histogram.
+    bloch_result* again = nullptr;
+    ASSERT_TRUE(bloch_run(program, 0, 11, 0, &again) == BLOCH_OK);
+    uint64_t first = 0;
+    uint64_t second = 0;
+    bloch_result_outcome(result, 0, 0, nullptr, 0, nullptr, &first);
+    bloch_result_outcome(again, 0, 0, nullptr, 0, nullptr, &second);
+    EXPECT_EQ(first, second);
+
+    size_t length = 0;
+    char small[4];
+    EXPECT_TRUE(bloch_result_qasm(result, small, sizeof small, &length) ==
+                BLOCH_ERROR_BUFFER_TOO_SMALL);
+    std::string qasm(length + 1, '\0');
+    ASSERT_TRUE(bloch_result_qasm(result, qasm.data(), qasm.size(), nullptr) == BLOCH_OK);
+    EXPECT_NE(qasm.find("cx q[0],q[1];"), std::string::npos);
+    EXPECT_TRUE(bloch_result_statevector(result, nullptr, 0, nullptr) == BLOCH_ERROR_ARGUMENT);
+
+    bloch_result_free(again);
+    bloch_result_free(result);
+    bloch_program_free(program);
+}
+
+TEST(CApiTest, ReturnsStatevectorOfOneShot) {
+    const char* source = R"(
+function main() -> void {
+    qubit[2] q;
+    x(q[1]);
+    h(q[0]);
+})";
+    bloch_program* program = nullptr;
+    ASSERT_TRUE(bloch_program_compile(source, "state.bloch", nullptr, 0, 1, &program) ==
+                BLOCH_OK);
+    bloch_result* result = nullptr;
+    ASSERT_TRUE(bloch_run(program, 1, 3, BLOCH_RUN_KEEP_STATEVECTOR, &result) == BLOCH_OK);
+    size_t amplitudes = 0;
+    bloch_result_statevector(result, nullptr, 0, &amplitudes);
+    ASSERT_TRUE(amplitudes == 4);
+    std::vector<double> state(2 * amplitudes);
+    ASSERT_TRUE(bloch_result_statevector(result, state.data(), amplitudes, nullptr) == BLOCH_OK);
+    // (|10> + |11>) / sqrt(2) with qubit 1 as bit 1: indices 2 and 3.
+    EXPECT_TRUE(std::abs(state[0]) < 1e-12 && std::abs(state[2]) < 1e-12);
+    EXPECT_TRUE(std::abs(state[4] - std::sqrt(0.5)) < 1e-12);
+    EXPECT_TRUE(std::abs(state[6] - std::sqrt(0.5)) < 1e-12);
+    bloch_result_free(result);
+    bloch_program_free(program);
+}
+
+TEST(CApiTest, ReportsErrorsWithPosition) {
+    bloch_program* program = nullptr;
+    EXPECT_TRUE(bloch_program_compile("function main() -> void { int a = ; }", "bad.bloch",
+                                      nullptr, 0, 1, &program) == BLOCH_ERROR_PARSE);
+    EXPECT_TRUE(program == nullptr);
+    EXPECT_EQ(std::string(bloch_last_error()), "1:35: Expected expression");
+    EXPECT_TRUE(bloch_program_compile("", "empty.bloch", nullptr, 0, 7, &program) ==
+                BLOCH_ERROR_ARGUMENT);
+
+    const char* source = R"(
+function main() -> void {
+    int[] a = {1, 2};
+    echo(a[5]);
+})";
+    ASSERT_TRUE(bloch_program_compile(source, "oob.bloch", nullptr, 0, 1, &program) ==
+                BLOCH_OK);
+    bloch_result* result = nullptr;
+    EXPECT_TRUE(bloch_run(program, 1, 0, 0, &result) == BLOCH_ERROR_RUNTIME);
+    EXPECT_TRUE(result == nullptr);
+    EXPECT_NE(std::string(bloch_last_error()).find("4:"), std::string::npos);
+    bloch_program_free(program);
+}
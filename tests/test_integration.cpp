@@ -17,11 +17,14 @@
 TEST(IntegrationTest, SkippedOnWindows) { EXPECT_TRUE(true); }
 #else
 #include <array>
+#include <atomic>
 #include <cstdio>
 #include <filesystem>
 #include <fstream>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 #if defined(_WIN32)
 #include <windows.h>
@@ -32,7 +35,11 @@ TEST(IntegrationTest, SkippedOnWindows) { EXPECT_TRUE(true); }
 #if !defined(_WIN32) && !defined(__APPLE__)
 #include <unistd.h>
 #endif
+#include "bloch/cli/file_watcher.hpp"
+#include "bloch/cli/result_writer.hpp"
+#include "bloch/cli/server.hpp"
 #include "test_framework.hpp"
+#include "third_party/cpp-httplib/httplib.h"
 
 namespace {
     // Determine directory of the currently running test executable
@@ -213,6 +220,24 @@ TEST(IntegrationTest, HelpListsAllCliOptions) {
     EXPECT_NE(output.find("--shots"), std::string::npos);
     EXPECT_NE(output.find("--echo=auto|all|none"), std::string::npos);
     EXPECT_NE(output.find("--update"), std::string::npos);
+    EXPECT_NE(output.find("--opt-level=0|1|2"), std::string::npos);
+    EXPECT_NE(output.find("--emit-only"), std::string::npos);
+    EXPECT_NE(output.find("--estimate"), std::string::npos);
+    EXPECT_NE(output.find("--record-trace=FILE"), std::string::npos);
+    EXPECT_NE(output.find("--replay-trace=FILE"), std::string::npos);
+    EXPECT_NE(output.find("--ci-width=W"), std::string::npos);
+    EXPECT_NE(output.find("--seed=S"), std::string::npos);
+    EXPECT_NE(output.find("--shard=I/N"), std::string::npos);
+    EXPECT_NE(output.find("--watch"), std::string::npos);
+    EXPECT_NE(output.find("--output=table|json|csv|bin"), std::string::npos);
+    EXPECT_NE(output.find("--shot-log=FILE"), std::string::npos);
+    EXPECT_NE(output.find("--profile[=sample]"), std::string::npos);
+    EXPECT_NE(output.find("--metrics=FILE"), std::string::npos);
+    EXPECT_NE(output.find("--trace=FILE"), std::string::npos);
+    EXPECT_NE(output.find("bloch merge"), std::string::npos);
+    EXPECT_NE(output.find("bloch batch"), std::string::npos);
+    EXPECT_NE(output.find("bloch serve"), std::string::npos);
+    EXPECT_NE(output.find("bloch bench"), std::string::npos);
 }
 
 #endif  // BLOCH_SKIP_INTEGRATION_TESTS
@@ -374,3 +399,419 @@ function main() -> void {
     std::string output = runBloch(src, "generic_runtime.bloch");
     EXPECT_EQ("hi\n", output);
 }
+
+TEST(IntegrationTest, EmitOnlyWritesQasmBeyondStatevectorLimits) {
+    std::string src = R"(
+function main() -> void {
+    qubit[100] q;
+    h(q[0]);
+    for (int i = 0; i < 99; i++) { cx(q[i], q[i + 1]); }
+    measure q;
+}
+)";
+    std::string output = runBloch(src, "emit_only_ghz.bloch", "--emit-only --emit-qasm");
+    EXPECT_NE(output.find("qreg q[100];"), std::string::npos);
+    EXPECT_NE(output.find("cx q[98],q[99];"), std::string::npos);
+    EXPECT_NE(output.find("measure q[99] -> c[99];"), std::string::npos);
+}
+
+TEST(IntegrationTest, EmitOnlyRejectsMeasurementFeedback) {
+    std::string src = R"(
+function main() -> void {
+    qubit q;
+    qubit r;
+    h(q);
+    bit b = measure q;
+    if (b) { x(r); }
+    measure r;
+}
+)";
+    std::string output = runBloch(src, "emit_only_feedback.bloch", "--emit-only");
+    EXPECT_NE(output.find("branch condition depends on a measurement"), std::string::npos);
+    EXPECT_EQ(output.find("OPENQASM"), std::string::npos);
+}
+
+TEST(IntegrationTest, EstimatePrintsResourcesWithoutRunning) {
+    std::string src = R"(
+@shots(50)
+function main() -> void {
+    qubit[30] q;
+    h(q[0]);
+    for (int i = 0; i < 29; i++) { cx(q[i], q[i + 1]); }
+    echo("ran");
+    measure q;
+}
+)";
+    std::string output = runBloch(src, "estimate_ghz.bloch", "--estimate");
+    EXPECT_NE(output.find("Shots: 50"), std::string::npos);
+    EXPECT_NE(output.find("Qubits: 30"), std::string::npos);
+    EXPECT_NE(output.find("Depth: 31"), std::string::npos);
+    EXPECT_NE(output.find("Gates: 30"), std::string::npos);
+    EXPECT_NE(output.find("cx  29"), std::string::npos);
+    EXPECT_NE(output.find("2^34 B (16 GiB) statevector"), std::string::npos);
+    EXPECT_EQ(output.find("ran"), std::string::npos);
+    EXPECT_EQ(output.find("Approximations"), std::string::npos);
+}
+
+TEST(IntegrationTest, MergedShardsMatchUnshardedRun) {
+    namespace fs = std::filesystem;
+    std::string src = R"(
+@shots(300)
+function main() -> void {
+    @tracked qubit[2] q;
+    h(q[0]);
+    ry(q[1], 0.8f);
+    measure q;
+}
+)";
+    std::string whole = runBloch(src, "sharded.bloch", "--seed=7");
+    std::string first = runBloch(src, "sharded.bloch", "--seed=7 --shard=0/2");
+    std::string second = runBloch(src, "sharded.bloch", "--seed=7 --shard=1/2");
+    EXPECT_NE(first.find("Shard: 0 of 2 (150 of 300 shots)"), std::string::npos);
+    EXPECT_NE(second.find("Wrote"), std::string::npos);
+    fs::path cwd = fs::current_path();
+    fs::path part0 = cwd / "sharded.shard-0-of-2.partial";
+    fs::path part1 = cwd / "sharded.shard-1-of-2.partial";
+    std::string merged =
+        runBlochCommand("merge \"" + part1.string() + "\" \"" + part0.string() + "\"");
+    EXPECT_NE(merged.find("Shots: 300"), std::string::npos);
+    EXPECT_NE(merged.find("Shards: 2 of 2"), std::string::npos);
+    size_t table = whole.find("qubit[] q");
+    ASSERT_TRUE(table != std::string::npos);
+    EXPECT_NE(merged.find(whole.substr(table)), std::string::npos);
+    fs::remove(part0);
+    fs::remove(part1);
+
+    std::string unseeded = runBloch(src, "sharded.bloch", "--shard=0/2");
+    EXPECT_NE(unseeded.find("--shard needs --seed"), std::string::npos);
+}
+
+TEST(IntegrationTest, CiWidthStopsBeforeShotBudget) {
+    std::string src = R"(
+@shots(100000)
+function main() -> void {
+    @tracked qubit q;
+    x(q);
+    measure q;
+}
+)";
+    // A certain outcome meets a 0.05 target at the first check.
+    std::string output = runBloch(src, "ci_width.bloch", "--ci-width=0.05");
+    EXPECT_NE(output.find("Shots: 100 of 100000"), std::string::npos);
+    EXPECT_NE(output.find("Precision: widest 95% interval 0.0370 (target 0.0500)"),
+              std::string::npos);
+    EXPECT_NE(output.find("1       |   100 | 1.000"), std::string::npos);
+}
+
+TEST(IntegrationTest, OutputFlagPrintsMachineReadableCounts) {
+    std::string src = R"(
+@shots(40)
+function main() -> void {
+    @tracked qubit[2] q;
+    x(q[1]);
+    measure q;
+}
+)";
+    std::string json = runBloch(src, "output.bloch", "--seed=5 --output=json");
+    EXPECT_NE(json.find("{\"shots\":40,\"shotsRun\":40,\"seed\":5,\"elapsedMs\":"),
+              std::string::npos);
+    EXPECT_NE(json.find("\"tracked\":{\"qubit[] q\":{\"01\":40}}}"), std::string::npos);
+    EXPECT_EQ(json.find("Shots:"), std::string::npos);
+    std::string csv = runBloch(src, "output.bloch", "--output=csv");
+    EXPECT_NE(csv.find("variable,outcome,count,probability\nqubit[] q,01,40,1\n"),
+              std::string::npos);
+    std::string bad = runBloch(src, "output.bloch", "--output=bin --emit-qasm");
+    EXPECT_NE(bad.find("--emit-qasm needs --output=table or --output=json"), std::string::npos);
+}
+
+TEST(IntegrationTest, MetricsFlagWritesPhaseReport) {
+    std::string src = R"(
+@shots(50)
+function main() -> void {
+    @tracked qubit[2] q;
+    h(q[0]);
+    cx(q[0], q[1]);
+    measure q;
+}
+)";
+    auto path = std::filesystem::current_path() / "metrics_test.json";
+    runBloch(src, "metrics_test.bloch", "--metrics=\"" + path.string() + "\"");
+    std::ifstream in(path);
+    std::string json((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    std::filesystem::remove(path);
+    EXPECT_NE(json.find("\"shots\":50,\"shotsRun\":50,\"phases\":{\"load\":{\"wallMs\":"),
+              std::string::npos);
+    for (const char* phase : {"analyse", "optimise", "plan", "classTable", "execute", "qasm",
+                              "write"})
+        EXPECT_NE(json.find("\"" + std::string(phase) + "\":{\"wallMs\":"), std::string::npos);
+    EXPECT_NE(json.find("\"gates\":{\"h\":50,\"x\":0,\"y\":0,\"z\":0,\"rx\":0,\"ry\":0,\"rz\":0,"
+                        "\"cx\":50,\"total\":100}"),
+              std::string::npos);
+    EXPECT_NE(json.find("\"sourceBytes\":"), std::string::npos);
+    EXPECT_EQ(json.find("\"astNodes\":0,"), std::string::npos);
+    EXPECT_NE(json.find("\"peakStateBytes\":"), std::string::npos);
+    EXPECT_NE(json.find("\"shotsPerSecond\":"), std::string::npos);
+}
+
+TEST(IntegrationTest, BenchReportsPercentilesAndComparesWithBaseline) {
+    namespace fs = std::filesystem;
+    fs::path program = fs::current_path() / "bench_test.bloch";
+    fs::path report = fs::current_path() / "bench_test.json";
+    fs::path baseline = fs::current_path() / "bench_baseline.json";
+    {
+        std::ofstream out(program);
+        out << R"(
+@shots(40)
+function main() -> void {
+    @tracked qubit[2] q;
+    h(q[0]);
+    cx(q[0], q[1]);
+    measure q;
+}
+)";
+    }
+    std::string quoted = "\"" + program.string() + "\"";
+    std::string output = runBlochCommand("bench " + quoted + " --runs=4 --warmup=1 --json=\"" +
+                                         report.string() + "\"");
+    EXPECT_NE(output.find("Shots: 40 per run (seed 1)"), std::string::npos);
+    EXPECT_NE(output.find("Runs: 4 timed after 1 warm-up"), std::string::npos);
+    EXPECT_NE(output.find("Wall time: min "), std::string::npos);
+    EXPECT_NE(output.find(" ms, p99 "), std::string::npos);
+    EXPECT_NE(output.find(" shots/s at the median"), std::string::npos);
+    // Echo and the QASM file are suppressed.
+    EXPECT_FALSE(fs::exists(fs::current_path() / "bench_test.qasm"));
+    std::ifstream in(report);
+    std::string json((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    EXPECT_NE(json.find("\"shots\":40,\"shotsRun\":40,\"seed\":1,\"optLevel\":1,\"warmup\":1,"
+                        "\"runs\":4,\"minMs\":"),
+              std::string::npos);
+    EXPECT_NE(json.find("\"p90Ms\":"), std::string::npos);
+    EXPECT_NE(json.find("\"peakRssBytes\":"), std::string::npos);
+
+    // Well within a 1000% threshold of itself; far slower than an
+    // impossible baseline.
+    output = runBlochCommand("bench " + quoted + " --runs=2 --baseline=\"" + report.string() +
+                             "\" --threshold=1000");
+    EXPECT_NE(output.find("Baseline: median "), std::string::npos);
+    EXPECT_EQ(output.find("regression"), std::string::npos);
+    {
+        std::ofstream out(baseline);
+        out << "{\"shotsRun\":40,\"medianMs\":0.000001}\n";
+    }
+    output = runBlochCommand("bench " + quoted + " --runs=2 --baseline=\"" + baseline.string() +
+                             "\"");
+    EXPECT_NE(output.find("regression: the median is"), std::string::npos);
+    fs::remove(program);
+    fs::remove(report);
+    fs::remove(baseline);
+}
+
+TEST(IntegrationTest, ResultWriterSortsOutcomesOnce) {
+    // Wider than an int, which the table used to parse each comparison.
+    std::string wide(40, '1');
+    bloch::runtime::TrackedCounts counts;
+    counts["qubit[] b"] = {{"?", 1}, {"10", 2}, {"1", 3}, {"01", 4}, {wide, 5}, {"110", 6}};
+    counts["qubit a"] = {{"1", 7}};
+    auto tables = bloch::cli::sortTrackedCounts(counts);
+    ASSERT_EQ(tables.size(), 2u);
+    EXPECT_EQ(tables[0].name, "qubit a");
+    std::vector<std::string> order;
+    for (const auto& outcome : tables[1].outcomes) order.emplace_back(outcome.first);
+    std::vector<std::string> expected = {"1", "01", "10", "110", wide, "?"};
+    EXPECT_TRUE(order == expected);
+
+    bloch::cli::RunSummary summary;
+    summary.shots = 21;
+    summary.shotsRun = 21;
+    summary.seed = 9;
+    std::ostringstream bin;
+    bloch::cli::writeResult(bin, bloch::cli::OutputFormat::Binary, summary, counts);
+    std::string bytes = bin.str();
+    auto u64 = [&bytes](size_t at) {
+        std::uint64_t value = 0;
+        for (int i = 7; i >= 0; --i)
+            value = (value << 8) | static_cast<unsigned char>(bytes[at + i]);
+        return value;
+    };
+    ASSERT_TRUE(bytes.size() > 40);
+    EXPECT_EQ(bytes.substr(0, 8), "BLOCHRES");
+    EXPECT_EQ(u64(32), 9u);
+    // "qubit a": 7-byte name padded to 8, one 1-bit row.
+    EXPECT_EQ(u64(40), (std::uint64_t{1} << 32) | 7u);
+    EXPECT_EQ(u64(48), 1u);
+    EXPECT_EQ(u64(72), 7u);
+    EXPECT_EQ(u64(80), 1u);
+    // "qubit[] b": 40-bit rows, "?" only counted in the header.
+    EXPECT_EQ(u64(88), (std::uint64_t{40} << 32) | 9u);
+    EXPECT_EQ(u64(96), 5u);
+    EXPECT_EQ(u64(104), 1u);
+    EXPECT_EQ(u64(128), 3u);                   // "1"
+    EXPECT_EQ(u64(136), 1u);
+    EXPECT_EQ(u64(128 + 4 * 16 + 8), (std::uint64_t{1} << 40) - 1);  // wide
+    EXPECT_EQ(bytes.size(), 128u + 5 * 16);
+}
+
+TEST(IntegrationTest, BatchRunsManifestInOrder) {
+    namespace fs = std::filesystem;
+    fs::path cwd = fs::current_path();
+    {
+        std::ofstream good(cwd / "batch_good.bloch");
+        good << "@shots(40)\nfunction main() -> void {\n    @tracked qubit q;\n    x(q);\n"
+                "    measure q;\n}\n";
+        std::ofstream bad(cwd / "batch_bad.bloch");
+        bad << "function main() -> void {\n    int a = ;\n}\n";
+        std::ofstream manifest(cwd / "batch.manifest");
+        manifest << "# one line per program\n"
+                    "batch_good.bloch --seed=5\n"
+                    "\n"
+                    "batch_bad.bloch\n"
+                    "batch_good.bloch --shots=9 --bogus\n"
+                    "batch_good.bloch --emit-only\n";
+    }
+    std::string output =
+        runBlochCommand("batch \"" + (cwd / "batch.manifest").string() + "\" --jobs=3");
+    std::istringstream lines(output);
+    std::vector<std::string> records;
+    for (std::string line; std::getline(lines, line);) records.push_back(line);
+    ASSERT_TRUE(records.size() == 4);
+    EXPECT_NE(records[0].find("{\"index\":0,\"line\":2,\"file\":\"batch_good.bloch\","
+                              "\"status\":\"ok\",\"shots\":40,\"shotsRun\":40,\"seed\":5,"),
+              std::string::npos);
+    EXPECT_NE(records[0].find("\"tracked\":{\"qubit q\":{\"1\":40}}"), std::string::npos);
+    EXPECT_NE(records[1].find("\"status\":\"error\""), std::string::npos);
+    EXPECT_NE(records[1].find("\"line\":2,\"column\":13"), std::string::npos);
+    EXPECT_NE(records[2].find("unsupported option '--bogus'"), std::string::npos);
+    EXPECT_NE(records[3].find("\"status\":\"ok\",\"shots\":1,"), std::string::npos);
+    fs::remove(cwd / "batch_good.bloch");
+    fs::remove(cwd / "batch_good.qasm");
+    fs::remove(cwd / "batch_bad.bloch");
+    fs::remove(cwd / "batch.manifest");
+}
+
+TEST(IntegrationTest, ServerRunsProgramsAndTurnsAwayExcessJobs) {
+    bloch::cli::ServeOptions options;
+    options.port = 0;
+    options.workers = 1;
+    options.queue = 1;
+    bloch::cli::JobServer server(options);
+    int port = server.bind();
+    ASSERT_TRUE(port > 0);
+    std::thread serving([&] { server.serve(); });
+    httplib::Client client("127.0.0.1", port);
+
+    std::string program =
+        "@shots(20)\nfunction main() -> void {\n    @tracked qubit q;\n    x(q);\n"
+        "    measure q;\n}\n";
+    auto first = client.Post("/run?seed=4&shots=5", program, "text/plain");
+    ASSERT_TRUE(first && first->status == 200);
+    EXPECT_NE(first->body.find("\"shots\":20,\"shotsRun\":20,\"seed\":4,\"cached\":false"),
+              std::string::npos);
+    EXPECT_NE(first->body.find("\"tracked\":{\"qubit q\":{\"1\":20}}"), std::string::npos);
+    auto again = client.Post("/run?seed=4", program, "text/plain");
+    ASSERT_TRUE(again && again->status == 200);
+    EXPECT_NE(again->body.find("\"cached\":true"), std::string::npos);
+
+    auto broken = client.Post("/run?name=bad.bloch", "function main() -> void { int a = ; }",
+                              "text/plain");
+    ASSERT_TRUE(broken && broken->status == 422);
+    EXPECT_NE(broken->body.find("{\"file\":\"bad.bloch\",\"status\":\"error\""),
+              std::string::npos);
+    auto badOption = client.Post("/run?bogus", program, "text/plain");
+    ASSERT_TRUE(badOption && badOption->status == 400);
+
+    // One worker and one queue slot: of four slow jobs sent at once, some
+    // must be turned away.
+    std::string slow =
+        "function main() -> void {\n    int t = 0;\n"
+        "    for (int i = 0; i < 100000; i++) { t = t + i % 7; }\n}\n";
+    std::atomic<int> ran{0};
+    std::atomic<int> busy{0};
+    std::vector<std::thread> senders;
+    for (int i = 0; i < 4; ++i) {
+        senders.emplace_back([&] {
+            httplib::Client sender("127.0.0.1", port);
+            auto res = sender.Post("/run", slow, "text/plain");
+            if (res && res->status == 200)
+                ++ran;
+            else if (res && res->status == 503)
+                ++busy;
+        });
+    }
+    for (auto& sender : senders) sender.join();
+    EXPECT_TRUE(ran >= 1);
+    EXPECT_TRUE(busy >= 1);
+    EXPECT_EQ(ran + busy, 4);
+
+    auto health = client.Get("/health");
+    ASSERT_TRUE(health && health->status == 200);
+    EXPECT_NE(health->body.find("\"workers\":1,\"running\":0,\"queued\":0"),
+              std::string::npos);
+    server.stop();
+    serving.join();
+}
+
+TEST(IntegrationTest, ServerRecompilesWhenAnImportChanges) {
+    namespace fs = std::filesystem;
+    fs::path dir = fs::temp_directory_path() / "bloch_serve_import";
+    fs::create_directories(dir / "lib");
+    auto writeFlip = [&](const char* body) {
+        std::ofstream(dir / "lib" / "Flip.bloch")
+            << "package lib;\nclass Flip {\n    public constructor() -> Flip = default;\n"
+            << "    public function apply(qubit q) -> void { " << body << " }\n}\n";
+    };
+    writeFlip("x(q);");
+    bloch::cli::ServeOptions options;
+    options.port = 0;
+    options.workers = 1;
+    bloch::cli::JobServer server(options);
+    int port = server.bind();
+    ASSERT_TRUE(port > 0);
+    std::thread serving([&] { server.serve(); });
+    httplib::Client client("127.0.0.1", port);
+
+    std::string path = "/run?shots=10&name=" + (dir / "main.bloch").string();
+    std::string program =
+        "import lib.Flip;\nfunction main() -> void {\n    Flip f = new Flip();\n"
+        "    @tracked qubit q;\n    f.apply(q);\n    measure q;\n}\n";
+    auto first = client.Post(path, program, "text/plain");
+    ASSERT_TRUE(first && first->status == 200);
+    EXPECT_NE(first->body.find("\"cached\":false"), std::string::npos);
+    EXPECT_NE(first->body.find("{\"qubit q\":{\"1\":10}}"), std::string::npos);
+    auto again = client.Post(path, program, "text/plain");
+    ASSERT_TRUE(again && again->status == 200);
+    EXPECT_NE(again->body.find("\"cached\":true"), std::string::npos);
+
+    // The new body has another size, so the stamp differs even within the
+    // file system's timestamp resolution.
+    writeFlip("x(q); x(q);");
+    auto edited = client.Post(path, program, "text/plain");
+    ASSERT_TRUE(edited && edited->status == 200);
+    EXPECT_NE(edited->body.find("\"cached\":false"), std::string::npos);
+    EXPECT_NE(edited->body.find("{\"qubit q\":{\"0\":10}}"), std::string::npos);
+    server.stop();
+    serving.join();
+    fs::remove_all(dir);
+}
+
+TEST(IntegrationTest, FileWatcherReportsChangedFile) {
+    auto dir = std::filesystem::temp_directory_path() / "bloch_watch_test";
+    std::filesystem::create_directories(dir);
+    std::string path = (dir / "main.bloch").string();
+    std::ofstream(path) << "function main() -> void { }\n";
+    std::string canonical = std::filesystem::canonical(path).string();
+
+    bloch::cli::FileWatcher watcher({canonical});
+    EXPECT_FALSE(watcher.waitForChange(std::chrono::milliseconds(100)).has_value());
+
+    std::thread writer([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        std::ofstream(path) << "function main() -> void { echo(1); }\n";
+    });
+    auto changed = watcher.waitForChange(std::chrono::seconds(5));
+    writer.join();
+    ASSERT_TRUE(changed.has_value());
+    EXPECT_EQ(*changed, canonical);
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,333 @@
+// Copyright 2025-2026 Akshay Pal (https://bloch-labs.com)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sstream>
+
+#include "bloch/compiler/lexer/lexer.hpp"
+#include "bloch/compiler/optimiser/optimiser.hpp"
+#include "bloch/compiler/parser/parser.hpp"
+#include "bloch/compiler/semantics/semantic_analyser.hpp"
+#include "bloch/runtime/runtime_evaluator.hpp"
+#include "bloch/support/error/bloch_error.hpp"
+#include "test_framework.hpp"
+
+using namespace bloch::compiler;
+using namespace bloch::runtime;
+
+namespace {
+    std::unique_ptr<Program> parseProgram(const char* src) {
+        Lexer lexer(src);
+        auto tokens = lexer.tokenize();
+        Parser parser(std::move(tokens));
+        auto program = parser.parse();
+        SemanticAnalyser analyser;
+        analyser.analyse(*program);
+        return program;
+    }
+
+    struct RunResult {
+        std::string output;
+        std::string qasm;
+        std::string error;
+    };
+
+    RunResult run(Program& program) {
+        RuntimeEvaluator eval;
+        std::ostringstream output;
+        auto* oldBuf = std::cout.rdbuf(output.rdbuf());
+        std::string error;
+        try {
+            eval.execute(program);
+        } catch (const bloch::support::BlochError& e) {
+            error = e.what();
+        }
+        std::cout.rdbuf(oldBuf);
+        return {output.str(), eval.getQasm(), error};
+    }
+
+    // Runs `src` with and without the optimiser and checks they agree.
+    OptimiserStats expectSameBehaviour(const char* src) {
+        auto plain = parseProgram(src);
+        auto optimised = parseProgram(src);
+        OptimiserStats stats = Optimiser().optimise(*optimised);
+        RunResult expected = run(*plain);
+        RunResult actual = run(*optimised);
+        EXPECT_EQ(expected.output, actual.output);
+        EXPECT_EQ(expected.qasm, actual.qasm);
+        EXPECT_EQ(expected.error, actual.error);
+        return stats;
+    }
+
+    Statement* mainStatement(Program& program, size_t index) {
+        for (auto& fn : program.functions)
+            if (fn->name == "main")
+                return fn->body->statements.at(index).get();
+        return nullptr;
+    }
+}  // namespace
+
+TEST(OptimiserTest, UnrollsConstantBoundGateLoop) {
+    const char* src = R"(
+function main() -> void {
+    qubit[4] q;
+    for (int i = 0; i < 4; i++) {
+        h(q[i]);
+        x(q[3 - i]);
+    }
+})";
+    auto program = parseProgram(src);
+    OptimiserStats stats = Optimiser().optimise(*program);
+    EXPECT_EQ(stats.loopsUnrolled, 1);
+    // Eight straight-line gate calls replace the loop.
+    auto* first = dynamic_cast<ExpressionStatement*>(mainStatement(*program, 1));
+    ASSERT_TRUE(first != nullptr);
+    auto* call = dynamic_cast<CallExpression*>(first->expression.get());
+    ASSERT_TRUE(call != nullptr);
+    auto* idx = dynamic_cast<IndexExpression*>(call->arguments[0].get());
+    ASSERT_TRUE(idx != nullptr);
+    auto* lit = dynamic_cast<LiteralExpression*>(idx->index.get());
+    ASSERT_TRUE(lit != nullptr);
+    EXPECT_EQ(lit->value, "0");
+    auto* second = dynamic_cast<ExpressionStatement*>(mainStatement(*program, 2));
+    ASSERT_TRUE(second != nullptr);
+    auto* secondCall = dynamic_cast<CallExpression*>(second->expression.get());
+    auto* folded = dynamic_cast<IndexExpression*>(secondCall->arguments[0].get());
+    auto* foldedLit = dynamic_cast<LiteralExpression*>(folded->index.get());
+    ASSERT_TRUE(foldedLit != nullptr);
+    EXPECT_EQ(foldedLit->value, "3");
+
+    expectSameBehaviour(src);
+}
+
+TEST(OptimiserTest, UnrollsWithFinalBoundsAndSteps) {
+    OptimiserStats stats = expectSameBehaviour(R"(
+function main() -> void {
+    final int n = 7;
+    for (int i = n; i >= 0; i = i - 2) { echo(i); }
+    for (int j = 1; j <= n * 2; j = j + 3) { int sq = j * j; echo(sq); }
+    for (int k = 5; k != 0; k--) { echo(k % 3); }
+})");
+    EXPECT_EQ(stats.loopsUnrolled, 3);
+}
+
+TEST(OptimiserTest, UnrollsNestedLoopsAndKeepsScopes) {
+    OptimiserStats stats = expectSameBehaviour(R"(
+function main() -> void {
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < i; j++) {
+            qubit q;
+            x(q);
+            bit b = measure q;
+            echo(i + j);
+            echo(b);
+        }
+    }
+})");
+    EXPECT_EQ(stats.loopsUnrolled, 4);
+}
+
+TEST(OptimiserTest, LeavesLoopsItCannotBoundAlone) {
+    const char* src = R"(
+function count(int n) -> int {
+    int total = 0;
+    for (int i = 0; i < n; i++) { total = total + i; }
+    for (int j = 0; j < 3; j++) { j = j + 1; total = total + j; }
+    for (int k = 0; k < 1000; k++) { total = total + 1; }
+    return total;
+}
+function main() -> void { echo(count(5)); })";
+    OptimiserStats stats = expectSameBehaviour(src);
+    EXPECT_EQ(stats.loopsUnrolled, 0);
+}
+
+TEST(OptimiserTest, DoesNotFoldIntegerDivisionBounds) {
+    // i < 5 / 2 compares against 2.5 at runtime, so the loop runs three times.
+    OptimiserStats stats = expectSameBehaviour(R"(
+function main() -> void {
+    for (int i = 0; i < 5 / 2; i++) { echo(i); }
+})");
+    EXPECT_EQ(stats.loopsUnrolled, 0);
+}
+
+TEST(OptimiserTest, HoistsLoopInvariantArithmetic) {
+    const char* src = R"(
+function scale(int n, float theta) -> float {
+    int width = n + 1;
+    float acc = 0.0f;
+    int i = 0;
+    while (i < width * 2) {
+        acc = acc + theta * width;
+        i = i + (n - width + 2);
+    }
+    return acc;
+}
+function main() -> void { echo(scale(3, 0.5f)); })";
+    auto program = parseProgram(src);
+    OptimiserStats stats = Optimiser().optimise(*program);
+    // width * 2, theta * width and (n - width + 2); never anything reading i or acc.
+    EXPECT_EQ(stats.expressionsHoisted, 3);
+    expectSameBehaviour(src);
+}
+
+TEST(OptimiserTest, DoesNotHoistWrittenOrThrowingExpressions) {
+    OptimiserStats stats = expectSameBehaviour(R"(
+function main() -> void {
+    int a = 4;
+    int z = 0;
+    int i = 0;
+    while (i < 3) {
+        a = a + 1;
+        echo(a * 2);
+        if (i > 5) { echo(a % z); }
+        i++;
+    }
+})");
+    EXPECT_EQ(stats.expressionsHoisted, 0);
+}
+
+TEST(OptimiserTest, InlinesVoidQuantumHelper) {
+    const char* src = R"(
+@quantum
+function applyCZ(qubit a, qubit b) -> void {
+    h(b);
+    cx(a, b);
+    h(b);
+}
+function main() -> void {
+    qubit[2] q;
+    x(q[0]);
+    x(q[1]);
+    applyCZ(q[0], q[1]);
+    bit a = measure q[0];
+    bit b = measure q[1];
+    echo(a);
+    echo(b);
+})";
+    auto program = parseProgram(src);
+    OptimiserStats stats = Optimiser().optimise(*program);
+    EXPECT_EQ(stats.callsInlined, 1);
+    // The three gates are spliced in where the call was, after reading each
+    // qubit argument once to check its index.
+    auto* check = dynamic_cast<ExpressionStatement*>(mainStatement(*program, 3));
+    ASSERT_TRUE(check != nullptr);
+    EXPECT_TRUE(dynamic_cast<IndexExpression*>(check->expression.get()) != nullptr);
+    auto* first = dynamic_cast<ExpressionStatement*>(mainStatement(*program, 5));
+    ASSERT_TRUE(first != nullptr);
+    auto* call = dynamic_cast<CallExpression*>(first->expression.get());
+    ASSERT_TRUE(call != nullptr);
+    auto* callee = dynamic_cast<VariableExpression*>(call->callee.get());
+    ASSERT_TRUE(callee != nullptr);
+    EXPECT_EQ(callee->name, "h");
+    expectSameBehaviour(src);
+}
+
+TEST(OptimiserTest, InlinesResultIntoDeclarationsAndExpressions) {
+    OptimiserStats stats = expectSameBehaviour(R"(
+@quantum
+function flip(qubit q) -> bit {
+    x(q);
+    return measure q;
+}
+function square(int n) -> int { return n * n; }
+function halve(int n) -> float { return n / 2; }
+function main() -> void {
+    qubit q;
+    bit b = flip(q);
+    echo(b);
+    int k = 3;
+    echo(square(k) + square(k + 1));
+    echo(halve(square(5)));
+})");
+    // flip, square(k) and square(5); a call with a compound argument nested in
+    // a larger expression stays a call.
+    EXPECT_EQ(stats.callsInlined, 3);
+}
+
+TEST(OptimiserTest, RenamesCalleeLocalsThatWouldCaptureArguments) {
+    OptimiserStats stats = expectSameBehaviour(R"(
+function sumTo(int limit) -> int {
+    int total = 0;
+    for (int i = 0; i <= limit; i++) { total = total + i; }
+    return total;
+}
+function main() -> void {
+    int total = 4;
+    int i = 2;
+    total = sumTo(total + i);
+    echo(total);
+    int limit = sumTo(i);
+    echo(limit);
+})");
+    EXPECT_EQ(stats.callsInlined, 2);
+}
+
+TEST(OptimiserTest, DoesNotInlineRecursiveOrEarlyReturningFunctions) {
+    OptimiserStats stats = expectSameBehaviour(R"(
+function fact(int n) -> int {
+    if (n <= 1) { return 1; }
+    return n * fact(n - 1);
+}
+function clamp(int n) -> int {
+    if (n > 3) { return 3; }
+    return n;
+}
+function main() -> void {
+    echo(fact(5));
+    echo(clamp(7));
+})");
+    EXPECT_EQ(stats.callsInlined, 0);
+}
+
+TEST(OptimiserTest, InlinedCallsStillEvaluateFailingArguments) {
+    const char* unread = R"(
+function f(int x) -> int { return 0; }
+function main() -> void {
+    int[] a = {1, 2, 3};
+    echo(1);
+    int r = f(a[10]);
+    echo(r);
+})";
+    auto program = parseProgram(unread);
+    OptimiserStats stats = Optimiser().optimise(*program);
+    EXPECT_EQ(stats.callsInlined, 1);
+    RunResult result = run(*program);
+    EXPECT_NE(result.error.find("out of bounds"), std::string::npos);
+    expectSameBehaviour(unread);
+
+    // Arguments fail in order, before anything in the callee runs.
+    expectSameBehaviour(R"(
+function g(int x, int y) -> int {
+    echo(y);
+    return x;
+}
+function main() -> void {
+    int[] a = {1, 2, 3};
+    int i = 5;
+    int r = g(a[i], a[i - 4]);
+    echo(r);
+    echo(g(a[1], a[i]));
+})");
+
+    // A qubit element is checked at the call even when the helper ignores it.
+    expectSameBehaviour(R"(
+@quantum
+function touch(qubit a, qubit b) -> void {
+    x(a);
+}
+function main() -> void {
+    qubit[2] q;
+    touch(q[0], q[2]);
+    measure q;
+})");
+}
@@ -893,3 +893,32 @@ class Foo {
     EXPECT_TRUE(dtor->isDefault);
     EXPECT_EQ(dtor->body, nullptr);
 }
+
+TEST(ParserTest, RecordsControlFlowAndExpressionStatementPositions) {
+    const char* src = R"(if (1) { x(q); }
+while (1) { }
+  for (int i = 0; i < 1; i++) { }
+echo(1);
+1 ? x(q); : y(q);)";
+    Lexer lexer(src);
+    auto tokens = lexer.tokenize();
+    Parser parser(std::move(tokens));
+    auto program = parser.parse();
+
+    ASSERT_EQ(program->statements.size(), 5u);
+    auto* ifStmt = dynamic_cast<IfStatement*>(program->statements[0].get());
+    ASSERT_NE(ifStmt, nullptr);
+    EXPECT_EQ(ifStmt->line, 1);
+    EXPECT_EQ(ifStmt->column, 1);
+    auto* inner = dynamic_cast<BlockStatement*>(ifStmt->thenBranch.get());
+    ASSERT_NE(inner, nullptr);
+    EXPECT_EQ(inner->statements[0]->column, 10);
+    EXPECT_EQ(program->statements[1]->line, 2);
+    EXPECT_EQ(program->statements[2]->line, 3);
+    EXPECT_EQ(program->statements[2]->column, 3);
+    EXPECT_EQ(program->statements[3]->line, 4);
+    auto* ternary = dynamic_cast<TernaryStatement*>(program->statements[4].get());
+    ASSERT_NE(ternary, nullptr);
+    EXPECT_EQ(ternary->line, 5);
+    EXPECT_EQ(ternary->column, 1);
+}
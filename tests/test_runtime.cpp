@@ -12,17 +12,30 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
+#include <cmath>
 #include <chrono>
 #include <filesystem>
 #include <fstream>
 #include <sstream>
 
+#include "bloch/compiler/analysis/feedback_analysis.hpp"
 #include "bloch/compiler/import/module_loader.hpp"
 #include "bloch/compiler/lexer/lexer.hpp"
+#include "bloch/compiler/optimiser/optimiser.hpp"
 #include "bloch/compiler/parser/parser.hpp"
 #include "bloch/compiler/semantics/semantic_analyser.hpp"
+#include "bloch/runtime/batched_simulator.hpp"
+#include "bloch/runtime/circuit_optimiser.hpp"
+#include "bloch/runtime/measurement_trace.hpp"
+#include "bloch/runtime/partial_result.hpp"
+#include "bloch/runtime/profiler.hpp"
 #include "bloch/runtime/qasm_simulator.hpp"
 #include "bloch/runtime/runtime_evaluator.hpp"
+#include "bloch/runtime/shot_log.hpp"
+#include "bloch/runtime/shot_runner.hpp"
+#include "bloch/runtime/timeline.hpp"
+#include "bloch/runtime/varint.hpp"
 #include "bloch/support/error/bloch_error.hpp"
 #include "test_framework.hpp"
 
@@ -62,6 +75,24 @@ TEST(QasmSimulatorTest, AllocatesPowersOfTwoStateSize) {
     EXPECT_EQ(sim.stateSize(), 4u);
 }
 
+TEST(QasmSimulatorTest, BulkAllocationKeepsExistingAmplitudes) {
+    QasmSimulator sim;
+    sim.reserveQubits(6);
+    int q0 = sim.allocateQubit();
+    sim.x(q0);
+    int first = sim.allocateQubits(4);
+    EXPECT_EQ(first, 1);
+    EXPECT_EQ(sim.stateSize(), 32u);
+    sim.cx(q0, 4);
+    EXPECT_EQ(sim.measure(q0), 1);
+    EXPECT_EQ(sim.measure(4), 1);
+    for (int q = 1; q < 4; ++q) EXPECT_EQ(sim.measure(q), 0);
+    EXPECT_NE(sim.getQasm().find("qreg q[5];"), std::string::npos);
+
+    QasmSimulator tooLarge;
+    EXPECT_THROW(tooLarge.allocateQubits(70), BlochError);
+}
+
 TEST(QasmSimulatorTest, LoggingCanBeSuppressedPerInstance) {
     QasmSimulator sim(false);
     sim.allocateQubit();
@@ -106,6 +137,871 @@ TEST(QasmSimulatorTest, CxOnlyActsWhenControlIsOne) {
     }
 }
 
+TEST(QasmSimulatorTest, LogOnlyModeKeepsNoStatevector) {
+    QasmSimulator sim(true, false);
+    for (int i = 0; i < 80; ++i) sim.allocateQubit();
+    EXPECT_EQ(sim.stateSize(), 1u);
+    sim.h(79);
+    sim.cx(79, 0);
+    sim.reset(1);
+    EXPECT_EQ(sim.measure(79), 0);
+    EXPECT_THROW(sim.x(79), BlochError);
+    std::string qasm = sim.getQasm();
+    EXPECT_NE(qasm.find("qreg q[80];"), std::string::npos);
+    EXPECT_NE(qasm.find("h q[79];\ncx q[79],q[0];\nreset q[1];\nmeasure q[79] -> c[79];\n"),
+              std::string::npos);
+}
+
+TEST(CircuitOptimiserTest, CancelsInversePairsAndMergesRotations) {
+    QasmSimulator sim;
+    CircuitOptimiser circuit(sim);
+    circuit.setEnabled(true);
+    int q0 = sim.allocateQubit();
+    int q1 = sim.allocateQubit();
+    circuit.apply({GateKind::H, q0});
+    circuit.apply({GateKind::H, q0});
+    circuit.apply({GateKind::X, q1});
+    circuit.apply({GateKind::CX, q1, q0});
+    circuit.apply({GateKind::CX, q1, q0});
+    circuit.apply({GateKind::X, q1});
+    circuit.apply({GateKind::RZ, q0, -1, 0.25});
+    circuit.apply({GateKind::RZ, q0, -1, 0.5});
+    circuit.flush();
+    EXPECT_EQ(circuit.gatesSubmitted(), 8u);
+    EXPECT_EQ(circuit.gatesRemoved(), 7u);
+    std::string qasm = sim.getQasm();
+    EXPECT_EQ(qasm.find("h q"), std::string::npos);
+    EXPECT_EQ(qasm.find("cx q"), std::string::npos);
+    EXPECT_NE(qasm.find("rz(0.750000) q[0];"), std::string::npos);
+    EXPECT_EQ(circuit.measure(q1), 0);
+}
+
+TEST(CircuitOptimiserTest, CommutesGatesThroughCxWhereSafe) {
+    QasmSimulator sim;
+    CircuitOptimiser circuit(sim);
+    circuit.setEnabled(true);
+    int c = sim.allocateQubit();
+    int t = sim.allocateQubit();
+    // z on the control and x on the target commute with cx; h on the target does not.
+    circuit.apply({GateKind::Z, c});
+    circuit.apply({GateKind::X, t});
+    circuit.apply({GateKind::CX, t, c});
+    circuit.apply({GateKind::Z, c});
+    circuit.apply({GateKind::X, t});
+    circuit.apply({GateKind::H, t});
+    circuit.apply({GateKind::CX, t, c});
+    circuit.apply({GateKind::H, t});
+    circuit.flush();
+    EXPECT_EQ(circuit.gatesRemoved(), 4u);
+    std::string qasm = sim.getQasm();
+    EXPECT_EQ(qasm.find("\nz q"), std::string::npos);
+    EXPECT_EQ(qasm.find("\nx q"), std::string::npos);
+    EXPECT_NE(qasm.find("cx q[0],q[1];\nh q[1];\ncx q[0],q[1];\nh q[1];\n"), std::string::npos);
+}
+
+TEST(CircuitOptimiserTest, NeverCancelsAcrossMeasurementOrReset) {
+    QasmSimulator sim;
+    CircuitOptimiser circuit(sim);
+    circuit.setEnabled(true);
+    int q0 = sim.allocateQubit();
+    int q1 = sim.allocateQubit();
+    circuit.apply({GateKind::X, q0});
+    EXPECT_EQ(circuit.measure(q1), 0);
+    circuit.apply({GateKind::X, q0});
+    circuit.reset(q1);
+    circuit.apply({GateKind::X, q0});
+    EXPECT_EQ(circuit.measure(q0), 1);
+    EXPECT_EQ(circuit.gatesRemoved(), 0u);
+}
+
+TEST(RuntimeTest, CircuitOptimisationKeepsResultsAndShrinksQasm) {
+    const char* src = R"(
+function main() -> void {
+    qubit[2] q;
+    h(q[0]);
+    h(q[0]);
+    x(q[0]);
+    cx(q[0], q[1]);
+    rz(q[1], 0.5f);
+    rz(q[1], -0.5f);
+    bit a = measure q[0];
+    bit b = measure q[1];
+    echo(a);
+    echo(b);
+}
+)";
+    std::string outputs[2];
+    std::string qasm[2];
+    for (int opt = 0; opt < 2; ++opt) {
+        auto program = parseProgram(src);
+        RuntimeEvaluator eval;
+        eval.setCircuitOptimisation(opt == 1);
+        std::ostringstream output;
+        auto* oldBuf = std::cout.rdbuf(output.rdbuf());
+        eval.execute(*program);
+        std::cout.rdbuf(oldBuf);
+        outputs[opt] = output.str();
+        qasm[opt] = eval.getQasm();
+        if (opt == 1)
+            EXPECT_EQ(eval.gatesRemoved(), 4u);
+    }
+    EXPECT_EQ(outputs[0], "1\n1\n");
+    EXPECT_EQ(outputs[0], outputs[1]);
+    EXPECT_NE(qasm[0].find("h q[0]"), std::string::npos);
+    EXPECT_EQ(qasm[1].find("h q[0]"), std::string::npos);
+    EXPECT_EQ(qasm[1].find("rz("), std::string::npos);
+}
+
+TEST(RuntimeTest, ReplayedShotsMatchInterpretedDistribution) {
+    const char* src = R"(
+function main() -> void {
+    @tracked qubit[2] pair;
+    @tracked qubit one;
+    h(pair[0]);
+    cx(pair[0], pair[1]);
+    x(one);
+    measure pair;
+    measure one;
+}
+)";
+    auto program = parseProgram(src);
+    ShotOptions options;
+    options.shots = 200;
+    options.echo = false;
+    options.replay = true;
+    ShotResult replayed = runShots(*program, options);
+    EXPECT_EQ(replayed.replayedShots, 199);
+    EXPECT_NE(replayed.qasm.find("cx q[0],q[1];"), std::string::npos);
+    options.replay = false;
+    ShotResult interpreted = runShots(*program, options);
+    EXPECT_EQ(interpreted.replayedShots, 0);
+
+    for (const ShotResult* result : {&replayed, &interpreted}) {
+        const auto& pair = result->trackedCounts.at("qubit[] pair");
+        int total = 0;
+        for (const auto& kv : pair) {
+            EXPECT_TRUE(kv.first == "00" || kv.first == "11");
+            total += kv.second;
+        }
+        EXPECT_EQ(total, 200);
+        // Both outcomes are overwhelmingly likely to appear in 200 shots.
+        EXPECT_EQ(pair.size(), 2u);
+        EXPECT_EQ(result->trackedCounts.at("qubit one").at("1"), 200);
+    }
+}
+
+TEST(RuntimeTest, RecordedCircuitReusesReleasedQubits) {
+    const char* src = R"(
+@quantum
+function flip() -> bit {
+    @tracked qubit q;
+    x(q);
+    return measure q;
+}
+function main() -> void {
+    for (int i = 0; i < 3; i++) { flip(); }
+}
+)";
+    auto program = parseProgram(src);
+    Circuit circuit;
+    RuntimeEvaluator eval;
+    eval.setRecording(&circuit);
+    eval.execute(*program);
+    TrackedCounts counts;
+    replayCircuit(circuit, 1, counts);
+    EXPECT_EQ(counts, eval.trackedCounts());
+    EXPECT_EQ(counts.at("qubit q").at("1"), 3);
+}
+
+TEST(BatchedSimulatorTest, LanesSampleIndependentlyAndCollapse) {
+    BatchedSimulator sim(3, 64);
+    sim.apply({GateKind::H, 0});
+    sim.apply({GateKind::CX, 1, 0});
+    sim.apply({GateKind::X, 2});
+    std::vector<int> first;
+    std::vector<int> second;
+    std::vector<int> flipped;
+    sim.measure(0, first);
+    sim.measure(1, second);
+    sim.measure(2, flipped);
+    int ones = 0;
+    for (int s = 0; s < 64; ++s) {
+        EXPECT_EQ(first[s], second[s]);
+        EXPECT_EQ(flipped[s], 1);
+        ones += first[s];
+    }
+    // 64 fair coins all landing the same way would mean the lanes are not independent.
+    EXPECT_TRUE(ones > 0 && ones < 64);
+
+    // Reset moves a measured |1> back to |0> in every lane.
+    sim.reset(2);
+    sim.measure(2, flipped);
+    for (int s = 0; s < 64; ++s) EXPECT_EQ(flipped[s], 0);
+}
+
+TEST(BatchedSimulatorTest, ReplayMatchesCircuitSemantics) {
+    const char* src = R"(
+function main() -> void {
+    @tracked qubit[2] q;
+    @tracked qubit r;
+    x(q[0]);
+    rz(q[0], 0.4f);
+    cx(q[0], q[1]);
+    ry(r, 3.14159265f);
+    measure r;
+    reset r;
+    measure q;
+}
+)";
+    auto program = parseProgram(src);
+    Circuit circuit;
+    RuntimeEvaluator eval;
+    eval.setRecording(&circuit);
+    eval.execute(*program);
+    TrackedCounts counts;
+    replayCircuitBatched(circuit, ReplaySlice{150, 0, 150, 1}, counts);
+    EXPECT_EQ(counts.at("qubit[] q").at("11"), 150);
+    // r was reset after its measurement, so it is tracked as unmeasured.
+    EXPECT_EQ(counts.at("qubit r").at("?"), 150);
+}
+
+TEST(RuntimeTest, BranchingReplaySplitsShotsAtMeasurements) {
+    const char* src = R"(
+function main() -> void {
+    @tracked qubit[2] pair;
+    @tracked qubit coin;
+    h(pair[0]);
+    cx(pair[0], pair[1]);
+    h(coin);
+    measure coin;
+    reset coin;
+    ry(coin, 1.0f);
+    measure pair;
+    measure coin;
+}
+)";
+    auto program = parseProgram(src);
+    Circuit circuit;
+    RuntimeEvaluator eval;
+    eval.setRecording(&circuit);
+    eval.execute(*program);
+    EXPECT_TRUE(prefersBranching(circuit));
+
+    TrackedCounts counts;
+    replayCircuitBranching(circuit, ReplaySlice{100000, 0, 100000, 1}, counts);
+    const auto& pair = counts.at("qubit[] pair");
+    EXPECT_EQ(pair.size(), static_cast<size_t>(2));
+    EXPECT_EQ(pair.at("00") + pair.at("11"), 100000);
+    EXPECT_TRUE(pair.at("00") > 48000 && pair.at("00") < 52000);
+    // ry(1) leaves P(1) = sin^2(0.5), about 0.23.
+    const auto& coin = counts.at("qubit coin");
+    EXPECT_EQ(coin.at("0") + coin.at("1"), 100000);
+    EXPECT_TRUE(coin.at("1") > 21000 && coin.at("1") < 25000);
+
+    Circuit wide;
+    wide.qubits = 30;
+    EXPECT_FALSE(prefersBranching(wide));
+}
+
+TEST(RuntimeTest, ReplaysGatesControlledByMeasurements) {
+    // Teleports ry(1.2)|0> from a to b, and copies a coin into copy[1] and,
+    // through a rotation angle, into d.
+    const char* src = R"(
+function main() -> void {
+    @tracked qubit[2] copy;
+    @tracked qubit b;
+    @tracked qubit d;
+    qubit a;
+    qubit m;
+    ry(a, 1.2f);
+    h(m);
+    cx(m, b);
+    cx(a, m);
+    h(a);
+    bit m1 = measure a;
+    bit m2 = measure m;
+    if (m2) { x(b); }
+    if (m1 == 1) { z(b); }
+    h(copy[0]);
+    bit c = measure copy[0];
+    if (c) { x(copy[1]); }
+    ry(d, 3.14159265f * c);
+    measure copy[1];
+    measure b;
+    measure d;
+}
+)";
+    auto program = parseProgram(src);
+    FeedbackReport report = analyseFeedback(*program);
+    EXPECT_TRUE(report.replayable);
+    Circuit circuit;
+    RuntimeEvaluator eval;
+    eval.setRecording(&circuit);
+    eval.setControlled(&report.controlled);
+    eval.execute(*program);
+    EXPECT_TRUE(circuit.replayable);
+    EXPECT_EQ(circuit.conditions.size(), static_cast<size_t>(8));
+
+    const int shots = 20000;
+    TrackedCounts tree;
+    TrackedCounts batched;
+    TrackedCounts single;
+    replayCircuitBranching(circuit, ReplaySlice{shots, 0, shots, 1}, tree);
+    replayCircuitBatched(circuit, ReplaySlice{shots, 0, shots, 1}, batched);
+    for (int s = 0; s < shots; ++s) replayCircuit(circuit, streamSeed(1, s), single);
+    // P(1) = sin^2(0.6), about 0.319.
+    for (const TrackedCounts* counts : {&tree, &batched, &single}) {
+        const auto& copy = counts->at("qubit[] copy");
+        EXPECT_EQ(copy.size(), static_cast<size_t>(2));
+        EXPECT_EQ(copy.at("00") + copy.at("11"), shots);
+        EXPECT_EQ(counts->at("qubit d").at("1"), copy.at("11"));
+        int ones = counts->at("qubit b").at("1");
+        EXPECT_TRUE(ones > 6000 && ones < 6750);
+    }
+
+    ShotOptions options;
+    options.shots = 2000;
+    options.echo = false;
+    options.seed = 5;
+    planShots(*program, 1, options);
+    EXPECT_TRUE(options.replay);
+    ShotResult replayed = runShots(*program, options);
+    EXPECT_EQ(replayed.replayedShots, 1999);
+    EXPECT_EQ(replayed.trackedCounts.at("qubit[] copy").size(), static_cast<size_t>(2));
+    int ones = replayed.trackedCounts.at("qubit b").at("1");
+    EXPECT_TRUE(ones > 500 && ones < 780);
+
+    // A tainted condition variable that no longer holds a measured bit
+    // cannot be recorded: the run falls back to interpreting every shot.
+    auto computed = parseProgram(R"(
+function main() -> void {
+    @tracked qubit[2] q;
+    h(q[0]);
+    bit b = measure q[0];
+    b = ~b;
+    if (b) { x(q[1]); }
+    measure q[1];
+}
+)");
+    ShotOptions fallback;
+    fallback.shots = 200;
+    fallback.echo = false;
+    planShots(*computed, 1, fallback);
+    EXPECT_TRUE(fallback.replay);
+    ShotResult interpreted = runShots(*computed, fallback);
+    EXPECT_EQ(interpreted.replayedShots, 0);
+    EXPECT_EQ(interpreted.shotsRun, 200);
+    const auto& q = interpreted.trackedCounts.at("qubit[] q");
+    EXPECT_EQ(q.at("01") + q.at("10"), 200);
+}
+
+TEST(RuntimeTest, PostfixOfMeasuredValueIsNotReplayed) {
+    // j copies the measured bit before the increment, so the x lands on
+    // q[1] or q[2] depending on the shot.
+    auto program = parseProgram(R"(
+function main() -> void {
+    @tracked qubit[3] q;
+    h(q[0]);
+    bit b = measure q[0];
+    int idx = (int) b;
+    int j = idx++;
+    x(q[j + 1]);
+    measure q[1];
+    measure q[2];
+}
+)");
+    ShotOptions interpretedOptions;
+    interpretedOptions.shots = 400;
+    interpretedOptions.echo = false;
+    interpretedOptions.seed = 3;
+    ShotOptions plannedOptions = interpretedOptions;
+    planShots(*program, 1, plannedOptions);
+    ShotResult planned = runShots(*program, plannedOptions);
+    ShotResult interpreted = runShots(*program, interpretedOptions);
+    EXPECT_EQ(planned.replayedShots, 0);
+    EXPECT_EQ(planned.trackedCounts.at("qubit[] q"), interpreted.trackedCounts.at("qubit[] q"));
+    const auto& q = planned.trackedCounts.at("qubit[] q");
+    EXPECT_EQ(q.size(), static_cast<size_t>(2));
+    EXPECT_EQ(q.at("010") + q.at("101"), 400);
+}
+
+TEST(RuntimeTest, MeasurementTraceReplaysRunWithoutStatevector) {
+    const char* src = R"(
+function main() -> void {
+    @tracked qubit[2] q;
+    h(q[0]);
+    bit b = measure q[0];
+    if (b) { x(q[1]); }
+    measure q[1];
+}
+)";
+    auto program = parseProgram(src);
+    MeasurementTrace recorded;
+    ShotOptions options;
+    options.shots = 40;
+    options.echo = false;
+    options.recordTrace = &recorded;
+    ShotResult original = runShots(*program, options);
+    EXPECT_EQ(recorded.shots(), 40);
+    EXPECT_EQ(recorded.measurements(), static_cast<size_t>(80));
+
+    auto path = makeTempDir("trace") / "run.trace";
+    recorded.save(path.string());
+    MeasurementTrace loaded = MeasurementTrace::load(path.string());
+    options.recordTrace = nullptr;
+    options.replayTrace = &loaded;
+    ShotResult replayed = runShots(*program, options);
+    EXPECT_EQ(replayed.trackedCounts, original.trackedCounts);
+
+    // Measuring in a different order diverges from the trace.
+    auto swapped = parseProgram(R"(
+function main() -> void {
+    qubit[2] q;
+    measure q[1];
+    measure q[0];
+}
+)");
+    MeasurementTrace again = MeasurementTrace::load(path.string());
+    options.replayTrace = &again;
+    EXPECT_THROW(runShots(*swapped, options), BlochError);
+
+    writeFile(path, "not a trace");
+    EXPECT_THROW(MeasurementTrace::load(path.string()), BlochError);
+    std::filesystem::remove_all(path.parent_path());
+}
+
+TEST(RuntimeTest, AdaptiveShotsStopOnceIntervalsAreNarrow) {
+    EXPECT_TRUE(std::abs(wilsonIntervalWidth(50, 100) - 0.1923) < 1e-3);
+    EXPECT_TRUE(std::abs(wilsonIntervalWidth(100, 100) - 0.0370) < 1e-3);
+
+    auto program = parseProgram(R"(
+function main() -> void {
+    @tracked qubit coin;
+    @tracked qubit one;
+    h(coin);
+    x(one);
+    measure coin;
+    measure one;
+}
+)");
+    ShotOptions options;
+    options.shots = 100000;
+    options.echo = false;
+    options.ciWidth = 0.1;
+    for (bool replay : {true, false}) {
+        options.replay = replay;
+        ShotResult result = runShots(*program, options);
+        // A fair coin needs about 4 * 1.96^2 * 0.25 / 0.1^2 = 384 shots; fewer if
+        // the sample happens to lean one way.
+        EXPECT_TRUE(result.shotsRun >= 300);
+        EXPECT_TRUE(result.shotsRun < 1000);
+        EXPECT_TRUE(result.widestInterval <= 0.1);
+        EXPECT_EQ(result.trackedCounts.at("qubit one").at("1"), result.shotsRun);
+    }
+
+    // An unreachable target uses the whole budget.
+    options.shots = 300;
+    options.ciWidth = 0.001;
+    ShotResult capped = runShots(*program, options);
+    EXPECT_EQ(capped.shotsRun, 300);
+    EXPECT_TRUE(capped.widestInterval > 0.001);
+}
+
+TEST(RuntimeTest, ShardsAddUpToTheSeededRun) {
+    // Branching replay, then per-shot interpretation.
+    auto program = parseProgram(R"(
+function main() -> void {
+    @tracked qubit[2] q;
+    h(q[0]);
+    ry(q[1], 0.6f);
+    measure q;
+}
+)");
+    ShotOptions options;
+    options.shots = 400;
+    options.echo = false;
+    options.seed = 11;
+    for (bool replay : {true, false}) {
+        options.replay = replay;
+        options.shardCount = 1;
+        options.shard = 0;
+        ShotResult whole = runShots(*program, options);
+        EXPECT_EQ(runShots(*program, options).trackedCounts, whole.trackedCounts);
+
+        options.shardCount = 3;
+        std::vector<PartialResult> partials;
+        for (int shard = 0; shard < 3; ++shard) {
+            options.shard = shard;
+            ShotResult part = runShots(*program, options);
+            PartialResult partial;
+            partial.seed = part.seed;
+            partial.totalShots = options.shots;
+            partial.shardCount = 3;
+            partial.shard = shard;
+            partial.shotsRun = part.shotsRun;
+            partial.trackedCounts = part.trackedCounts;
+            partials.push_back(partial);
+        }
+        MergedResult merged = mergePartialResults(partials);
+        EXPECT_EQ(merged.shotsRun, 400);
+        EXPECT_TRUE(merged.missingShards.empty());
+        EXPECT_EQ(merged.trackedCounts, whole.trackedCounts);
+    }
+}
+
+TEST(RuntimeTest, StopFlagEndsRunAtShotBoundary) {
+    auto program = parseProgram(R"(
+function main() -> void {
+    @tracked qubit[2] q;
+    for (int i = 0; i < 2; i = i + 1) {
+        bit b = measure q[0];
+        reset q[0];
+        if (b == 1b) { x(q[1]); }
+    }
+    h(q[0]);
+    measure q;
+}
+)");
+    std::atomic<bool> stop{true};
+    ShotOptions options;
+    options.shots = 50;
+    options.echo = false;
+    options.seed = 5;
+    options.stop = &stop;
+    ShotResult result = runShots(*program, options);
+    EXPECT_TRUE(result.interrupted);
+    EXPECT_EQ(result.shotsRun, 1);
+    // The finished shot still leaves its QASM behind.
+    EXPECT_FALSE(result.qasm.empty());
+
+    stop = false;
+    result = runShots(*program, options);
+    EXPECT_FALSE(result.interrupted);
+    EXPECT_EQ(result.shotsRun, 50);
+}
+
+TEST(RuntimeTest, StoppableReplayDrawsWhatTheWholeRunDraws) {
+    // 18 measurements, so the replay is batched and split into chunks.
+    auto program = parseProgram(R"(
+function main() -> void {
+    @tracked qubit[3] q;
+    for (int i = 0; i < 6; i = i + 1) {
+        h(q[0]);
+        cx(q[0], q[1]);
+        ry(q[2], 0.4f);
+        measure q[0];
+        measure q[1];
+        measure q[2];
+        reset q[0];
+        reset q[1];
+        reset q[2];
+    }
+}
+)");
+    ShotOptions options;
+    options.shots = 70000;
+    options.echo = false;
+    options.replay = true;
+    options.seed = 3;
+    ShotResult whole = runShots(*program, options);
+    std::atomic<bool> stop{false};
+    options.stop = &stop;
+    ShotResult chunked = runShots(*program, options);
+    EXPECT_FALSE(chunked.interrupted);
+    EXPECT_EQ(chunked.shotsRun, 70000);
+    EXPECT_EQ(chunked.replayedShots, 69999);
+    EXPECT_EQ(chunked.trackedCounts, whole.trackedCounts);
+}
+
+TEST(RuntimeTest, PartialResultsRoundTripAndRejectMixedRuns) {
+    PartialResult partial;
+    partial.seed = 1ULL << 40;
+    partial.totalShots = 1000;
+    partial.shardCount = 4;
+    partial.shard = 2;
+    partial.shotsRun = 250;
+    partial.trackedCounts["qubit[] q"]["01"] = 200;
+    partial.trackedCounts["qubit[] q"]["?"] = 50;
+    auto dir = makeTempDir("partial");
+    auto path = (dir / "run.partial").string();
+    partial.save(path);
+    PartialResult loaded = PartialResult::load(path);
+    EXPECT_EQ(loaded.seed, partial.seed);
+    EXPECT_EQ(loaded.shard, 2);
+    EXPECT_EQ(loaded.shotsRun, 250);
+    EXPECT_EQ(loaded.trackedCounts, partial.trackedCounts);
+
+    MergedResult merged = mergePartialResults({loaded});
+    EXPECT_EQ(merged.missingShards, (std::vector<int>{0, 1, 3}));
+    EXPECT_THROW(mergePartialResults({loaded, loaded}), BlochError);
+    PartialResult other = loaded;
+    other.shard = 0;
+    other.seed = 5;
+    EXPECT_THROW(mergePartialResults({loaded, other}), BlochError);
+
+    writeFile(path, "BLPR");
+    EXPECT_THROW(PartialResult::load(path), BlochError);
+    std::filesystem::remove_all(dir);
+}
+
+TEST(RuntimeTest, VarintsRoundTripAndRejectTruncatedOrOverlongInput) {
+    std::string bytes;
+    const std::uint64_t values[] = {0, 127, 128, 1ULL << 40, ~0ULL};
+    for (std::uint64_t value : values) putVarint(bytes, value);
+    EXPECT_EQ(bytes.size(), static_cast<size_t>(1 + 1 + 2 + 6 + 10));
+    size_t pos = 0;
+    for (std::uint64_t expected : values) {
+        std::uint64_t value = 1;
+        ASSERT_TRUE(readVarint(bytes, pos, value));
+        EXPECT_EQ(value, expected);
+    }
+    EXPECT_EQ(pos, bytes.size());
+
+    std::uint64_t value = 0;
+    pos = 0;
+    EXPECT_FALSE(readVarint(std::string("\x80\x80"), pos, value));
+    std::string overlong(10, '\xff');
+    overlong.push_back('\x01');
+    pos = 0;
+    EXPECT_FALSE(readVarint(overlong, pos, value));
+    std::string tooBig(9, '\xff');
+    tooBig.push_back('\x02');
+    pos = 0;
+    EXPECT_FALSE(readVarint(tooBig, pos, value));
+}
+
+// Reads a ShotLog file back into outcome counts ("?" for shots without one).
+static TrackedCounts readShotLog(const std::string& path, std::uint64_t& shots,
+                                 std::uint64_t& firstShot) {
+    std::ifstream in(path, std::ios::binary);
+    std::string bytes{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    auto read = [&bytes](size_t& pos, int size) {
+        std::uint64_t value = 0;
+        for (int i = size - 1; i >= 0; --i)
+            value = (value << 8) | static_cast<unsigned char>(bytes[pos + i]);
+        pos += size;
+        return value;
+    };
+    TrackedCounts counts;
+    shots = 0;
+    if (bytes.compare(0, 8, "BLOCHSHT") != 0)
+        return counts;
+    size_t pos = 24;
+    firstShot = read(pos, 8);
+    while (pos < bytes.size()) {
+        std::uint64_t blockShots = read(pos, 8);
+        std::uint64_t columns = read(pos, 4);
+        pos += 4;
+        std::vector<std::pair<std::string, size_t>> schema;
+        for (std::uint64_t c = 0; c < columns; ++c) {
+            size_t length = read(pos, 4);
+            size_t width = read(pos, 4);
+            schema.emplace_back(bytes.substr(pos, length), width);
+            pos += (length + 7) / 8 * 8;
+        }
+        for (const auto& [name, width] : schema) {
+            auto bit = [&](std::uint64_t i) {
+                return (static_cast<unsigned char>(bytes[pos + i / 8]) >> (i % 8)) & 1;
+            };
+            for (std::uint64_t shot = 0; shot < blockShots; ++shot) {
+                std::uint64_t at = shot * (width + 1);
+                std::string outcome = bit(at) ? std::string(width, '0') : "?";
+                for (size_t k = 0; bit(at) && k < width; ++k)
+                    if (bit(at + 1 + k))
+                        outcome[width - 1 - k] = '1';
+                counts[name][outcome]++;
+            }
+            pos += (blockShots * (width + 1) + 63) / 64 * 8;
+        }
+        shots += blockShots;
+    }
+    return counts;
+}
+
+TEST(RuntimeTest, ShotLogRecordsEveryShotInOrder) {
+    // Branching replay, then per-shot interpretation, on a shard.
+    auto program = parseProgram(R"(
+function main() -> void {
+    @tracked qubit[3] q;
+    @tracked qubit r;
+    h(q[0]);
+    cx(q[0], q[2]);
+    ry(r, 0.9f);
+    measure q;
+    measure r;
+}
+)");
+    auto dir = makeTempDir("shot_log");
+    auto path = (dir / "run.shots").string();
+    ShotOptions options;
+    options.shots = 600;
+    options.echo = false;
+    options.seed = 3;
+    options.shard = 1;
+    options.shardCount = 2;
+    for (bool replay : {true, false}) {
+        options.replay = replay;
+        ShotLog log(path);
+        options.shotLog = &log;
+        ShotResult result = runShots(*program, options);
+        log.finish();
+        std::uint64_t shots = 0;
+        std::uint64_t first = 0;
+        EXPECT_EQ(readShotLog(path, shots, first), result.trackedCounts);
+        EXPECT_EQ(shots, 300u);
+        EXPECT_EQ(first, 300u);
+    }
+
+    // Blocks split at kBlockShots; wide and unmeasured outcomes round-trip.
+    {
+        ShotLog log(path);
+        log.start(0, 0);
+        std::string wide = "1" + std::string(68, '0') + "1";
+        log.record("qubit[] w", wide);
+        log.endShot(ShotLog::kBlockShots + 5);
+        log.record("qubit[] w", "?");
+        log.record("qubit n", "1");
+        log.endShot();
+        log.finish();
+        std::uint64_t shots = 0;
+        std::uint64_t first = 0;
+        TrackedCounts counts = readShotLog(path, shots, first);
+        EXPECT_EQ(shots, ShotLog::kBlockShots + 6);
+        EXPECT_EQ(counts["qubit[] w"][wide], static_cast<int>(ShotLog::kBlockShots + 5));
+        EXPECT_EQ(counts["qubit[] w"]["?"], 1);
+        EXPECT_EQ(counts["qubit n"]["1"], 1);
+    }
+    std::filesystem::remove_all(dir);
+}
+
+TEST(RuntimeTest, ProfilerAttributesWorkToFunctionsAndLines) {
+    auto program = parseProgram(R"(
+@quantum
+function prep(qubit q) -> void {
+    h(q);
+    x(q);
+}
+
+function main() -> void {
+    qubit[2] q;
+    prep(q[0]);
+    prep(q[1]);
+    measure q;
+}
+)");
+    // Each report row ends in its function or "function:line"; returns the
+    // figures in front of it.
+    auto row = [](const std::string& report, const std::string& name) {
+        std::istringstream lines(report);
+        std::string line;
+        std::vector<double> figures;
+        while (std::getline(lines, line)) {
+            if (line.size() < name.size() + 2 ||
+                line.compare(line.size() - name.size() - 2, std::string::npos, "  " + name) != 0)
+                continue;
+            std::istringstream fields(line);
+            double figure = 0.0;
+            while (fields >> figure) figures.push_back(figure);
+        }
+        return figures;
+    };
+    for (auto mode : {Profiler::Mode::Instrumented, Profiler::Mode::Sampled}) {
+        Profiler profiler(mode);
+        ShotOptions options;
+        options.shots = 3;
+        options.echo = false;
+        options.warnings = false;
+        options.profiler = &profiler;
+        runShots(*program, options);
+        std::ostringstream report;
+        profiler.report(report);
+        // self ms, total ms, calls, gates, passes
+        auto prep = row(report.str(), "prep");
+        ASSERT_EQ(prep.size(), 5u);
+        EXPECT_EQ(prep[2], 6.0);
+        EXPECT_EQ(prep[3], 12.0);
+        EXPECT_EQ(prep[4], 12.0);
+        auto main = row(report.str(), "main");
+        ASSERT_EQ(main.size(), 5u);
+        EXPECT_EQ(main[2], 3.0);
+        EXPECT_EQ(main[3], 0.0);
+        EXPECT_EQ(main[4], 6.0);
+        EXPECT_TRUE(main[1] >= main[0]);
+        // self ms, hits, gates, passes
+        auto h = row(report.str(), "prep:4");
+        ASSERT_EQ(h.size(), 4u);
+        EXPECT_EQ(h[1], 6.0);
+        EXPECT_EQ(h[2], 6.0);
+    }
+
+    Profiler profiler(Profiler::Mode::Instrumented);
+    ShotOptions options;
+    options.shots = 50;
+    options.echo = false;
+    options.warnings = false;
+    options.profiler = &profiler;
+    runShots(*program, options);
+    std::ostringstream folded;
+    profiler.writeCollapsed(folded);
+    std::istringstream stacks(folded.str());
+    std::string line;
+    bool nested = false;
+    while (std::getline(stacks, line)) {
+        auto space = line.rfind(' ');
+        ASSERT_TRUE(space != std::string::npos);
+        EXPECT_TRUE(std::stoll(line.substr(space + 1)) > 0);
+        nested = nested || line.substr(0, space) == "main;prep";
+    }
+    EXPECT_TRUE(nested);
+}
+
+TEST(RuntimeTest, TimelineRecordsShotsCallsAndGates) {
+    auto program = parseProgram(R"(
+function flip(qubit q) -> void {
+    x(q);
+}
+
+function main() -> void {
+    qubit[2] q;
+    flip(q[0]);
+    cx(q[0], q[1]);
+    measure q;
+}
+)");
+    auto dir = makeTempDir("timeline");
+    auto path = (dir / "run.json").string();
+    {
+        Timeline timeline(path);
+        ShotOptions options;
+        options.shots = 3;
+        options.echo = false;
+        options.warnings = false;
+        options.timeline = &timeline;
+        runShots(*program, options);
+        timeline.finish();
+        EXPECT_EQ(timeline.events(), 21u);
+    }
+    std::ifstream in(path);
+    std::string json((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    auto count = [&json](const std::string& needle) {
+        size_t n = 0;
+        for (size_t at = json.find(needle); at != std::string::npos;
+             at = json.find(needle, at + 1))
+            ++n;
+        return n;
+    };
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+    EXPECT_EQ(json.substr(json.size() - 4), "\n]}\n");
+    EXPECT_EQ(count("\"name\":\"shot\",\"cat\":\"shot\""), 3u);
+    EXPECT_EQ(count("\"name\":\"main\",\"cat\":\"call\""), 3u);
+    EXPECT_EQ(count("\"name\":\"flip\",\"cat\":\"call\""), 3u);
+    EXPECT_EQ(count("\"name\":\"x\",\"cat\":\"gate\""), 3u);
+    EXPECT_EQ(count("\"args\":{\"control\":0,\"target\":1,\"amplitudes\":4}"), 3u);
+    EXPECT_EQ(count("\"name\":\"measure\",\"cat\":\"measure\""), 6u);
+    EXPECT_EQ(count("{\"qubit\":1,\"outcome\":1,\"amplitudes\":4}"), 3u);
+    std::filesystem::remove_all(dir);
+}
+
 TEST(RuntimeTest, ParenthesisedExpressionsEvaluate) {
     const char* src =
         "function main() -> void { for (int i = 0; i < 6; i = i + 1) { echo((i + 1) % 6); } }";
@@ -1004,6 +1900,86 @@ TEST(RuntimeTest, ImportsPublicClassAcrossModules) {
     EXPECT_EQ("hello\n", output.str());
 }
 
+TEST(RuntimeTest, ModuleCacheSharesTokensUntilFileChanges) {
+    auto dir = makeTempDir("cache");
+    writeFile(dir / "Greeter.bloch",
+              "class Greeter { public constructor() -> Greeter = default; public function "
+              "hello() -> string { return \"hello\"; } }\n");
+    writeFile(dir / "main.bloch",
+              "import Greeter; function main() -> void { Greeter g = new Greeter(); "
+              "echo(g.hello()); }\n");
+    auto cache = std::make_shared<ModuleCache>();
+    std::string greeter = std::filesystem::canonical(dir / "Greeter.bloch").string();
+    ModuleLoader loader({dir.string()}, cache);
+    loader.load((dir / "main.bloch").string());
+    auto modules = loader.modules();
+    ASSERT_EQ(modules.size(), 2u);
+    EXPECT_EQ(modules[0], greeter);
+    auto first = cache->tokens(greeter);
+    ModuleLoader({dir.string()}, cache).load((dir / "main.bloch").string());
+    EXPECT_TRUE(first == cache->tokens(greeter));
+
+    writeFile(dir / "Greeter.bloch",
+              "class Greeter { public constructor() -> Greeter = default; public function "
+              "hello() -> string { return \"hello again\"; } }\n");
+    EXPECT_TRUE(first != cache->tokens(greeter));
+    std::filesystem::remove_all(dir);
+}
+
+TEST(RuntimeTest, ModuleCacheReusesParsedModulesUntilFileChanges) {
+    auto dir = makeTempDir("parse_cache");
+    writeFile(dir / "Box.bloch",
+              "class Box<T> { public T v; public constructor(T v) -> Box<T> { this.v = v; "
+              "return this; } public function get() -> T { return this.v; } }\n");
+    writeFile(dir / "main.bloch", R"(import Box;
+@quantum
+function flip(qubit q) -> void { x(q); }
+function main() -> void {
+    Box<string> b = new Box<string>("hi");
+    qubit q;
+    for (int i = 0; i < 3; i++) { flip(q); }
+    bit r = measure q;
+    echo(b.get());
+    echo(r);
+}
+)");
+    auto cache = std::make_shared<ModuleCache>();
+    // Loading, analysis and optimisation all rewrite the tree; none of that
+    // may reach the cached copy.
+    auto run = [&]() {
+        ModuleLoader loader({dir.string()}, cache);
+        auto program = loader.load((dir / "main.bloch").string());
+        SemanticAnalyser analyser;
+        analyser.analyse(*program);
+        Optimiser().optimise(*program);
+        RuntimeEvaluator eval;
+        std::ostringstream output;
+        auto* oldBuf = std::cout.rdbuf(output.rdbuf());
+        eval.execute(*program);
+        std::cout.rdbuf(oldBuf);
+        return output.str();
+    };
+    EXPECT_EQ(run(), "hi\n1\n");
+    EXPECT_EQ(run(), "hi\n1\n");
+
+    std::string main = std::filesystem::canonical(dir / "main.bloch").string();
+    auto copy = cache->parse(main);
+    ASSERT_EQ(copy->imports.size(), 1u);
+    EXPECT_EQ(copy->functions.size(), 2u);
+    copy->functions.clear();
+    EXPECT_EQ(cache->parse(main)->functions.size(), 2u);
+
+    writeFile(dir / "Box.bloch",
+              "class Box<T> { public T v; public constructor(T v) -> Box<T> { this.v = v; "
+              "return this; } public function get() -> T { echo(\"get\"); return this.v; } }\n");
+    std::string box = std::filesystem::canonical(dir / "Box.bloch").string();
+    EXPECT_FALSE(cache->changed(main));
+    EXPECT_TRUE(cache->changed(box));
+    EXPECT_EQ(run(), "get\nhi\n1\n");
+    EXPECT_FALSE(cache->changed(box));
+    std::filesystem::remove_all(dir);
+}
+
 TEST(RuntimeTest, DottedImportResolvesNestedPath) {
     auto dir = makeTempDir("nested");
     std::filesystem::create_directories(dir / "pkg");
@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "bloch/compiler/analysis/feedback_analysis.hpp"
+#include "bloch/compiler/analysis/resource_estimator.hpp"
 #include "bloch/compiler/lexer/lexer.hpp"
 #include "bloch/compiler/parser/parser.hpp"
 #include "bloch/compiler/semantics/semantic_analyser.hpp"
@@ -1105,3 +1107,195 @@ TEST(SemanticTest, GenericDiamondWithoutTargetTypeFails) {
     SemanticAnalyser analyser;
     EXPECT_THROW(analyser.analyse(*program), BlochError);
 }
+
+TEST(FeedbackAnalysisTest, MeasurementsOnlyObservedAreFeedbackFree) {
+    auto program = parseProgram(R"(
+@quantum
+function flip(qubit q) -> bit {
+    h(q);
+    return measure q;
+}
+function main() -> void {
+    @tracked qubit[2] q;
+    bit a = flip(q[0]);
+    bit copy = a;
+    echo(copy);
+    for (int i = 0; i < 3; i++) { rz(q[1], 0.5f * i); }
+    measure q[1];
+})");
+    FeedbackReport report = analyseFeedback(*program);
+    EXPECT_TRUE(report.feedbackFree);
+}
+
+TEST(FeedbackAnalysisTest, DetectsMeasurementsReachingControlOrGates) {
+    const char* branch = R"(
+function main() -> void {
+    qubit q;
+    qubit r;
+    h(q);
+    bit b = measure q;
+    if (b) { x(r); }
+    measure r;
+})";
+    const char* viaCall = R"(
+function kick(qubit r, int times) -> void {
+    for (int i = 0; i < times; i++) { x(r); }
+}
+@quantum
+function coin() -> int {
+    qubit q;
+    h(q);
+    bit b = measure q;
+    int n = b;
+    return n;
+}
+function main() -> void {
+    qubit r;
+    kick(r, coin());
+    measure r;
+})";
+    const char* index = R"(
+function main() -> void {
+    qubit[2] q;
+    qubit c;
+    h(c);
+    int i = measure c;
+    x(q[i]);
+    measure q;
+})";
+    FeedbackReport report = analyseFeedback(*parseProgram(branch));
+    EXPECT_FALSE(report.feedbackFree);
+    EXPECT_EQ(report.line, 7);
+    EXPECT_FALSE(analyseFeedback(*parseProgram(viaCall)).feedbackFree);
+    EXPECT_FALSE(analyseFeedback(*parseProgram(viaCall)).replayable);
+    EXPECT_FALSE(analyseFeedback(*parseProgram(index)).feedbackFree);
+    EXPECT_FALSE(analyseFeedback(*parseProgram(index)).replayable);
+}
+
+TEST(FeedbackAnalysisTest, FollowsMeasurementsThroughPostfixOperators) {
+    auto program = parseProgram(R"(
+function main() -> void {
+    qubit[3] q;
+    h(q[0]);
+    bit b = measure q[0];
+    int idx = (int) b;
+    int j = idx++;
+    x(q[j + 1]);
+    measure q[1];
+})");
+    FeedbackReport report = analyseFeedback(*program);
+    EXPECT_FALSE(report.feedbackFree);
+    EXPECT_FALSE(report.replayable);
+    EXPECT_EQ(report.line, 8);
+}
+
+TEST(FeedbackAnalysisTest, BranchesThatOnlyApplyGatesAreControlled) {
+    auto program = parseProgram(R"(
+function main() -> void {
+    qubit a;
+    qubit m;
+    qubit b;
+    h(a);
+    cx(a, m);
+    bit m1 = measure a;
+    bit m2 = measure m;
+    bit both = m1;
+    if (m2 == 1) { x(b); }
+    if (both && !m2) {
+        z(b);
+    } else {
+        if (m2) { h(b); }
+    }
+    rz(b, 0.5f * m1);
+    measure b;
+})");
+    FeedbackReport report = analyseFeedback(*program);
+    EXPECT_FALSE(report.feedbackFree);
+    EXPECT_TRUE(report.replayable);
+    EXPECT_EQ(report.controlled.size(), static_cast<size_t>(4));
+    EXPECT_EQ(report.line, 11);
+    auto names = report.controlled.at(program->functions[0]->body->statements[9].get());
+    EXPECT_EQ(names.size(), static_cast<size_t>(2));
+
+    const char* loop = R"(
+function main() -> void {
+    qubit q;
+    bit b = measure q;
+    while (b) { reset q; b = measure q; }
+})";
+    const char* sideEffect = R"(
+function main() -> void {
+    qubit q;
+    qubit r;
+    bit b = measure q;
+    if (b) { x(r); echo("flipped"); }
+})";
+    const char* arithmetic = R"(
+function main() -> void {
+    qubit q;
+    qubit r;
+    bit b = measure q;
+    if (b + 1 > 1) { x(r); }
+})";
+    for (const char* source : {loop, sideEffect, arithmetic}) {
+        FeedbackReport rejected = analyseFeedback(*parseProgram(source));
+        EXPECT_FALSE(rejected.replayable);
+        EXPECT_TRUE(rejected.controlled.empty());
+    }
+}
+
+TEST(ResourceEstimatorTest, FollowsConstantLoopsCallsAndRegisters) {
+    auto program = parseProgram(R"(
+function ladder(qubit[] q, int n) -> void {
+    for (int i = 0; i < n - 1; i++) { cx(q[i], q[i + 1]); }
+}
+function main() -> void {
+    final int n = 4;
+    qubit[n] q;
+    h(q[0]);
+    ladder(q, n);
+    int k = 0;
+    while (k < 3) {
+        qubit a;
+        rz(a, 0.5f);
+        reset a;
+        k++;
+    }
+    measure q;
+})");
+    ResourceEstimate estimate = estimateResources(*program);
+    EXPECT_TRUE(estimate.exact);
+    // Each loop iteration declares a fresh qubit.
+    EXPECT_EQ(estimate.qubits, 7);
+    EXPECT_EQ(estimate.gates["h"], 1);
+    EXPECT_EQ(estimate.gates["cx"], 3);
+    EXPECT_EQ(estimate.gates["rz"], 3);
+    EXPECT_EQ(estimate.totalGates(), 7);
+    EXPECT_EQ(estimate.measurements, 4);
+    EXPECT_EQ(estimate.resets, 3);
+    // h, three chained cx, then the measurement on q[3].
+    EXPECT_EQ(estimate.depth, 5);
+}
+
+TEST(ResourceEstimatorTest, BoundsMeasurementDependentControlFlow) {
+    auto program = parseProgram(R"(
+function main() -> void {
+    qubit[3] q;
+    h(q[0]);
+    bit b = measure q[0];
+    if (b) { x(q[1]); } else { h(q[2]); y(q[2]); }
+    int n = b;
+    for (int i = 0; i < n; i++) { z(q[i]); }
+})");
+    ResourceEstimate estimate = estimateResources(*program);
+    EXPECT_FALSE(estimate.exact);
+    // One note for the branch and one for the loop.
+    EXPECT_EQ(estimate.notes.size(), static_cast<size_t>(2));
+    EXPECT_EQ(estimate.qubits, 3);
+    EXPECT_EQ(estimate.gates["x"], 1);
+    EXPECT_EQ(estimate.gates["h"], 2);
+    EXPECT_EQ(estimate.gates["y"], 1);
+    // The loop counts at most once, with i still 0.
+    EXPECT_EQ(estimate.gates["z"], 1);
+    EXPECT_EQ(estimate.depth, 3);
+}